@@ -0,0 +1,1326 @@
+#include "BVH.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <EASTL/algorithm.h>
+#include <EASTL/heap.h>
+#include <EASTL/utility.h>
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace violet {
+
+namespace {
+
+// Granularity of the per-element stages; large enough to amortize task dispatch
+constexpr uint32_t MIN_CHUNK_SIZE = 1024;
+
+// Radix sort works on 8-bit digits with a fixed block decomposition so every block
+// can scatter into its own precomputed slice of the output without synchronization
+constexpr uint32_t RADIX_BITS    = 8;
+constexpr uint32_t RADIX_BUCKETS = 1u << RADIX_BITS;
+constexpr uint32_t SORT_BLOCK    = 4096;
+
+template<typename Func>
+void dispatch(ThreadPool* pool, uint32_t count, uint32_t minChunkSize, Func&& func) {
+    if (pool) {
+        pool->parallelFor(count, minChunkSize, func);
+    } else if (count > 0) {
+        func(0u, count);
+    }
+}
+
+// Stable LSD radix sort of (code, index) pairs. Digits whose value is identical for
+// every key (common for the high bits of clustered scenes) are skipped.
+void radixSort(eastl::vector<uint64_t>& codes, eastl::vector<uint32_t>& indices, uint32_t keyBits, ThreadPool* pool) {
+    const uint32_t count      = static_cast<uint32_t>(codes.size());
+    const uint32_t blockCount = (count + SORT_BLOCK - 1) / SORT_BLOCK;
+
+    eastl::vector<uint64_t> tmpCodes(count);
+    eastl::vector<uint32_t> tmpIndices(count);
+    eastl::vector<uint32_t> histograms(static_cast<size_t>(blockCount) * RADIX_BUCKETS);
+
+    for (uint32_t shift = 0; shift < keyBits; shift += RADIX_BITS) {
+        eastl::fill(histograms.begin(), histograms.end(), 0u);
+
+        dispatch(pool, blockCount, 1, [&](uint32_t blockBegin, uint32_t blockEnd) {
+            for (uint32_t block = blockBegin; block < blockEnd; ++block) {
+                uint32_t* hist  = &histograms[static_cast<size_t>(block) * RADIX_BUCKETS];
+                uint32_t  begin = block * SORT_BLOCK;
+                uint32_t  end   = eastl::min(begin + SORT_BLOCK, count);
+                for (uint32_t i = begin; i < end; ++i) {
+                    ++hist[(codes[i] >> shift) & (RADIX_BUCKETS - 1)];
+                }
+            }
+        });
+
+        // Exclusive scan in digit-major, block-minor order keeps the sort stable
+        uint32_t offset = 0;
+        bool     trivial = false;
+        for (uint32_t digit = 0; digit < RADIX_BUCKETS && !trivial; ++digit) {
+            uint32_t digitTotal = 0;
+            for (uint32_t block = 0; block < blockCount; ++block) {
+                digitTotal += histograms[static_cast<size_t>(block) * RADIX_BUCKETS + digit];
+            }
+            trivial = digitTotal == count;
+        }
+        if (trivial) {
+            continue;
+        }
+
+        for (uint32_t digit = 0; digit < RADIX_BUCKETS; ++digit) {
+            for (uint32_t block = 0; block < blockCount; ++block) {
+                uint32_t& slot = histograms[static_cast<size_t>(block) * RADIX_BUCKETS + digit];
+                uint32_t  n    = slot;
+                slot           = offset;
+                offset += n;
+            }
+        }
+
+        dispatch(pool, blockCount, 1, [&](uint32_t blockBegin, uint32_t blockEnd) {
+            for (uint32_t block = blockBegin; block < blockEnd; ++block) {
+                uint32_t* hist  = &histograms[static_cast<size_t>(block) * RADIX_BUCKETS];
+                uint32_t  begin = block * SORT_BLOCK;
+                uint32_t  end   = eastl::min(begin + SORT_BLOCK, count);
+                for (uint32_t i = begin; i < end; ++i) {
+                    uint32_t dst    = hist[(codes[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                    tmpCodes[dst]   = codes[i];
+                    tmpIndices[dst] = indices[i];
+                }
+            }
+        });
+
+        codes.swap(tmpCodes);
+        indices.swap(tmpIndices);
+    }
+}
+
+// Cache blob layout: CacheHeader, nodeCount x CacheNode, primitiveCount x uint32_t leaf indices.
+// Native endianness; the files are a local cache, not an interchange format.
+constexpr uint32_t CACHE_MAGIC = 0x48564256;  // "VBVH"
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t method;
+    uint32_t primitiveCount;
+    uint32_t nodeCount;
+    uint32_t reserved;
+};
+static_assert(sizeof(CacheHeader) == 32);
+
+struct CacheNode {
+    uint32_t firstChild;
+    uint32_t count;
+    uint32_t rightChild;
+};
+static_assert(sizeof(CacheNode) == 12);
+
+// Lanes whose box overlaps box; touching counts, as in AABB::overlaps
+uint32_t overlapLanes(const AABB4& lanes, const AABB& box) {
+#if defined(VIOLET_SIMD_SSE)
+    __m128 overlap = _mm_and_ps(_mm_cmple_ps(_mm_load_ps(lanes.minX), _mm_set1_ps(box.max.x)),
+                                _mm_cmpge_ps(_mm_load_ps(lanes.maxX), _mm_set1_ps(box.min.x)));
+    overlap = _mm_and_ps(overlap, _mm_and_ps(_mm_cmple_ps(_mm_load_ps(lanes.minY), _mm_set1_ps(box.max.y)),
+                                             _mm_cmpge_ps(_mm_load_ps(lanes.maxY), _mm_set1_ps(box.min.y))));
+    overlap = _mm_and_ps(overlap, _mm_and_ps(_mm_cmple_ps(_mm_load_ps(lanes.minZ), _mm_set1_ps(box.max.z)),
+                                             _mm_cmpge_ps(_mm_load_ps(lanes.maxZ), _mm_set1_ps(box.min.z))));
+    return static_cast<uint32_t>(_mm_movemask_ps(overlap));
+#else
+    uint32_t mask = 0;
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        mask |= lanes.getLane(lane).overlaps(box) ? 1u << lane : 0u;
+    }
+    return mask;
+#endif
+}
+
+// Squared point/box distance per lane, evaluated in the same order as AABB::distanceSquared so
+// a node is never farther than a primitive it contains
+void laneDistancesSquared(const AABB4& lanes, const glm::vec3& point, float distances[4]) {
+#if defined(VIOLET_SIMD_SSE)
+    auto axis = [](const float* mins, const float* maxs, float coordinate) {
+        const __m128 c = _mm_set1_ps(coordinate);
+        __m128 d = _mm_max_ps(_mm_sub_ps(_mm_load_ps(mins), c), _mm_sub_ps(c, _mm_load_ps(maxs)));
+        d        = _mm_max_ps(d, _mm_setzero_ps());
+        return _mm_mul_ps(d, d);
+    };
+    __m128 sum = _mm_add_ps(axis(lanes.minX, lanes.maxX, point.x), axis(lanes.minY, lanes.maxY, point.y));
+    _mm_storeu_ps(distances, _mm_add_ps(sum, axis(lanes.minZ, lanes.maxZ, point.z)));
+#else
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        distances[lane] = lanes.getLane(lane).distanceSquared(point);
+    }
+#endif
+}
+
+// Outcome of a frustum test per lane for coherent culling, with how far each plane's distance
+// may change before the outcome can. Decisions use Frustum::testAABB4Masked's arithmetic.
+struct CoherenceLanes {
+    uint32_t passed = 0;        // Not outside any tested plane
+    uint32_t straddle[4] = {};  // Planes each lane crosses
+    float    outsideMargin[4];  // Outside lanes: farthest distance outside a rejecting plane
+    float    visibleMargin[4];  // Nearest positive vertex distance (how long the lane stays visible)
+    float    insideMargin[4];   // Nearest negative vertex distance among planes fully containing the lane
+};
+
+void classifyCoherenceLanes(const Frustum& frustum, const AABB4& boxes, uint32_t laneMask, uint32_t planeMask,
+                            uint8_t& hintPlane, CoherenceLanes& out, uint32_t& planeTests) {
+    constexpr float unbounded = std::numeric_limits<float>::max();
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        out.straddle[lane]      = 0;
+        out.outsideMargin[lane] = 0.0f;
+        out.visibleMargin[lane] = unbounded;
+        out.insideMargin[lane]  = unbounded;
+    }
+
+    // As in testAABB4Masked, start at the plane that last rejected a lane and drop rejected
+    // lanes; their margin is that of the first plane rejecting them
+    uint32_t outside = 0;
+    uint32_t startPlane = hintPlane < Frustum::CULL_PLANE_COUNT ? hintPlane : 0;
+    for (uint32_t step = 0; step < Frustum::CULL_PLANE_COUNT && (laneMask & ~outside); ++step) {
+        uint32_t i = (startPlane + step) % Frustum::CULL_PLANE_COUNT;
+        if (!(planeMask & (1u << i))) {
+            continue;
+        }
+        planeTests += static_cast<uint32_t>(std::popcount(laneMask & ~outside));
+
+        const glm::vec4& plane = frustum.planes[i];
+        alignas(16) float pDistance[4];
+        alignas(16) float nDistance[4];
+#if defined(VIOLET_SIMD_SSE)
+        const __m128 minX = _mm_load_ps(boxes.minX), maxX = _mm_load_ps(boxes.maxX);
+        const __m128 minY = _mm_load_ps(boxes.minY), maxY = _mm_load_ps(boxes.maxY);
+        const __m128 minZ = _mm_load_ps(boxes.minZ), maxZ = _mm_load_ps(boxes.maxZ);
+        __m128 px = plane.x > 0 ? maxX : minX, nx = plane.x > 0 ? minX : maxX;
+        __m128 py = plane.y > 0 ? maxY : minY, ny = plane.y > 0 ? minY : maxY;
+        __m128 pz = plane.z > 0 ? maxZ : minZ, nz = plane.z > 0 ? minZ : maxZ;
+        const __m128 a = _mm_set1_ps(plane.x), b = _mm_set1_ps(plane.y), c = _mm_set1_ps(plane.z);
+        const __m128 d = _mm_set1_ps(plane.w);
+        _mm_store_ps(pDistance, _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, a), _mm_mul_ps(py, b)), _mm_add_ps(_mm_mul_ps(pz, c), d)));
+        _mm_store_ps(nDistance, _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, a), _mm_mul_ps(ny, b)), _mm_add_ps(_mm_mul_ps(nz, c), d)));
+#else
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            AABB box = boxes.getLane(lane);
+            glm::vec3 p(plane.x > 0 ? box.max.x : box.min.x, plane.y > 0 ? box.max.y : box.min.y,
+                        plane.z > 0 ? box.max.z : box.min.z);
+            glm::vec3 n(plane.x > 0 ? box.min.x : box.max.x, plane.y > 0 ? box.min.y : box.max.y,
+                        plane.z > 0 ? box.min.z : box.max.z);
+            pDistance[lane] = glm::dot(glm::vec3(plane), p) + plane.w;
+            nDistance[lane] = glm::dot(glm::vec3(plane), n) + plane.w;
+        }
+#endif
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            uint32_t bit = 1u << lane;
+            if (!(laneMask & bit) || (outside & bit)) {
+                continue;
+            }
+            if (pDistance[lane] < 0) {
+                outside |= bit;
+                out.outsideMargin[lane] = -pDistance[lane];
+                hintPlane = static_cast<uint8_t>(i);
+                continue;
+            }
+            out.visibleMargin[lane] = eastl::min(out.visibleMargin[lane], pDistance[lane]);
+            if (nDistance[lane] < 0) {
+                out.straddle[lane] |= 1u << i;
+            } else {
+                out.insideMargin[lane] = eastl::min(out.insideMargin[lane], nDistance[lane]);
+            }
+        }
+    }
+    out.passed = laneMask & ~outside;
+}
+
+// Slack subtracted from coherence margins so float rounding in the box/plane distances can
+// never keep a lane whose exact test would flip
+float coherenceTolerance(const AABB& sceneBounds) {
+    glm::vec3 extent = glm::max(glm::abs(sceneBounds.min), glm::abs(sceneBounds.max));
+    return 1e-5f * (eastl::max(extent.x, eastl::max(extent.y, extent.z)) + 1.0f);
+}
+
+} // anonymous namespace
+
+void BVH::resetBuildState() {
+    nodes.clear();
+    leafIndices.clear();
+    parentIndices.clear();
+    primitiveLeaves.clear();
+    wideNodes.clear();
+    wideSlots.clear();
+    wideRanges.clear();
+    wideVersions.clear();
+    binaryStackSize = 1;
+    wideStackSize   = 1;
+    primitiveBounds.clear();
+    builtAreaSum    = 0.0;
+    currentAreaSum  = 0.0;
+    sceneBounds = AABB();
+    buildStats   = BVHBuildStats{};
+    qualityStats = BVHQualityStats{};
+    ++topologyVersion;
+    ++boundsVersion;
+}
+
+void BVH::build(const eastl::vector<AABB>& bounds, ThreadPool* threadPool, BVHBuildMethod method) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    resetBuildState();
+    primitiveBounds   = bounds;
+    buildStats.method = method;
+
+    if (bounds.empty()) {
+        return;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(bounds.size());
+    ThreadPool*    pool  = nullptr;
+
+    if (method == BVHBuildMethod::SAH) {
+        buildSAH(bounds);
+    } else {
+        if (threadPool && threadPool->getThreadCount() > 0 && count >= PARALLEL_BUILD_THRESHOLD) {
+            pool = threadPool;
+        }
+
+        eastl::vector<uint64_t> codes;
+        eastl::vector<uint32_t> indices;
+        computeMortonCodes(bounds, codes, indices, pool);
+        radixSort(codes, indices, buildStats.mortonBits, pool);
+        buildLinearBVH(bounds, codes, indices, pool);
+    }
+
+    buildRefitData(pool);
+    buildWideBVH();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    buildStats.buildTimeMs    = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+    buildStats.primitiveCount = count;
+    buildStats.nodeCount      = static_cast<uint32_t>(nodes.size());
+    buildStats.parallel       = pool != nullptr;
+
+    computeQualityStats();
+}
+
+uint64_t BVH::computeCacheKey(const eastl::vector<AABB>& bounds, BVHBuildMethod method) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint32_t word) {
+        hash = (hash ^ word) * 1099511628211ull;
+    };
+
+    // Word-wise rather than byte-wise: the input is floats, and this runs on every scene load
+    mix(CACHE_VERSION);
+    mix(static_cast<uint32_t>(method));
+    mix(static_cast<uint32_t>(bounds.size()));
+    for (const AABB& box : bounds) {
+        const float values[6] = {box.min.x, box.min.y, box.min.z, box.max.x, box.max.y, box.max.z};
+        for (float value : values) {
+            mix(std::bit_cast<uint32_t>(value));
+        }
+    }
+    return hash;
+}
+
+void BVH::serialize(uint64_t key, eastl::vector<uint8_t>& out) const {
+    CacheHeader header{};
+    header.magic          = CACHE_MAGIC;
+    header.version        = CACHE_VERSION;
+    header.key            = key;
+    header.method         = static_cast<uint32_t>(buildStats.method);
+    header.primitiveCount = static_cast<uint32_t>(leafIndices.size());
+    header.nodeCount      = static_cast<uint32_t>(nodes.size());
+
+    const size_t base = out.size();
+    out.resize(base + sizeof(CacheHeader) + nodes.size() * sizeof(CacheNode) + leafIndices.size() * sizeof(uint32_t));
+
+    uint8_t* dst = out.data() + base;
+    std::memcpy(dst, &header, sizeof(header));
+    dst += sizeof(header);
+
+    for (const BVHNode& node : nodes) {
+        const CacheNode record{node.firstChild, node.count, node.rightChild};
+        std::memcpy(dst, &record, sizeof(record));
+        dst += sizeof(record);
+    }
+
+    if (!leafIndices.empty()) {
+        std::memcpy(dst, leafIndices.data(), leafIndices.size() * sizeof(uint32_t));
+    }
+}
+
+bool BVH::deserialize(const uint8_t* data, size_t size, uint64_t key, const eastl::vector<AABB>& bounds,
+                      BVHBuildMethod method, ThreadPool* threadPool) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    resetBuildState();
+
+    CacheHeader header;
+    if (!data || size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    const uint64_t primitiveCount = bounds.size();
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.key != key ||
+        header.method != static_cast<uint32_t>(method) || header.primitiveCount != primitiveCount ||
+        primitiveCount == 0 || header.nodeCount == 0 || header.nodeCount > 2 * primitiveCount - 1) {
+        return false;
+    }
+
+    const uint32_t nodeCount = header.nodeCount;
+    if (size != sizeof(header) + static_cast<size_t>(nodeCount) * sizeof(CacheNode) +
+                    static_cast<size_t>(primitiveCount) * sizeof(uint32_t)) {
+        return false;
+    }
+
+    const uint8_t* src = data + sizeof(header);
+    nodes.resize(nodeCount);
+    for (BVHNode& node : nodes) {
+        CacheNode record;
+        std::memcpy(&record, src, sizeof(record));
+        src += sizeof(record);
+        node.firstChild = record.firstChild;
+        node.count      = record.count;
+        node.rightChild = record.rightChild;
+    }
+    leafIndices.resize(primitiveCount);
+    std::memcpy(leafIndices.data(), src, primitiveCount * sizeof(uint32_t));
+
+    // Every node must be reachable exactly once from the root, the leaves must take consecutive
+    // runs of leafIndices in left-to-right order (wide node ranges rely on it), and leafIndices
+    // must be a permutation of the primitives
+    eastl::vector<uint8_t>  seen(eastl::max<size_t>(nodeCount, primitiveCount), 0);
+    eastl::vector<uint32_t> preorder;
+    eastl::vector<uint32_t> stack;
+    preorder.reserve(nodeCount);
+    stack.push_back(0);
+    seen[0] = 1;
+
+    uint64_t coveredSlots = 0;
+    bool     valid        = true;
+    while (!stack.empty() && valid) {
+        const uint32_t nodeIndex = stack.back();
+        stack.pop_back();
+        preorder.push_back(nodeIndex);
+
+        const BVHNode& node = nodes[nodeIndex];
+        if (node.isLeaf()) {
+            valid = node.firstChild == coveredSlots && node.count <= primitiveCount - coveredSlots;
+            coveredSlots += node.count;
+            continue;
+        }
+        // Right pushed first, so the left subtree and its leaves come first
+        for (uint32_t child : {node.rightChild, node.firstChild}) {
+            if (child >= nodeCount || seen[child]) {
+                valid = false;
+                break;
+            }
+            seen[child] = 1;
+            stack.push_back(child);
+        }
+    }
+    valid = valid && preorder.size() == nodeCount && coveredSlots == primitiveCount;
+
+    if (valid) {
+        eastl::fill(seen.begin(), seen.end(), uint8_t(0));
+        for (uint32_t primitive : leafIndices) {
+            if (primitive >= primitiveCount || seen[primitive]) {
+                valid = false;
+                break;
+            }
+            seen[primitive] = 1;
+        }
+    }
+    if (!valid) {
+        resetBuildState();
+        return false;
+    }
+
+    // Children come after their parent in preorder, so walking it backwards is bottom-up
+    for (auto it = preorder.rbegin(); it != preorder.rend(); ++it) {
+        BVHNode& node = nodes[*it];
+        node.bounds   = AABB();
+        if (node.isLeaf()) {
+            for (uint32_t i = 0; i < node.count; ++i) {
+                node.bounds.expand(bounds[leafIndices[node.firstChild + i]]);
+            }
+        } else {
+            node.bounds.expand(nodes[node.firstChild].bounds);
+            node.bounds.expand(nodes[node.rightChild].bounds);
+        }
+    }
+
+    primitiveBounds = bounds;
+    sceneBounds     = nodes[0].bounds;
+
+    ThreadPool* pool = threadPool && threadPool->getThreadCount() > 0 && primitiveCount >= PARALLEL_BUILD_THRESHOLD
+                           ? threadPool
+                           : nullptr;
+    buildRefitData(pool);
+    buildWideBVH();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    buildStats.buildTimeMs    = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+    buildStats.primitiveCount = static_cast<uint32_t>(primitiveCount);
+    buildStats.nodeCount      = nodeCount;
+    buildStats.parallel       = pool != nullptr;
+    buildStats.method         = method;
+    buildStats.fromCache      = true;
+
+    computeQualityStats();
+    return true;
+}
+
+template<typename LaneTest, typename PrimitiveTest>
+uint32_t BVH::queryOverlap(LaneTest&& laneTest, PrimitiveTest&& primitiveTest, eastl::vector<uint32_t>& results,
+                           uint32_t maxResults) const {
+    if (maxResults == 0) {
+        return 0;
+    }
+
+    // Leaves may hold several primitives, so each is checked against its own bounds
+    uint32_t appended = 0;
+    traverseWide(laneTest, [&](uint32_t primitiveIndex) {
+        if (primitiveTest(primitiveBounds[primitiveIndex])) {
+            results.push_back(primitiveIndex);
+            ++appended;
+        }
+        return appended < maxResults;
+    });
+    return appended;
+}
+
+uint32_t BVH::queryAABB(const AABB& box, eastl::vector<uint32_t>& results, uint32_t maxResults) const {
+    return queryOverlap([&](const AABB4& lanes) { return overlapLanes(lanes, box); },
+                        [&](const AABB& bounds) { return bounds.overlaps(box); }, results, maxResults);
+}
+
+uint32_t BVH::querySphere(const glm::vec3& center, float radius, eastl::vector<uint32_t>& results,
+                          uint32_t maxResults) const {
+    const float radiusSquared = radius * radius;
+    return queryOverlap(
+        [&](const AABB4& lanes) {
+            float distances[4];
+            laneDistancesSquared(lanes, center, distances);
+            uint32_t mask = 0;
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                mask |= distances[lane] <= radiusSquared ? 1u << lane : 0u;
+            }
+            return mask;
+        },
+        [&](const AABB& bounds) { return bounds.distanceSquared(center) <= radiusSquared; }, results, maxResults);
+}
+
+uint32_t BVH::queryOBB(const OBB& box, eastl::vector<uint32_t>& results, uint32_t maxResults) const {
+    // The OBB's world bounds reject most lanes before the separating axis test runs
+    const AABB boxBounds = box.getBounds();
+    return queryOverlap(
+        [&](const AABB4& lanes) {
+            uint32_t mask = overlapLanes(lanes, boxBounds);
+            for (uint32_t bits = mask; bits; bits &= bits - 1) {
+                const uint32_t lane = static_cast<uint32_t>(std::countr_zero(bits));
+                if (!box.intersects(lanes.getLane(lane))) {
+                    mask &= ~(1u << lane);
+                }
+            }
+            return mask;
+        },
+        [&](const AABB& bounds) { return bounds.overlaps(boxBounds) && box.intersects(bounds); }, results,
+        maxResults);
+}
+
+void BVH::emitWideLane(const BVH4Node& node, uint32_t lane, eastl::vector<uint32_t>& visible) const {
+    // Leaf lanes emit their primitives, internal lanes (fully inside) the run under the child
+    uint32_t first = node.children[lane];
+    uint32_t count = node.counts[lane];
+    if (!(node.leafMask & (1u << lane))) {
+        first = wideRanges[node.children[lane]].first;
+        count = wideRanges[node.children[lane]].count;
+    }
+    visible.insert(visible.end(), leafIndices.begin() + first, leafIndices.begin() + first + count);
+}
+
+void BVH::cullCoherentSubtree(const Frustum& frustum, uint32_t rootNode, uint32_t planeMask, float inheritedMargin,
+                              BVHCullCoherence& state, eastl::vector<uint32_t>& visible, BVHCoherenceStats& stats) const {
+    // cullFrustum's traversal, recording every node where some lane stops descending. Entries
+    // are (node, plane mask, margin of the planes above that are no longer tested).
+    BVHTraversalStack stack(wideStackSize * 3);
+    stack.push(rootNode);
+    stack.push(planeMask);
+    stack.push(std::bit_cast<uint32_t>(inheritedMargin));
+
+    const float tolerance = coherenceTolerance(sceneBounds);
+    while (!stack.empty()) {
+        float    margin    = std::bit_cast<float>(stack.pop());
+        uint32_t mask      = stack.pop();
+        uint32_t nodeIndex = stack.pop();
+        const BVH4Node& node = wideNodes[nodeIndex];
+
+        CoherenceLanes lanes;
+        classifyCoherenceLanes(frustum, node.bounds, node.validMask, mask, state.planeHints[nodeIndex], lanes,
+                               stats.planeTests);
+        ++stats.nodesVisited;
+
+        BVHCullCoherence::CutNode entry{nodeIndex, 0, 0, {}};
+        for (int lane = 3; lane >= 0; --lane) {
+            uint32_t bit = 1u << lane;
+            if (!(node.validMask & bit)) {
+                continue;
+            }
+            float laneMargin;
+            if (!(lanes.passed & bit)) {
+                laneMargin = lanes.outsideMargin[lane];
+            } else if (!(node.leafMask & bit) && lanes.straddle[lane] != 0) {
+                stack.push(node.children[lane]);
+                stack.push(lanes.straddle[lane]);
+                stack.push(std::bit_cast<uint32_t>(eastl::min(margin, lanes.insideMargin[lane])));
+                continue;
+            } else {
+                emitWideLane(node, static_cast<uint32_t>(lane), visible);
+                entry.visibleLanes |= bit;
+                laneMargin = eastl::min(margin, (node.leafMask & bit) ? lanes.visibleMargin[lane] : lanes.insideMargin[lane]);
+            }
+            entry.lanes |= bit;
+            entry.expiry[lane] = state.drift + laneMargin - tolerance;
+        }
+        if (entry.lanes) {
+            state.cut.push_back(entry);
+        }
+    }
+}
+
+const eastl::vector<uint32_t>& BVH::cullFrustumCoherent(const Frustum& frustum, BVHCullCoherence& state,
+                                                        BVHCoherenceStats* stats) const {
+    BVHCoherenceStats localStats;
+    BVHCoherenceStats& counters = stats ? *stats : localStats;
+    counters = BVHCoherenceStats{};
+
+    if (wideNodes.empty()) {
+        state.reset();
+        return state.visible;
+    }
+
+    bool topologyChanged = state.topologyVersion != topologyVersion;
+    if (!topologyChanged && state.boundsVersion == boundsVersion && state.planes == frustum.planes) {
+        // Static view of a static tree (e.g. an idle editor camera)
+        counters.reused          = true;
+        counters.cutNodes        = static_cast<uint32_t>(state.cut.size());
+        counters.carriedVisible  = static_cast<uint32_t>(state.visible.size());
+        counters.planeTestsSaved = state.fullPlaneTests;
+        return state.visible;
+    }
+
+    bool full = topologyChanged || state.cut.empty() || ++state.framesSinceFull >= state.revalidateInterval ||
+                state.cut.size() > 2 * state.fullCutSize;
+
+    state.visible.clear();
+    state.newlyVisible.clear();
+    if (full) {
+        if (topologyChanged) {
+            state.planeHints.assign(wideNodes.size(), 0);
+        }
+        state.cut.clear();
+        state.drift = 0.0f;
+        cullCoherentSubtree(frustum, 0, Frustum::CULL_PLANE_MASK, std::numeric_limits<float>::max(), state,
+                            state.visible, counters);
+        state.framesSinceFull = 0;
+        state.fullCutSize     = static_cast<uint32_t>(state.cut.size());
+        state.fullPlaneTests  = counters.planeTests;
+        counters.fullTraversal = true;
+    } else {
+        // Bound the change of every plane's signed distance over the scene: |dn.c + dd| + |dn|.e
+        const glm::vec3 center  = sceneBounds.center();
+        const glm::vec3 extents = sceneBounds.size() * 0.5f;
+        float frameDrift = 0.0f;
+        for (uint32_t i = 0; i < Frustum::CULL_PLANE_COUNT; ++i) {
+            glm::vec4 delta = frustum.planes[i] - state.planes[i];
+            glm::vec3 normalDelta(delta);
+            frameDrift = eastl::max(frameDrift, std::abs(glm::dot(normalDelta, center) + delta.w) +
+                                                    glm::dot(glm::abs(normalDelta), extents));
+        }
+        state.drift += frameDrift;
+
+        const float tolerance = coherenceTolerance(sceneBounds);
+        state.previousCut.swap(state.cut);
+        state.cut.clear();
+        for (const BVHCullCoherence::CutNode& previous : state.previousCut) {
+            const BVH4Node& node = wideNodes[previous.node];
+            bool changed = wideVersions[previous.node] > state.boundsVersion;  // Patched by a refit since
+
+            BVHCullCoherence::CutNode entry = previous;
+            uint32_t retest = 0;
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                uint32_t bit = 1u << lane;
+                if (!(previous.lanes & bit)) {
+                    continue;
+                }
+                if (changed || state.drift >= previous.expiry[lane]) {
+                    retest |= bit;
+                } else if (previous.visibleLanes & bit) {
+                    emitWideLane(node, lane, state.visible);  // Still certainly visible
+                }
+            }
+            if (!retest) {
+                state.cut.push_back(entry);
+                continue;
+            }
+
+            // Every plane is tested: ancestors above the cut are not, so nothing is inherited
+            CoherenceLanes lanes;
+            classifyCoherenceLanes(frustum, node.bounds, retest, Frustum::CULL_PLANE_MASK, state.planeHints[previous.node],
+                                   lanes, counters.planeTests);
+            ++counters.nodesVisited;
+
+            entry.lanes        &= ~retest;
+            entry.visibleLanes &= ~retest;
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                uint32_t bit = 1u << lane;
+                if (!(retest & bit)) {
+                    continue;
+                }
+                eastl::vector<uint32_t>& target = (previous.visibleLanes & bit) ? state.visible : state.newlyVisible;
+                float laneMargin;
+                if (!(lanes.passed & bit)) {
+                    laneMargin = lanes.outsideMargin[lane];
+                } else if (!(node.leafMask & bit) && lanes.straddle[lane] != 0) {
+                    // Now straddling: refine the cut below this lane
+                    cullCoherentSubtree(frustum, node.children[lane], lanes.straddle[lane], lanes.insideMargin[lane],
+                                        state, target, counters);
+                    continue;
+                } else {
+                    emitWideLane(node, lane, target);
+                    entry.visibleLanes |= bit;
+                    laneMargin = (node.leafMask & bit) ? lanes.visibleMargin[lane] : lanes.insideMargin[lane];
+                }
+                entry.lanes |= bit;
+                entry.expiry[lane] = state.drift + laneMargin - tolerance;
+            }
+            if (entry.lanes) {
+                state.cut.push_back(entry);
+            }
+        }
+
+        counters.carriedVisible = static_cast<uint32_t>(state.visible.size());
+        counters.newlyVisible   = static_cast<uint32_t>(state.newlyVisible.size());
+        state.visible.insert(state.visible.end(), state.newlyVisible.begin(), state.newlyVisible.end());
+        counters.planeTestsSaved = state.fullPlaneTests > counters.planeTests ? state.fullPlaneTests - counters.planeTests : 0;
+        if (counters.planeTests >= state.fullPlaneTests) {
+            // The view moves too fast for the margins to pay off; start over from the root
+            state.framesSinceFull = state.revalidateInterval;
+        }
+    }
+
+    state.planes          = frustum.planes;
+    state.topologyVersion = topologyVersion;
+    state.boundsVersion   = boundsVersion;
+    counters.cutNodes     = static_cast<uint32_t>(state.cut.size());
+    return state.visible;
+}
+
+uint32_t BVH::queryFrustum(const Frustum& frustum, eastl::vector<uint32_t>& results, uint32_t maxResults) const {
+    return queryOverlap([&](const AABB4& lanes) { return frustum.testAABB4(lanes); },
+                        [&](const AABB& bounds) { return frustum.testAABB(bounds); }, results, maxResults);
+}
+
+uint32_t BVH::queryNearest(const glm::vec3& point, uint32_t k, float maxDistance,
+                           eastl::vector<BVHNeighbor>& results) const {
+    if (wideNodes.empty() || k == 0 || !(maxDistance >= 0.0f)) {
+        return 0;
+    }
+
+    // results[base..] is a max-heap of the best k so far; distances stay squared until the end
+    const size_t base               = results.size();
+    const float  maxDistanceSquared = maxDistance * maxDistance;
+    auto nearer = [](const BVHNeighbor& a, const BVHNeighbor& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.primitiveIndex < b.primitiveIndex);
+    };
+    auto bound = [&] { return results.size() - base < k ? maxDistanceSquared : results[base].distance; };
+
+    // Entries are (node, squared distance bits) pairs so stale entries are skipped on pop
+    BVHTraversalStack stack(wideStackSize * 2);
+    stack.push(0);
+    stack.push(std::bit_cast<uint32_t>(0.0f));
+
+    while (!stack.empty()) {
+        const float    nodeDistance = std::bit_cast<float>(stack.pop());
+        const uint32_t nodeIndex    = stack.pop();
+        if (nodeDistance > bound()) {
+            continue;
+        }
+
+        const BVH4Node& node = wideNodes[nodeIndex];
+        float distances[4];
+        laneDistancesSquared(node.bounds, point, distances);
+
+        // Lanes nearest first: leaves tighten the bound before internal lanes are considered
+        uint32_t order[4] = {0, 1, 2, 3};
+        for (uint32_t i = 1; i < 4; ++i) {
+            for (uint32_t j = i; j > 0 && distances[order[j]] < distances[order[j - 1]]; --j) {
+                eastl::swap(order[j], order[j - 1]);
+            }
+        }
+
+        for (uint32_t lane : order) {
+            const uint32_t bit = 1u << lane;
+            if (!(node.validMask & node.leafMask & bit) || distances[lane] > bound()) {
+                continue;
+            }
+            for (uint32_t i = 0; i < node.counts[lane]; ++i) {
+                const uint32_t    primitiveIndex = leafIndices[node.children[lane] + i];
+                const BVHNeighbor candidate{primitiveIndex, primitiveBounds[primitiveIndex].distanceSquared(point)};
+                if (results.size() - base < k) {
+                    if (candidate.distance <= maxDistanceSquared) {
+                        results.push_back(candidate);
+                        eastl::push_heap(results.begin() + base, results.end(), nearer);
+                    }
+                } else if (nearer(candidate, results[base])) {
+                    eastl::pop_heap(results.begin() + base, results.end(), nearer);
+                    results.back() = candidate;
+                    eastl::push_heap(results.begin() + base, results.end(), nearer);
+                }
+            }
+        }
+
+        // Farthest pushed first so the nearest internal lane is popped next
+        for (int i = 3; i >= 0; --i) {
+            const uint32_t lane = order[i];
+            const uint32_t bit  = 1u << lane;
+            if ((node.validMask & bit) && !(node.leafMask & bit) && distances[lane] <= bound()) {
+                stack.push(node.children[lane]);
+                stack.push(std::bit_cast<uint32_t>(distances[lane]));
+            }
+        }
+    }
+
+    eastl::sort_heap(results.begin() + base, results.end(), nearer);
+    for (size_t i = base; i < results.size(); ++i) {
+        results[i].distance = std::sqrt(results[i].distance);
+    }
+    return static_cast<uint32_t>(results.size() - base);
+}
+
+void BVH::computeMortonCodes(const eastl::vector<AABB>& bounds, eastl::vector<uint64_t>& codes,
+                             eastl::vector<uint32_t>& indices, ThreadPool* pool) {
+    const uint32_t count = static_cast<uint32_t>(bounds.size());
+
+    // Scene bounds as a chunked reduction; Morton codes are quantized against centroids
+    // so the centroid bounds give the tightest grid. The summed primitive extent drives
+    // the choice of code width below.
+    const uint32_t    chunkCount = (count + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE;
+    eastl::vector<AABB> partialScene(chunkCount);
+    eastl::vector<AABB> partialCentroid(chunkCount);
+    eastl::vector<double> partialExtent(chunkCount, 0.0);
+
+    dispatch(pool, chunkCount, 1, [&](uint32_t chunkBegin, uint32_t chunkEnd) {
+        for (uint32_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            uint32_t begin = chunk * MIN_CHUNK_SIZE;
+            uint32_t end   = eastl::min(begin + MIN_CHUNK_SIZE, count);
+            for (uint32_t i = begin; i < end; ++i) {
+                partialScene[chunk].expand(bounds[i]);
+                partialCentroid[chunk].expand(bounds[i].center());
+                glm::vec3 size = bounds[i].size();
+                partialExtent[chunk] += eastl::max(size.x, eastl::max(size.y, size.z));
+            }
+        }
+    });
+
+    AABB   centroidBounds;
+    double extentSum = 0.0;
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+        sceneBounds.expand(partialScene[chunk]);
+        centroidBounds.expand(partialCentroid[chunk]);
+        extentSum += partialExtent[chunk];
+    }
+
+    // Quantize on a cubic grid: per-axis normalization would give thin axes (e.g. the height
+    // of a flat level) the same number of cells as wide ones and make top-level splits slab-like
+    glm::vec3 extent       = centroidBounds.size();
+    float     sceneExtent  = eastl::max(extent.x, eastl::max(extent.y, extent.z));
+    glm::vec3 invSceneSize = glm::vec3(sceneExtent > 0.0f ? 1.0f / sceneExtent : 0.0f);
+
+    // Adaptive width: the grid cell should be no larger than a typical primitive, so
+    // distant outliers in sparse scenes don't collapse everything else into a few cells.
+    // Wider codes cost extra radix passes (one per 8 key bits), so grow only as far as needed.
+    double   avgPrimitive = extentSum / count;
+    uint32_t bitsPerAxis  = MIN_MORTON_BITS_PER_AXIS;
+    if (avgPrimitive > 0.0 && sceneExtent > 0.0f) {
+        double cellsNeeded = static_cast<double>(sceneExtent) / avgPrimitive;
+        while (bitsPerAxis < MAX_MORTON_BITS_PER_AXIS && static_cast<double>(1u << bitsPerAxis) < cellsNeeded) {
+            ++bitsPerAxis;
+        }
+    } else if (sceneExtent > 0.0f) {
+        bitsPerAxis = MAX_MORTON_BITS_PER_AXIS;  // Point primitives: use the finest grid
+    }
+    buildStats.mortonBits = bitsPerAxis * 3;
+    const float gridScale = static_cast<float>((1u << bitsPerAxis) - 1);
+
+    codes.resize(count);
+    indices.resize(count);
+
+    dispatch(pool, count, MIN_CHUNK_SIZE, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            codes[i]   = mortonCode3D(bounds[i].center(), centroidBounds.min, invSceneSize, gridScale);
+            indices[i] = i;
+        }
+    });
+}
+
+void BVH::buildLinearBVH(const eastl::vector<AABB>& bounds, const eastl::vector<uint64_t>& sortedCodes,
+                         const eastl::vector<uint32_t>& sortedIndices, ThreadPool* pool) {
+    const uint32_t count = static_cast<uint32_t>(sortedCodes.size());
+
+    // Layout: internal nodes [0, count - 1) with the root at 0, leaves [count - 1, 2 * count - 1).
+    // Leaf k references leafIndices[k], which holds the k-th primitive in Morton order.
+    const uint32_t internalCount = count - 1;
+    nodes.resize(static_cast<size_t>(internalCount) + count);
+    leafIndices = sortedIndices;
+
+    parentIndices.assign(nodes.size(), INVALID_NODE);
+
+    dispatch(pool, count, MIN_CHUNK_SIZE, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t k = begin; k < end; ++k) {
+            BVHNode& leaf   = nodes[internalCount + k];
+            leaf.bounds     = bounds[sortedIndices[k]];
+            leaf.firstChild = k;
+            leaf.count      = 1;
+            leaf.rightChild = 0;
+        }
+    });
+
+    if (count == 1) {
+        return;
+    }
+
+    // Length of the common prefix of keys i and j. Keys are index-augmented: equal codes
+    // compare their sorted positions instead (the stable sort keeps duplicates in primitive
+    // order), so every key is unique and the hierarchy stays well-formed at any code width
+    auto delta = [&](int64_t i, int64_t j) -> int {
+        if (j < 0 || j >= static_cast<int64_t>(count)) {
+            return -1;
+        }
+        uint64_t a = sortedCodes[i];
+        uint64_t b = sortedCodes[j];
+        if (a == b) {
+            return 64 + std::countl_zero(static_cast<uint64_t>(i ^ j));
+        }
+        return std::countl_zero(a ^ b);
+    };
+
+    // Every internal node finds its key range and split independently (Karras 2012)
+    dispatch(pool, internalCount, MIN_CHUNK_SIZE, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t idx = begin; idx < end; ++idx) {
+            int64_t i = idx;
+
+            int     d        = (delta(i, i + 1) - delta(i, i - 1)) >= 0 ? 1 : -1;
+            int     deltaMin = delta(i, i - d);
+            int64_t lMax     = 2;
+            while (delta(i, i + lMax * d) > deltaMin) {
+                lMax *= 2;
+            }
+
+            int64_t l = 0;
+            for (int64_t t = lMax / 2; t >= 1; t /= 2) {
+                if (delta(i, i + (l + t) * d) > deltaMin) {
+                    l += t;
+                }
+            }
+            int64_t j = i + l * d;
+
+            int     deltaNode = delta(i, j);
+            int64_t s         = 0;
+            int64_t t         = l;
+            do {
+                t = (t + 1) / 2;
+                if (delta(i, i + (s + t) * d) > deltaNode) {
+                    s += t;
+                }
+            } while (t > 1);
+            int64_t split = i + s * d + eastl::min<int64_t>(d, 0);
+
+            int64_t first = eastl::min(i, j);
+            int64_t last  = eastl::max(i, j);
+
+            uint32_t left  = (first == split) ? internalCount + static_cast<uint32_t>(split) : static_cast<uint32_t>(split);
+            uint32_t right = (last == split + 1) ? internalCount + static_cast<uint32_t>(split + 1)
+                                                 : static_cast<uint32_t>(split + 1);
+
+            BVHNode& node   = nodes[idx];
+            node.firstChild = left;
+            node.rightChild = right;
+            node.count      = 0;
+
+            parentIndices[left]  = idx;
+            parentIndices[right] = idx;
+        }
+    });
+
+    // Bottom-up bounds: each leaf walks towards the root; the second thread to reach
+    // an internal node sees both children finished and continues upwards
+    eastl::vector<uint32_t> visited(internalCount, 0);
+
+    dispatch(pool, count, MIN_CHUNK_SIZE, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t k = begin; k < end; ++k) {
+            uint32_t current = internalCount + k;
+            while (current != 0) {
+                uint32_t parent = parentIndices[current];
+                if (std::atomic_ref<uint32_t>(visited[parent]).fetch_add(1, std::memory_order_acq_rel) == 0) {
+                    break;
+                }
+                BVHNode& node = nodes[parent];
+                node.bounds   = nodes[node.firstChild].bounds.unionOf(nodes[node.rightChild].bounds);
+                current       = parent;
+            }
+        }
+    });
+}
+
+void BVH::buildSAH(const eastl::vector<AABB>& bounds) {
+    const uint32_t count = static_cast<uint32_t>(bounds.size());
+
+    eastl::vector<glm::vec3> centroids(count);
+    leafIndices.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        centroids[i]   = bounds[i].center();
+        leafIndices[i] = i;
+        sceneBounds.expand(bounds[i]);
+    }
+
+    // A binary tree never exceeds 2N - 1 nodes; reserving keeps node references stable
+    nodes.reserve(static_cast<size_t>(count) * 2 - 1);
+    buildSAHRecursive(bounds, centroids, 0, count);
+}
+
+uint32_t BVH::buildSAHRecursive(const eastl::vector<AABB>& bounds, const eastl::vector<glm::vec3>& centroids,
+                                uint32_t begin, uint32_t end) {
+    const uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(BVHNode{});
+
+    AABB nodeBounds;
+    AABB centroidBounds;
+    for (uint32_t i = begin; i < end; ++i) {
+        nodeBounds.expand(bounds[leafIndices[i]]);
+        centroidBounds.expand(centroids[leafIndices[i]]);
+    }
+    nodes[nodeIndex].bounds = nodeBounds;
+
+    const uint32_t count = end - begin;
+    auto makeLeaf = [&]() {
+        BVHNode& node   = nodes[nodeIndex];
+        node.firstChild = begin;
+        node.count      = count;
+        node.rightChild = 0;
+        return nodeIndex;
+    };
+
+    if (count == 1) {
+        return makeLeaf();
+    }
+
+    // Split along the axis with the widest centroid spread
+    glm::vec3 extent = centroidBounds.size();
+    int       axis   = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    uint32_t mid = begin;
+
+    if (extent[axis] > 0.0f) {
+        struct Bin {
+            AABB     bounds;
+            uint32_t count = 0;
+        };
+        Bin bins[SAH_BIN_COUNT];
+
+        const float binScale = static_cast<float>(SAH_BIN_COUNT) / extent[axis];
+        auto binOf = [&](uint32_t prim) {
+            uint32_t bin = static_cast<uint32_t>((centroids[prim][axis] - centroidBounds.min[axis]) * binScale);
+            return eastl::min(bin, SAH_BIN_COUNT - 1);
+        };
+
+        for (uint32_t i = begin; i < end; ++i) {
+            Bin& bin = bins[binOf(leafIndices[i])];
+            bin.bounds.expand(bounds[leafIndices[i]]);
+            ++bin.count;
+        }
+
+        // Sweep from the right to get suffix areas, then from the left to evaluate each plane
+        float    rightArea[SAH_BIN_COUNT];
+        uint32_t rightCount[SAH_BIN_COUNT];
+        AABB     accum;
+        uint32_t accumCount = 0;
+        for (uint32_t b = SAH_BIN_COUNT - 1; b > 0; --b) {
+            accum.expand(bins[b].bounds);
+            accumCount += bins[b].count;
+            rightArea[b]  = accumCount > 0 ? accum.surfaceArea() : 0.0f;
+            rightCount[b] = accumCount;
+        }
+
+        const float invParentArea = nodeBounds.surfaceArea() > 0.0f ? 1.0f / nodeBounds.surfaceArea() : 0.0f;
+        float       bestCost      = std::numeric_limits<float>::max();
+        uint32_t    bestSplit     = 0;
+
+        accum.reset();
+        accumCount = 0;
+        for (uint32_t b = 1; b < SAH_BIN_COUNT; ++b) {
+            accum.expand(bins[b - 1].bounds);
+            accumCount += bins[b - 1].count;
+            if (accumCount == 0 || rightCount[b] == 0) {
+                continue;
+            }
+            float cost = SAH_TRAVERSAL_COST + SAH_INTERSECT_COST * invParentArea *
+                                                  (accum.surfaceArea() * static_cast<float>(accumCount) +
+                                                   rightArea[b] * static_cast<float>(rightCount[b]));
+            if (cost < bestCost) {
+                bestCost  = cost;
+                bestSplit = b;
+            }
+        }
+
+        const float leafCost = SAH_INTERSECT_COST * static_cast<float>(count);
+        if (count <= SAH_MAX_LEAF_SIZE && leafCost <= bestCost) {
+            return makeLeaf();
+        }
+
+        if (bestSplit > 0) {
+            // In-place partition of the primitive range around the chosen plane
+            uint32_t lo = begin;
+            uint32_t hi = end;
+            while (lo < hi) {
+                if (binOf(leafIndices[lo]) < bestSplit) {
+                    ++lo;
+                } else {
+                    eastl::swap(leafIndices[lo], leafIndices[--hi]);
+                }
+            }
+            mid = lo;
+        }
+    } else if (count <= SAH_MAX_LEAF_SIZE) {
+        return makeLeaf();
+    }
+
+    // Coincident centroids or no usable plane: fall back to an object median split
+    if (mid == begin || mid == end) {
+        mid = begin + count / 2;
+    }
+
+    uint32_t left  = buildSAHRecursive(bounds, centroids, begin, mid);
+    uint32_t right = buildSAHRecursive(bounds, centroids, mid, end);
+
+    BVHNode& node   = nodes[nodeIndex];
+    node.firstChild = left;
+    node.rightChild = right;
+    node.count      = 0;
+    return nodeIndex;
+}
+
+void BVH::buildRefitData(ThreadPool* pool) {
+    const uint32_t nodeCount = static_cast<uint32_t>(nodes.size());
+
+    // LBVH already produced parent links during the emit; SAH derives them here
+    if (parentIndices.size() != nodeCount) {
+        parentIndices.assign(nodeCount, INVALID_NODE);
+        for (uint32_t i = 0; i < nodeCount; ++i) {
+            if (!nodes[i].isLeaf()) {
+                parentIndices[nodes[i].firstChild] = i;
+                parentIndices[nodes[i].rightChild] = i;
+            }
+        }
+    }
+
+    primitiveLeaves.resize(primitiveBounds.size());
+    dispatch(pool, nodeCount, MIN_CHUNK_SIZE, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const BVHNode& node = nodes[i];
+            for (uint32_t j = 0; j < node.count; ++j) {
+                primitiveLeaves[leafIndices[node.firstChild + j]] = i;
+            }
+        }
+    });
+
+    for (const auto& node : nodes) {
+        if (!node.isLeaf()) {
+            builtAreaSum += node.bounds.surfaceArea();
+        }
+    }
+    currentAreaSum = builtAreaSum;
+}
+
+void BVH::refit(uint32_t primitiveIndex, const AABB& bounds) {
+    if (primitiveIndex >= primitiveBounds.size()) {
+        return;
+    }
+
+    auto sameBounds = [](const AABB& a, const AABB& b) { return a.min == b.min && a.max == b.max; };
+
+    primitiveBounds[primitiveIndex] = bounds;
+    ++boundsVersion;
+
+    // Leaf bounds are the union of its primitives (a single one for LBVH)
+    uint32_t nodeIndex = primitiveLeaves[primitiveIndex];
+    BVHNode& leaf      = nodes[nodeIndex];
+    AABB     leafBounds;
+    for (uint32_t i = 0; i < leaf.count; ++i) {
+        leafBounds.expand(primitiveBounds[leafIndices[leaf.firstChild + i]]);
+    }
+    if (sameBounds(leafBounds, leaf.bounds)) {
+        return;
+    }
+    leaf.bounds = leafBounds;
+    updateWideSlot(nodeIndex);
+
+    // Walk up only while the union actually changes; unaffected subtrees are never touched
+    nodeIndex = parentIndices[nodeIndex];
+    while (nodeIndex != INVALID_NODE) {
+        BVHNode& node      = nodes[nodeIndex];
+        AABB     newBounds = nodes[node.firstChild].bounds.unionOf(nodes[node.rightChild].bounds);
+        if (sameBounds(newBounds, node.bounds)) {
+            break;
+        }
+        currentAreaSum += static_cast<double>(newBounds.surfaceArea()) - node.bounds.surfaceArea();
+        node.bounds = newBounds;
+        updateWideSlot(nodeIndex);
+        nodeIndex   = parentIndices[nodeIndex];
+    }
+
+    sceneBounds = nodes[0].bounds;
+}
+
+void BVH::buildWideBVH() {
+    wideSlots.assign(nodes.size(), INVALID_NODE);
+
+    // Each wide node starts from one binary node and repeatedly opens its largest internal
+    // child until four lanes are filled; opened nodes disappear from the wide tree
+    struct PendingNode {
+        uint32_t binaryIndex;
+        uint32_t parentSlot;  // (wideNode << 2 | lane) that references this node, INVALID_NODE for the root
+        uint32_t depth;
+    };
+    eastl::vector<PendingNode> pending;
+    pending.push_back({0u, INVALID_NODE, 0u});
+    uint32_t maxWideDepth = 0;
+
+    while (!pending.empty()) {
+        PendingNode current = pending.back();
+        pending.pop_back();
+        maxWideDepth = eastl::max(maxWideDepth, current.depth);
+
+        const uint32_t wideIndex = static_cast<uint32_t>(wideNodes.size());
+        if (current.parentSlot != INVALID_NODE) {
+            wideNodes[current.parentSlot >> 2].children[current.parentSlot & 3] = wideIndex;
+        }
+
+        // The subtree's run of leafIndices spans its leftmost to its rightmost leaf
+        uint32_t leftmost  = current.binaryIndex;
+        uint32_t rightmost = current.binaryIndex;
+        while (!nodes[leftmost].isLeaf()) {
+            leftmost = nodes[leftmost].firstChild;
+        }
+        while (!nodes[rightmost].isLeaf()) {
+            rightmost = nodes[rightmost].rightChild;
+        }
+        LeafRange range;
+        range.first = nodes[leftmost].firstChild;
+        range.count = nodes[rightmost].firstChild + nodes[rightmost].count - range.first;
+        wideRanges.push_back(range);
+
+        uint32_t lanes[4];
+        uint32_t laneCount = 0;
+        const BVHNode& binary = nodes[current.binaryIndex];
+        if (binary.isLeaf()) {
+            lanes[laneCount++] = current.binaryIndex;  // Single-leaf tree
+        } else {
+            lanes[laneCount++] = binary.firstChild;
+            lanes[laneCount++] = binary.rightChild;
+        }
+
+        while (laneCount < 4) {
+            int   widest     = -1;
+            float widestArea = -1.0f;
+            for (uint32_t i = 0; i < laneCount; ++i) {
+                const BVHNode& candidate = nodes[lanes[i]];
+                if (!candidate.isLeaf() && candidate.bounds.surfaceArea() > widestArea) {
+                    widest     = static_cast<int>(i);
+                    widestArea = candidate.bounds.surfaceArea();
+                }
+            }
+            if (widest < 0) {
+                break;
+            }
+            const BVHNode& opened = nodes[lanes[widest]];
+            lanes[widest]         = opened.firstChild;
+            lanes[laneCount++]    = opened.rightChild;
+        }
+
+        BVH4Node wide{};
+        wide.bounds.clear();
+        for (uint32_t lane = 0; lane < laneCount; ++lane) {
+            const BVHNode& child = nodes[lanes[lane]];
+            wide.bounds.setLane(lane, child.bounds);
+            wide.validMask |= 1u << lane;
+            wideSlots[lanes[lane]] = (wideIndex << 2) | lane;
+
+            if (child.isLeaf()) {
+                wide.leafMask |= 1u << lane;
+                wide.children[lane] = child.firstChild;
+                wide.counts[lane]   = child.count;
+            } else {
+                pending.push_back({lanes[lane], (wideIndex << 2) | lane, current.depth + 1});
+            }
+        }
+        wideNodes.push_back(wide);
+    }
+
+    // Each visited level leaves at most three sibling lanes pending
+    wideStackSize = 3 * maxWideDepth + 2;
+    wideVersions.assign(wideNodes.size(), boundsVersion);
+}
+
+void BVH::computeQualityStats() {
+    if (nodes.empty()) {
+        return;
+    }
+
+    const float rootArea    = nodes[0].bounds.surfaceArea();
+    const float invRootArea = rootArea > 0.0f ? 1.0f / rootArea : 0.0f;
+
+    uint32_t leafPrimitives = 0;
+    double   cost           = 0.0;
+
+    eastl::vector<eastl::pair<uint32_t, uint32_t>> stack;  // (node, depth)
+    stack.push_back({0u, 0u});
+
+    while (!stack.empty()) {
+        auto [nodeIndex, depth] = stack.back();
+        stack.pop_back();
+
+        const BVHNode& node = nodes[nodeIndex];
+        const float    area = node.bounds.surfaceArea() * invRootArea;
+
+        qualityStats.maxDepth = eastl::max(qualityStats.maxDepth, depth);
+
+        if (node.isLeaf()) {
+            ++qualityStats.leafCount;
+            leafPrimitives += node.count;
+            cost += SAH_INTERSECT_COST * area * node.count;
+        } else {
+            cost += SAH_TRAVERSAL_COST * area;
+            stack.push_back({node.firstChild, depth + 1});
+            stack.push_back({node.rightChild, depth + 1});
+        }
+    }
+
+    // Depth-first traversal leaves at most one pending sibling per level
+    binaryStackSize = qualityStats.maxDepth + 2;
+
+    qualityStats.sahCost     = static_cast<float>(cost);
+    qualityStats.avgLeafSize = static_cast<float>(leafPrimitives) / static_cast<float>(qualityStats.leafCount);
+}
+
+} // namespace violet
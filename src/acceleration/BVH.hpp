@@ -1,13 +1,26 @@
 #pragma once
 
+#include <EASTL/array.h>
 #include <EASTL/vector.h>
-#include <EASTL/sort.h>
+#include <EASTL/type_traits.h>
+#include <EASTL/utility.h>
 #include <glm/glm.hpp>
+#include <cassert>
+#include <bit>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
 #include "math/AABB.hpp"
+#include "math/AABB4.hpp"
 #include "math/Ray.hpp"
+#include "math/Frustum.hpp"
+#include "math/OBB.hpp"
 
 namespace violet {
 
+class ThreadPool;
+
 struct BVHNode {
     AABB bounds;
     uint32_t firstChild; // For internal: left child index, for leaf: first primitive index
@@ -17,73 +30,201 @@ struct BVHNode {
     bool isLeaf() const { return count > 0; }
 };
 
-struct MortonPrimitive {
-    uint64_t mortonCode;
-    uint32_t primitiveIndex;
-    AABB bounds;
+// Collapsed 4-wide node: child bounds in SoA lanes so one SIMD test covers all children
+struct BVH4Node {
+    AABB4    bounds;
+    uint32_t children[4];  // Internal lane: wide node index, leaf lane: first index into leafIndices
+    uint32_t counts[4];    // Internal lane: 0, leaf lane: primitive count
+    uint32_t validMask;    // Lanes that hold a child
+    uint32_t leafMask;     // Lanes that hold a leaf
 };
 
-class BVH {
+// Traversal stack that lives on the caller's frame. The builder records the worst-case
+// depth; only degenerate trees deeper than the inline capacity fall back to the heap.
+class BVHTraversalStack {
 public:
-    void build(const eastl::vector<AABB>& bounds) {
-        nodes.clear();
-        leafIndices.clear();
+    static constexpr uint32_t INLINE_CAPACITY = 64;
 
-        if (bounds.empty()) {
-            sceneBounds = AABB();  // Reset to empty
-            return;
+    explicit BVHTraversalStack(uint32_t requiredCapacity) {
+        if (requiredCapacity > INLINE_CAPACITY) {
+            heapStorage.resize(requiredCapacity);
+            data     = heapStorage.data();
+            capacity = requiredCapacity;
         }
+    }
 
-        // Calculate scene bounding box
-        sceneBounds = AABB();
-        for (const auto& bound : bounds) {
-            sceneBounds.expand(bound);
-        }
+    BVHTraversalStack(const BVHTraversalStack&) = delete;
+    BVHTraversalStack& operator=(const BVHTraversalStack&) = delete;
 
-        // Create Morton primitives
-        eastl::vector<MortonPrimitive> mortonPrims;
-        mortonPrims.reserve(bounds.size());
+    void push(uint32_t value) {
+        assert(size < capacity && "BVH traversal stack overflow");
+        data[size++] = value;
+    }
+    uint32_t pop() { return data[--size]; }
+    bool empty() const { return size == 0; }
 
-        for (uint32_t i = 0; i < bounds.size(); ++i) {
-            MortonPrimitive prim;
-            prim.primitiveIndex = i;
-            prim.bounds = bounds[i];
-            prim.mortonCode = mortonCode3D(bounds[i].center(), sceneBounds);
-            mortonPrims.push_back(prim);
-        }
+private:
+    uint32_t inlineStorage[INLINE_CAPACITY];
+    eastl::vector<uint32_t> heapStorage;
+    uint32_t* data = inlineStorage;
+    uint32_t capacity = INLINE_CAPACITY;
+    uint32_t size = 0;
+};
+
+// LBVH builds in near-linear time and suits per-frame rebuilds of dynamic content;
+// SAH is slower to build but produces tighter trees for static content
+enum class BVHBuildMethod {
+    LBVH,
+    SAH
+};
+
+// Statistics of the last build, for logging and UI
+struct BVHBuildStats {
+    float          buildTimeMs    = 0.0f;
+    uint32_t       primitiveCount = 0;
+    uint32_t       nodeCount      = 0;
+    bool           parallel       = false;  // Whether the build ran on the thread pool
+    BVHBuildMethod method         = BVHBuildMethod::LBVH;
+    uint32_t       mortonBits     = 0;      // LBVH code width actually used (3 x bits per axis)
+    bool           fromCache      = false;  // Topology was loaded by deserialize() instead of built
+};
+
+// Tree quality of the last build
+struct BVHQualityStats {
+    float    sahCost     = 0.0f;  // Expected traversal cost relative to the root surface area
+    float    avgLeafSize = 0.0f;  // Primitives per leaf
+    uint32_t leafCount   = 0;
+    uint32_t maxDepth    = 0;     // Root has depth 0
+};
 
-        // Sort by Morton code
-        eastl::sort(mortonPrims.begin(), mortonPrims.end(),
-                   [](const MortonPrimitive& a, const MortonPrimitive& b) {
-                       return a.mortonCode < b.mortonCode;
-                   });
+// Work counters for BVH::cullFrustum
+struct BVHCullStats {
+    uint32_t nodesVisited     = 0;
+    uint32_t planeTests       = 0;  // Box/plane tests; unmasked culling does 5 per visited lane
+    uint32_t subtreesAccepted = 0;  // Subtrees emitted without further tests
+};
 
-        // Build BVH using Linear BVH algorithm
-        buildLinearBVH(mortonPrims);
+// Per-view state for BVH::cullFrustumCoherent. It keeps the traversal cut of the previous
+// calls (the wide-node lanes where culling stopped: outside, fully inside or at a leaf) with,
+// per lane, how far the frustum may move before the lane's outcome can change.
+struct BVHCullCoherence {
+    // Coherent calls between full traversals. The cut only ever refines as the view moves, so
+    // revalidation also brings it back to the minimal cut for the current view.
+    uint32_t revalidateInterval = 60;
+
+    // Wide node with the lanes of it that are in the cut and which of those are visible. A lane
+    // is re-tested once the accumulated frustum drift reaches its expiry.
+    struct CutNode {
+        uint32_t node;
+        uint8_t  lanes;
+        uint8_t  visibleLanes;
+        float    expiry[4];
+    };
+
+    // Maintained by BVH::cullFrustumCoherent
+    eastl::vector<CutNode>  cut;
+    eastl::vector<CutNode>  previousCut;
+    eastl::vector<uint32_t> visible;
+    eastl::vector<uint32_t> newlyVisible;
+    eastl::vector<uint8_t>  planeHints;  // Per wide node, as for cullFrustum
+    eastl::array<glm::vec4, 6> planes{};
+    float    drift           = 0.0f;  // Bound on how far any plane moved across the scene since the last full traversal
+    uint32_t topologyVersion = ~0u;
+    uint32_t boundsVersion   = ~0u;
+    uint32_t framesSinceFull = 0;
+    uint32_t fullCutSize     = 0;
+    uint32_t fullPlaneTests  = 0;  // Cost of the last full traversal, the baseline for savings
+
+    // Forget everything; the next call traverses from the root
+    void reset() {
+        cut.clear();
+        visible.clear();
+        topologyVersion = ~0u;
+        boundsVersion   = ~0u;
     }
+};
+
+// Work counters for BVH::cullFrustumCoherent
+struct BVHCoherenceStats {
+    bool     reused          = false;  // Same frustum and tree as last call: the result was returned as is
+    bool     fullTraversal   = false;  // Walked from the root (first call, rebuild, revalidation)
+    uint32_t cutNodes        = 0;
+    uint32_t nodesVisited    = 0;
+    uint32_t planeTests      = 0;
+    uint32_t planeTestsSaved = 0;      // Relative to the last full traversal
+    uint32_t carriedVisible  = 0;      // Primitives under lanes that were visible last call
+    uint32_t newlyVisible    = 0;      // Primitives under lanes that were outside last call
+};
+
+// One result of BVH::queryNearest
+struct BVHNeighbor {
+    uint32_t primitiveIndex = 0;
+    float    distance       = 0.0f;  // From the query point to the primitive's bounds, 0 inside
+};
+
+class BVH {
+public:
+    // Build a BVH over the given primitive bounds.
+    // LBVH (Karras 2012): Morton codes -> LSD radix sort -> per-node hierarchy emit ->
+    // bottom-up bounds. Every stage is data-parallel; with a thread pool they run on its
+    // workers, otherwise (or for small inputs) they run on the calling thread.
+    // SAH: top-down binned surface area heuristic split, built on the calling thread.
+    void build(const eastl::vector<AABB>& bounds, ThreadPool* threadPool = nullptr,
+               BVHBuildMethod method = BVHBuildMethod::LBVH);
+
+    // Cache blobs: only topology is stored (12 bytes per node plus the leaf order); bounds are
+    // recomputed from the caller's primitive bounds on load. The key identifies those inputs.
+    static constexpr uint32_t CACHE_VERSION = 1;
+
+    // FNV-1a over the primitive bounds and build method. The tree is a pure function of
+    // these, so equal keys mean the cached topology is the one build() would produce.
+    static uint64_t computeCacheKey(const eastl::vector<AABB>& bounds, BVHBuildMethod method);
+
+    // Append the built tree to out, tagged with key (normally computeCacheKey of the build input)
+    void serialize(uint64_t key, eastl::vector<uint8_t>& out) const;
+
+    // Restore a tree written by serialize() for the same bounds. The blob may come straight
+    // from a mapped file: header, key, counts and topology are all validated, and node bounds
+    // are rebuilt from bounds, so a stale or corrupt blob is rejected (returns false and leaves
+    // the BVH empty) and a key collision can only cost tree quality, never correctness.
+    bool deserialize(const uint8_t* data, size_t size, uint64_t key, const eastl::vector<AABB>& bounds,
+                     BVHBuildMethod method, ThreadPool* threadPool = nullptr);
 
     // Get scene bounding box (computed during build)
     const AABB& getSceneBounds() const { return sceneBounds; }
 
+    // Refit: replace one primitive's bounds and propagate up to the root, stopping as soon as
+    // an ancestor's bounds no longer change. Topology is kept, so quality degrades as objects
+    // move; check needsRebuild() after a batch of refits.
+    void refit(uint32_t primitiveIndex, const AABB& bounds);
+
+    // Summed internal node surface area relative to the last full build (1.0 = as built)
+    float getRefitDegradation() const {
+        return builtAreaSum > 0.0 ? static_cast<float>(currentAreaSum / builtAreaSum) : 1.0f;
+    }
+    bool needsRebuild(float threshold = REFIT_REBUILD_THRESHOLD) const { return getRefitDegradation() > threshold; }
+
+    uint32_t getPrimitiveCount() const { return static_cast<uint32_t>(primitiveBounds.size()); }
+    const AABB& getPrimitiveBounds(uint32_t primitiveIndex) const { return primitiveBounds[primitiveIndex]; }
+
+    const BVHBuildStats& getBuildStats() const { return buildStats; }
+    const BVHQualityStats& getQualityStats() const { return qualityStats; }  // As of the last full build
+
+    // Depth-first traversal. intersectionTest(const AABB&) decides whether to descend;
+    // leafHandler(primitiveIndex) may return bool, where false stops the traversal early.
+    // The stack lives on the caller's frame, so no allocation happens per call.
     template<typename IntersectionTest, typename LeafHandler>
     void traverse(IntersectionTest&& intersectionTest, LeafHandler&& leafHandler) const {
         if (nodes.empty()) {
             return;
         }
 
-        eastl::vector<uint32_t> stack;
-        stack.reserve(64); // Reasonable depth assumption
-        stack.push_back(0);
+        BVHTraversalStack stack(binaryStackSize);
+        stack.push(0);
 
         while (!stack.empty()) {
-            uint32_t nodeIndex = stack.back();
-            stack.pop_back();
-
-            // Boundary check
-            if (nodeIndex >= nodes.size()) {
-                // This should help us catch the out of bounds error
-                continue;
-            }
+            uint32_t nodeIndex = stack.pop();
+            assert(nodeIndex < nodes.size() && "BVH node index out of range");
 
             const BVHNode& node = nodes[nodeIndex];
 
@@ -93,114 +234,501 @@ public:
 
             if (node.isLeaf()) {
                 for (uint32_t i = 0; i < node.count; ++i) {
-                    uint32_t leafIndex = node.firstChild + i;
-                    if (leafIndex < leafIndices.size()) {
-                        leafHandler(leafIndices[leafIndex]);
+                    assert(node.firstChild + i < leafIndices.size() && "BVH leaf index out of range");
+                    if (!invokeLeafHandler(leafHandler, leafIndices[node.firstChild + i])) {
+                        return;
                     }
                 }
             } else {
                 // Add children to stack (right first, so left is processed first)
-                if (node.rightChild < nodes.size()) {
-                    stack.push_back(node.rightChild);
+                stack.push(node.rightChild);
+                stack.push(node.firstChild);
+            }
+        }
+    }
+
+    // Same as traverse, but over the collapsed 4-wide tree. laneTest receives the SoA bounds
+    // of up to four children and returns a bit mask of the lanes to descend into
+    // (e.g. Frustum::testAABB4), which needs far fewer node visits than the binary tree.
+    template<typename LaneTest, typename LeafHandler>
+    void traverseWide(LaneTest&& laneTest, LeafHandler&& leafHandler) const {
+        if (wideNodes.empty()) {
+            return;
+        }
+
+        BVHTraversalStack stack(wideStackSize);
+        stack.push(0);
+
+        while (!stack.empty()) {
+            uint32_t nodeIndex = stack.pop();
+            assert(nodeIndex < wideNodes.size() && "Wide BVH node index out of range");
+
+            const BVH4Node& node = wideNodes[nodeIndex];
+
+            uint32_t mask = laneTest(node.bounds) & node.validMask;
+
+            // Push internal lanes in reverse so lane 0 is processed first
+            for (int lane = 3; lane >= 0; --lane) {
+                uint32_t bit = 1u << lane;
+                if (!(mask & bit)) {
+                    continue;
                 }
-                if (node.firstChild < nodes.size()) {
-                    stack.push_back(node.firstChild);
+                if (node.leafMask & bit) {
+                    for (uint32_t i = 0; i < node.counts[lane]; ++i) {
+                        if (!invokeLeafHandler(leafHandler, leafIndices[node.children[lane] + i])) {
+                            return;
+                        }
+                    }
+                } else {
+                    stack.push(node.children[lane]);
                 }
             }
         }
     }
 
-private:
-    eastl::vector<BVHNode> nodes;
-    eastl::vector<uint32_t> leafIndices;
-    AABB sceneBounds;  // Overall scene bounding box
-
-    // Morton code utility functions
-    inline uint32_t expandBits(uint32_t v) const {
-        v = (v * 0x00010001u) & 0xFF0000FFu;
-        v = (v * 0x00000101u) & 0x0F00F00Fu;
-        v = (v * 0x00000011u) & 0xC30C30C3u;
-        v = (v * 0x00000005u) & 0x49249249u;
-        return v;
+    // Frustum culling over the 4-wide tree with plane masking: planes that fully contain a node
+    // are not tested again in its subtree, and a subtree inside every plane is emitted wholesale.
+    // planeHints holds one entry per wide node with the plane that last rejected one of its
+    // children, which is tested first on the next call. It is owned by the caller so every view
+    // keeps its own coherence; it is resized after rebuilds. leafHandler follows traverse().
+    template<typename LeafHandler>
+    void cullFrustum(const Frustum& frustum, eastl::vector<uint8_t>& planeHints, LeafHandler&& leafHandler,
+                     BVHCullStats* stats = nullptr) const {
+        cullFrustumFiltered(frustum, planeHints, [](const AABB4&, uint32_t lanes) { return lanes; }, leafHandler,
+                            stats);
     }
 
-    inline uint64_t mortonCode3D(const glm::vec3& pos, const AABB& sceneBounds) const {
-        // Normalize position to [0, 1024) range
-        glm::vec3 normalized = (pos - sceneBounds.min) / sceneBounds.size();
-        normalized = glm::clamp(normalized, glm::vec3(0.0f), glm::vec3(1.0f));
+    // cullFrustum with a second test: laneFilter(const AABB4& bounds, uint32_t lanes) returns the
+    // lanes to keep among the children that passed the frustum (e.g. OcclusionCuller::testAABB4).
+    // A dropped lane skips its whole subtree, so the filter must hold for everything below it.
+    template<typename LaneFilter, typename LeafHandler>
+    void cullFrustumFiltered(const Frustum& frustum, eastl::vector<uint8_t>& planeHints, LaneFilter&& laneFilter,
+                             LeafHandler&& leafHandler, BVHCullStats* stats = nullptr) const {
+        if (wideNodes.empty()) {
+            return;
+        }
+        if (planeHints.size() != wideNodes.size()) {
+            planeHints.resize(wideNodes.size(), 0);
+        }
 
-        uint32_t x = static_cast<uint32_t>(normalized.x * 1023.0f);
-        uint32_t y = static_cast<uint32_t>(normalized.y * 1023.0f);
-        uint32_t z = static_cast<uint32_t>(normalized.z * 1023.0f);
+        // Entries are (node, active plane mask) pairs
+        BVHTraversalStack stack(wideStackSize * 2);
+        stack.push(0);
+        stack.push(Frustum::CULL_PLANE_MASK);
 
-        uint64_t xx = expandBits(x);
-        uint64_t yy = expandBits(y);
-        uint64_t zz = expandBits(z);
+        while (!stack.empty()) {
+            uint32_t planeMask = stack.pop();
+            uint32_t nodeIndex = stack.pop();
+            assert(nodeIndex < wideNodes.size() && "Wide BVH node index out of range");
+
+            const BVH4Node& node = wideNodes[nodeIndex];
+            uint32_t childMasks[4];
+            uint32_t hintPlane = planeHints[nodeIndex];
+            uint32_t mask = frustum.testAABB4Masked(node.bounds, node.validMask, planeMask, hintPlane, childMasks,
+                                                    stats ? &stats->planeTests : nullptr);
+            planeHints[nodeIndex] = static_cast<uint8_t>(hintPlane);
+            if (stats) {
+                ++stats->nodesVisited;
+            }
+            if (mask) {
+                mask = laneFilter(node.bounds, mask);
+            }
+
+            for (int lane = 3; lane >= 0; --lane) {
+                uint32_t bit = 1u << lane;
+                if (!(mask & bit)) {
+                    continue;
+                }
 
-        return (zz << 2) | (yy << 1) | xx;
+                uint32_t first = node.children[lane];
+                uint32_t count = node.counts[lane];
+                if (!(node.leafMask & bit)) {
+                    if (childMasks[lane] != 0) {
+                        stack.push(node.children[lane]);
+                        stack.push(childMasks[lane]);
+                        continue;
+                    }
+                    // Fully inside: the subtree's primitives are one contiguous run of leafIndices
+                    first = wideRanges[node.children[lane]].first;
+                    count = wideRanges[node.children[lane]].count;
+                    if (stats) {
+                        ++stats->subtreesAccepted;
+                    }
+                }
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (!invokeLeafHandler(leafHandler, leafIndices[first + i])) {
+                        return;
+                    }
+                }
+            }
+        }
     }
 
-    inline int longestCommonPrefix(uint64_t a, uint64_t b) const {
-        if (a == b) return 64; // All bits match
-        return __builtin_clzll(a ^ b); // Count leading zeros of XOR
+    // Views of one cullFrusta call, one bit each in its view masks
+    static constexpr uint32_t MAX_CULL_VIEWS = 32;
+
+    // Frustum culling of up to MAX_CULL_VIEWS views in one traversal (a camera with the shadow
+    // cascades and cube faces of its lights). Stacked nodes carry the views that still straddle
+    // them and the views that fully contain them: a node is visited once however many views see
+    // it, tested only against the straddling views, and dropped once no view is left. Unlike
+    // cullFrustum, a straddling view re-tests all of its planes. leafHandler(primitiveIndex,
+    // viewMask) is called once per primitive with the bits of the views (index into frusta)
+    // whose frustum it passed; each view's set equals what cullFrustum returns for it.
+    template<typename LeafHandler>
+    void cullFrusta(const Frustum* frusta, uint32_t viewCount, LeafHandler&& leafHandler,
+                    BVHCullStats* stats = nullptr) const {
+        assert(viewCount <= MAX_CULL_VIEWS && "Too many views for one BVH::cullFrusta");
+        if (wideNodes.empty() || viewCount == 0) {
+            return;
+        }
+
+        // Rejecting planes carry over between the nodes of one call
+        uint32_t hintPlanes[MAX_CULL_VIEWS] = {};
+
+        // Entries are (node, straddling views, containing views) triples
+        BVHTraversalStack stack(wideStackSize * 3);
+        stack.push(0);
+        stack.push(viewCount == MAX_CULL_VIEWS ? ~0u : (1u << viewCount) - 1);
+        stack.push(0);
+
+        while (!stack.empty()) {
+            uint32_t insideViews   = stack.pop();
+            uint32_t straddleViews = stack.pop();
+            uint32_t nodeIndex     = stack.pop();
+            assert(nodeIndex < wideNodes.size() && "Wide BVH node index out of range");
+
+            const BVH4Node& node = wideNodes[nodeIndex];
+            uint32_t laneStraddle[4] = {};
+            uint32_t laneInside[4]   = {insideViews, insideViews, insideViews, insideViews};
+            for (uint32_t views = straddleViews; views; views &= views - 1) {
+                uint32_t view = static_cast<uint32_t>(std::countr_zero(views));
+                uint32_t childMasks[4];
+                uint32_t mask = frusta[view].testAABB4Masked(node.bounds, node.validMask, Frustum::CULL_PLANE_MASK,
+                                                             hintPlanes[view], childMasks,
+                                                             stats ? &stats->planeTests : nullptr);
+                for (; mask; mask &= mask - 1) {
+                    uint32_t lane = static_cast<uint32_t>(std::countr_zero(mask));
+                    (childMasks[lane] ? laneStraddle : laneInside)[lane] |= 1u << view;
+                }
+            }
+            if (stats) {
+                ++stats->nodesVisited;
+            }
+
+            for (int lane = 3; lane >= 0; --lane) {
+                uint32_t bit   = 1u << lane;
+                uint32_t views = laneStraddle[lane] | laneInside[lane];
+                if (!(node.validMask & bit) || !views) {
+                    continue;
+                }
+
+                uint32_t first = node.children[lane];
+                uint32_t count = node.counts[lane];
+                if (!(node.leafMask & bit)) {
+                    if (laneStraddle[lane]) {
+                        stack.push(node.children[lane]);
+                        stack.push(laneStraddle[lane]);
+                        stack.push(laneInside[lane]);
+                        continue;
+                    }
+                    // Every view that sees the subtree contains it
+                    first = wideRanges[node.children[lane]].first;
+                    count = wideRanges[node.children[lane]].count;
+                    if (stats) {
+                        ++stats->subtreesAccepted;
+                    }
+                }
+                for (uint32_t i = 0; i < count; ++i) {
+                    leafHandler(leafIndices[first + i], views);
+                }
+            }
+        }
     }
 
-    void buildLinearBVH(const eastl::vector<MortonPrimitive>& sortedPrims) {
-        nodes.clear();
-        leafIndices.clear();
+    // Temporally coherent variant of cullFrustum returning the same set. Instead of walking
+    // down from the root, the previous cut is revisited: each lane's last outcome (outside,
+    // visible) stands while the frustum has moved less than that lane's distance to flipping,
+    // so only lanes near the frustum boundary and nodes changed by refit are re-tested, and
+    // visible lanes that now straddle a plane are refined. An unchanged frustum on an
+    // unchanged tree returns the last result without any tests. A full traversal runs on the
+    // first call, after rebuilds and every revalidateInterval coherent calls. Primitives that
+    // stayed visible come first in the returned list, which lives in state until the next call.
+    const eastl::vector<uint32_t>& cullFrustumCoherent(const Frustum& frustum, BVHCullCoherence& state,
+                                                       BVHCoherenceStats* stats = nullptr) const;
+
+    // Overlap queries against the primitive bounds. Indices of the primitives whose bounds
+    // overlap the volume are appended to results (unordered) until maxResults were appended;
+    // each returns the number appended. Nodes are tested four at a time on the wide tree.
+    uint32_t queryAABB(const AABB& box, eastl::vector<uint32_t>& results, uint32_t maxResults = ~0u) const;
+    uint32_t querySphere(const glm::vec3& center, float radius, eastl::vector<uint32_t>& results,
+                         uint32_t maxResults = ~0u) const;
+    uint32_t queryOBB(const OBB& box, eastl::vector<uint32_t>& results, uint32_t maxResults = ~0u) const;
+    uint32_t queryFrustum(const Frustum& frustum, eastl::vector<uint32_t>& results, uint32_t maxResults = ~0u) const;
+
+    // The k primitives whose bounds are nearest to point and no farther than maxDistance,
+    // appended to results nearest first (ties by primitive index). Subtrees farther than the
+    // current k-th candidate are pruned. Returns the number appended.
+    uint32_t queryNearest(const glm::vec3& point, uint32_t k, float maxDistance,
+                          eastl::vector<BVHNeighbor>& results) const;
+
+    // Pull-style traversal for callers that want to stop early or interleave work:
+    //   auto query = bvh.query([&](const AABB& b) { return ray.intersectAABB(b); });
+    //   for (uint32_t prim; query.next(prim);) { ... break on first hit ... }
+    template<typename IntersectionTest>
+    class Query {
+    public:
+        Query(const BVH& bvh, IntersectionTest test)
+            : bvh(bvh), intersectionTest(eastl::move(test)), stack(bvh.binaryStackSize) {
+            if (!bvh.nodes.empty()) {
+                stack.push(0);
+            }
+        }
 
-        if (sortedPrims.empty()) {
-            return;
+        Query(const Query&) = delete;
+        Query& operator=(const Query&) = delete;
+
+        // Produce the next primitive whose leaf passed the test; false when exhausted
+        bool next(uint32_t& primitiveIndex) {
+            while (true) {
+                if (leafCursor < leafEnd) {
+                    primitiveIndex = bvh.leafIndices[leafCursor++];
+                    return true;
+                }
+                if (stack.empty()) {
+                    return false;
+                }
+
+                const BVHNode& node = bvh.nodes[stack.pop()];
+                if (!intersectionTest(node.bounds)) {
+                    continue;
+                }
+                if (node.isLeaf()) {
+                    leafCursor = node.firstChild;
+                    leafEnd    = node.firstChild + node.count;
+                } else {
+                    stack.push(node.rightChild);
+                    stack.push(node.firstChild);
+                }
+            }
         }
 
-        // Reserve space for nodes (worst case: 2N-1 for N primitives)
-        nodes.reserve(sortedPrims.size() * 2);
+    private:
+        const BVH&        bvh;
+        IntersectionTest  intersectionTest;
+        BVHTraversalStack stack;
+        uint32_t          leafCursor = 0;
+        uint32_t          leafEnd    = 0;
+    };
+
+    template<typename IntersectionTest>
+    Query<eastl::decay_t<IntersectionTest>> query(IntersectionTest&& intersectionTest) const {
+        return Query<eastl::decay_t<IntersectionTest>>(*this, eastl::forward<IntersectionTest>(intersectionTest));
+    }
+
+    // Closest-hit ray query over the 4-wide tree. intersector(primitiveIndex, ray) tests one
+    // primitive and returns true on a hit after shrinking ray.tMax to the hit distance; lanes
+    // are visited nearest-first and anything beyond ray.tMax is culled. Returns whether any
+    // primitive was hit; ray.tMax then holds the closest distance.
+    template<typename PrimitiveIntersector>
+    bool intersectClosest(Ray& ray, PrimitiveIntersector&& intersector) const {
+        return intersectRay<false>(ray, intersector);
+    }
 
-        // Build recursively using Morton-sorted primitives
-        buildRecursive(sortedPrims, 0, static_cast<uint32_t>(sortedPrims.size()));
+    // Any-hit (occlusion) query: stops at the first primitive the intersector reports as hit
+    template<typename PrimitiveIntersector>
+    bool intersectAny(Ray& ray, PrimitiveIntersector&& intersector) const {
+        return intersectRay<true>(ray, intersector);
     }
 
-    uint32_t buildRecursive(const eastl::vector<MortonPrimitive>& sortedPrims, uint32_t start, uint32_t end) {
-        uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
-        nodes.push_back(BVHNode());
-        BVHNode& node = nodes[nodeIndex];
+    // Interleave up to 21 bits per axis into a 63-bit Morton code (x in bit 0, y in bit 1, z in bit 2)
+    static inline uint64_t mortonEncode(uint32_t x, uint32_t y, uint32_t z) {
+#if defined(__BMI2__)
+        return _pdep_u64(x, 0x1249249249249249ull) | _pdep_u64(y, 0x2492492492492492ull) |
+               _pdep_u64(z, 0x4924924924924924ull);
+#else
+        return expandBits(x) | (expandBits(y) << 1) | (expandBits(z) << 2);
+#endif
+    }
 
-        // Compute bounding box for this range
-        node.bounds = AABB();
-        for (uint32_t i = start; i < end; ++i) {
-            node.bounds.expand(sortedPrims[i].bounds);
+    uint32_t getWideNodeCount() const { return static_cast<uint32_t>(wideNodes.size()); }
+
+    // Minimum primitive count before the build is distributed across the thread pool
+    static constexpr uint32_t PARALLEL_BUILD_THRESHOLD = 4096;
+
+    // SAH builder parameters
+    static constexpr uint32_t SAH_BIN_COUNT      = 16;
+    static constexpr uint32_t SAH_MAX_LEAF_SIZE  = 4;
+    static constexpr float    SAH_TRAVERSAL_COST = 1.0f;
+    static constexpr float    SAH_INTERSECT_COST = 1.0f;
+
+    // Default degradation ratio past which refitting is abandoned for a full rebuild
+    static constexpr float REFIT_REBUILD_THRESHOLD = 1.5f;
+
+    static constexpr uint32_t INVALID_NODE = ~0u;
+
+private:
+    eastl::vector<BVHNode> nodes;
+    eastl::vector<uint32_t> leafIndices;
+    AABB sceneBounds;  // Overall scene bounding box
+    BVHBuildStats buildStats;
+    BVHQualityStats qualityStats;
+
+    // Refit support
+    eastl::vector<AABB> primitiveBounds;      // Copy of the input bounds, updated by refit
+    eastl::vector<uint32_t> parentIndices;    // Per node, INVALID_NODE for the root
+    eastl::vector<uint32_t> primitiveLeaves;  // Primitive index -> leaf node index
+    double builtAreaSum = 0.0;
+    double currentAreaSum = 0.0;
+
+    // Collapsed 4-wide tree; wideSlots maps a binary node to (wideNode << 2 | lane), or
+    // INVALID_NODE for binary nodes folded into their parent, so refit can patch lanes in place
+    eastl::vector<BVH4Node> wideNodes;
+    eastl::vector<uint32_t> wideSlots;
+
+    // Every subtree covers a contiguous run of leafIndices (both builders partition in place);
+    // per wide node this is the run under it, used to emit fully visible subtrees directly
+    struct LeafRange {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+    eastl::vector<LeafRange> wideRanges;
+
+    // Worst-case traversal stack depths, derived from the tree depth at build time
+    uint32_t binaryStackSize = 1;
+    uint32_t wideStackSize = 1;
+
+    // Bumped by every build/load and every refit, so per-view caches can tell the tree changed
+    uint32_t topologyVersion = 0;
+    uint32_t boundsVersion   = 0;
+    eastl::vector<uint32_t> wideVersions;  // Per wide node, boundsVersion when its lanes last changed
+
+    void computeMortonCodes(const eastl::vector<AABB>& bounds, eastl::vector<uint64_t>& codes,
+                            eastl::vector<uint32_t>& indices, ThreadPool* pool);
+    void buildLinearBVH(const eastl::vector<AABB>& bounds, const eastl::vector<uint64_t>& sortedCodes,
+                        const eastl::vector<uint32_t>& sortedIndices, ThreadPool* pool);
+    void buildSAH(const eastl::vector<AABB>& bounds);
+    uint32_t buildSAHRecursive(const eastl::vector<AABB>& bounds, const eastl::vector<glm::vec3>& centroids,
+                               uint32_t begin, uint32_t end);
+    template<typename LaneTest, typename PrimitiveTest>
+    uint32_t queryOverlap(LaneTest&& laneTest, PrimitiveTest&& primitiveTest, eastl::vector<uint32_t>& results,
+                          uint32_t maxResults) const;
+    void resetBuildState();
+    void cullCoherentSubtree(const Frustum& frustum, uint32_t rootNode, uint32_t planeMask, float inheritedMargin,
+                             BVHCullCoherence& state, eastl::vector<uint32_t>& visible, BVHCoherenceStats& stats) const;
+    void emitWideLane(const BVH4Node& node, uint32_t lane, eastl::vector<uint32_t>& visible) const;
+    void computeQualityStats();
+    void buildRefitData(ThreadPool* pool);
+
+    // Leaf handlers may return void (visit everything) or bool (false stops the traversal)
+    template<typename LeafHandler>
+    static bool invokeLeafHandler(LeafHandler& leafHandler, uint32_t primitiveIndex) {
+        if constexpr (eastl::is_same_v<decltype(leafHandler(primitiveIndex)), bool>) {
+            return leafHandler(primitiveIndex);
+        } else {
+            leafHandler(primitiveIndex);
+            return true;
+        }
+    }
+    template<bool AnyHit, typename PrimitiveIntersector>
+    bool intersectRay(Ray& ray, PrimitiveIntersector& intersector) const {
+        if (wideNodes.empty()) {
+            return false;
         }
 
-        uint32_t count = end - start;
+        bool hit = false;
+        BVHTraversalStack stack(wideStackSize);
+        stack.push(0);
 
-        // Create leaf if small enough
-        if (count <= 1) {
-            node.firstChild = static_cast<uint32_t>(leafIndices.size());
-            node.count = count;
+        while (!stack.empty()) {
+            const BVH4Node& node = wideNodes[stack.pop()];
 
-            for (uint32_t i = start; i < end; ++i) {
-                leafIndices.push_back(sortedPrims[i].primitiveIndex);
+            // Lanes are re-tested against the current tMax, so stale stack entries cost one node test
+            alignas(16) float tNear[4];
+            uint32_t mask = ray.intersectAABB4(node.bounds, tNear) & node.validMask;
+            if (!mask) {
+                continue;
             }
 
-            return nodeIndex;
-        }
+            // Order hit lanes nearest-first
+            uint32_t order[4];
+            uint32_t laneCount = 0;
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                if (!(mask & (1u << lane))) {
+                    continue;
+                }
+                uint32_t slot = laneCount++;
+                while (slot > 0 && tNear[order[slot - 1]] > tNear[lane]) {
+                    order[slot] = order[slot - 1];
+                    --slot;
+                }
+                order[slot] = lane;
+            }
 
-        // Find split point - simple midpoint for now
-        uint32_t mid = start + count / 2;
+            // Leaves first, nearest-first, so tMax shrinks before internal lanes are pushed
+            for (uint32_t i = 0; i < laneCount; ++i) {
+                uint32_t lane = order[i];
+                if (!(node.leafMask & (1u << lane)) || tNear[lane] > ray.tMax) {
+                    continue;
+                }
+                for (uint32_t p = 0; p < node.counts[lane]; ++p) {
+                    if (intersector(leafIndices[node.children[lane] + p], ray)) {
+                        hit = true;
+                        if constexpr (AnyHit) {
+                            return true;
+                        }
+                    }
+                }
+            }
 
-        // Build children
-        uint32_t leftChild = buildRecursive(sortedPrims, start, mid);
-        uint32_t rightChild = buildRecursive(sortedPrims, mid, end);
+            // Push internal lanes farthest-first so the nearest is popped next
+            for (uint32_t i = laneCount; i-- > 0;) {
+                uint32_t lane = order[i];
+                if (!(node.leafMask & (1u << lane)) && tNear[lane] <= ray.tMax) {
+                    stack.push(node.children[lane]);
+                }
+            }
+        }
+        return hit;
+    }
 
-        // Set up internal node
-        node.firstChild = leftChild;
-        node.rightChild = rightChild;
-        node.count = 0; // Internal node
+    void buildWideBVH();
+    void updateWideSlot(uint32_t nodeIndex) {
+        uint32_t slot = wideSlots[nodeIndex];
+        if (slot != INVALID_NODE) {
+            wideNodes[slot >> 2].bounds.setLane(slot & 3, nodes[nodeIndex].bounds);
+            wideVersions[slot >> 2] = boundsVersion;
+        }
+    }
 
-        return nodeIndex;
+    // Morton code utility functions
+    // Spread the low 21 bits of v so there are two zero bits between each (magic-number fallback)
+    static inline uint64_t expandBits(uint64_t v) {
+        v &= 0x1FFFFFull;
+        v = (v | v << 32) & 0x1F00000000FFFFull;
+        v = (v | v << 16) & 0x1F0000FF0000FFull;
+        v = (v | v << 8) & 0x100F00F00F00F00Full;
+        v = (v | v << 4) & 0x10C30C30C30C30C3ull;
+        v = (v | v << 2) & 0x1249249249249249ull;
+        return v;
     }
 
+    static inline uint64_t mortonCode3D(const glm::vec3& pos, const glm::vec3& sceneMin, const glm::vec3& invSceneSize,
+                                        float gridScale) {
+        // Normalize position to [0, 2^bitsPerAxis) range
+        glm::vec3 normalized = (pos - sceneMin) * invSceneSize;
+        normalized = glm::clamp(normalized, glm::vec3(0.0f), glm::vec3(1.0f));
+
+        uint32_t x = static_cast<uint32_t>(normalized.x * gridScale);
+        uint32_t y = static_cast<uint32_t>(normalized.y * gridScale);
+        uint32_t z = static_cast<uint32_t>(normalized.z * gridScale);
+
+        return mortonEncode(x, y, z);
+    }
 
+    // Code width bounds: 10 bits per axis is plenty for compact scenes and keeps the radix sort
+    // at four passes; 21 bits per axis (63-bit codes) resolves small objects in huge, sparse worlds
+    static constexpr uint32_t MIN_MORTON_BITS_PER_AXIS = 10;
+    static constexpr uint32_t MAX_MORTON_BITS_PER_AXIS = 21;
 };
 
-} // namespace violet
\ No newline at end of file
+} // namespace violet
@@ -0,0 +1,190 @@
+#include "FrustumCuller.hpp"
+
+#include <bit>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+// Compiled for AVX2 regardless of the global flags and only entered after a CPU check
+#define VIOLET_AVX2_KERNEL 1
+#define VIOLET_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#define VIOLET_AVX2_KERNEL 1
+#define VIOLET_TARGET_AVX2
+#endif
+
+namespace violet {
+
+namespace {
+
+// Planes in the form the kernels consume: coefficients plus which corner is the positive vertex
+struct CullPlane {
+    float a, b, c, d;
+    bool  useMaxX, useMaxY, useMaxZ;
+};
+
+struct CullPlanes {
+    CullPlane planes[Frustum::CULL_PLANE_COUNT];
+
+    explicit CullPlanes(const Frustum& frustum) {
+        for (uint32_t i = 0; i < Frustum::CULL_PLANE_COUNT; ++i) {
+            const glm::vec4& plane = frustum.planes[i];
+            planes[i] = {plane.x, plane.y, plane.z, plane.w, plane.x > 0, plane.y > 0, plane.z > 0};
+        }
+    }
+};
+
+// Tail and fallback path: exactly Frustum::testAABB
+uint32_t cullScalar(const Frustum& frustum, const AABBSoA& bounds, uint32_t begin, uint32_t* out) {
+    uint32_t written = 0;
+    for (uint32_t i = begin; i < bounds.size(); ++i) {
+        AABB box(glm::vec3(bounds.minX[i], bounds.minY[i], bounds.minZ[i]),
+                 glm::vec3(bounds.maxX[i], bounds.maxY[i], bounds.maxZ[i]));
+        if (frustum.testAABB(box)) {
+            out[written++] = i;
+        }
+    }
+    return written;
+}
+
+#if defined(VIOLET_SIMD_SSE)
+uint32_t cullSSE2(const CullPlanes& cullPlanes, const AABBSoA& bounds, uint32_t& end, uint32_t* out) {
+    const uint32_t count = bounds.size() & ~3u;
+    uint32_t written = 0;
+
+    for (uint32_t i = 0; i < count; i += 4) {
+        const __m128 minX = _mm_loadu_ps(&bounds.minX[i]);
+        const __m128 minY = _mm_loadu_ps(&bounds.minY[i]);
+        const __m128 minZ = _mm_loadu_ps(&bounds.minZ[i]);
+        const __m128 maxX = _mm_loadu_ps(&bounds.maxX[i]);
+        const __m128 maxY = _mm_loadu_ps(&bounds.maxY[i]);
+        const __m128 maxZ = _mm_loadu_ps(&bounds.maxZ[i]);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const CullPlane& plane : cullPlanes.planes) {
+            // Same evaluation order as glm::dot(normal, p) + d so results match the scalar test
+            __m128 distance = _mm_add_ps(_mm_mul_ps(plane.useMaxX ? maxX : minX, _mm_set1_ps(plane.a)),
+                                         _mm_mul_ps(plane.useMaxY ? maxY : minY, _mm_set1_ps(plane.b)));
+            distance = _mm_add_ps(distance, _mm_mul_ps(plane.useMaxZ ? maxZ : minZ, _mm_set1_ps(plane.c)));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.d));
+            inside   = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+        }
+
+        // Compact the passing lanes into the output
+        for (uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(inside)); mask; mask &= mask - 1) {
+            out[written++] = i + static_cast<uint32_t>(std::countr_zero(mask));
+        }
+    }
+    end = count;
+    return written;
+}
+#endif
+
+#if defined(VIOLET_AVX2_KERNEL)
+VIOLET_TARGET_AVX2
+uint32_t cullAVX2(const CullPlanes& cullPlanes, const AABBSoA& bounds, uint32_t& end, uint32_t* out) {
+    const uint32_t count = bounds.size() & ~7u;
+    uint32_t written = 0;
+
+    for (uint32_t i = 0; i < count; i += 8) {
+        const __m256 minX = _mm256_loadu_ps(&bounds.minX[i]);
+        const __m256 minY = _mm256_loadu_ps(&bounds.minY[i]);
+        const __m256 minZ = _mm256_loadu_ps(&bounds.minZ[i]);
+        const __m256 maxX = _mm256_loadu_ps(&bounds.maxX[i]);
+        const __m256 maxY = _mm256_loadu_ps(&bounds.maxY[i]);
+        const __m256 maxZ = _mm256_loadu_ps(&bounds.maxZ[i]);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const CullPlane& plane : cullPlanes.planes) {
+            // No FMA: keep the scalar rounding so every kernel returns the same set
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(plane.useMaxX ? maxX : minX, _mm256_set1_ps(plane.a)),
+                                            _mm256_mul_ps(plane.useMaxY ? maxY : minY, _mm256_set1_ps(plane.b)));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(plane.useMaxZ ? maxZ : minZ, _mm256_set1_ps(plane.c)));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.d));
+            inside   = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        for (uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(inside)); mask; mask &= mask - 1) {
+            out[written++] = i + static_cast<uint32_t>(std::countr_zero(mask));
+        }
+    }
+    end = count;
+    return written;
+}
+
+bool cpuSupportsAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;  // OS does not save the YMM state
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+} // namespace
+
+CullKernel FrustumCuller::getBestKernel() {
+    static const CullKernel best = [] {
+#if defined(VIOLET_AVX2_KERNEL)
+        if (cpuSupportsAVX2()) {
+            return CullKernel::AVX2;
+        }
+#endif
+#if defined(VIOLET_SIMD_SSE)
+        return CullKernel::SSE2;
+#else
+        return CullKernel::Scalar;
+#endif
+    }();
+    return best;
+}
+
+uint32_t FrustumCuller::cull(const Frustum& frustum, const AABBSoA& bounds, eastl::vector<uint32_t>& visible) {
+    return cull(frustum, bounds, visible, getBestKernel());
+}
+
+uint32_t FrustumCuller::cull(const Frustum& frustum, const AABBSoA& bounds, eastl::vector<uint32_t>& visible,
+                             CullKernel kernel) {
+    // Write straight into the output with room for every box, then trim to what passed
+    const uint32_t base = static_cast<uint32_t>(visible.size());
+    visible.resize(base + bounds.size());
+    uint32_t* out = visible.data() + base;
+
+    // Vector kernels handle whole groups; the scalar path finishes the remainder
+    uint32_t written = 0;
+    uint32_t end     = 0;
+    bool     done    = false;
+
+#if defined(VIOLET_AVX2_KERNEL)
+    if (kernel == CullKernel::AVX2 && getBestKernel() == CullKernel::AVX2) {
+        written = cullAVX2(CullPlanes(frustum), bounds, end, out);
+        done    = true;
+    }
+#endif
+#if defined(VIOLET_SIMD_SSE)
+    if (!done && kernel != CullKernel::Scalar) {
+        written = cullSSE2(CullPlanes(frustum), bounds, end, out);
+        done    = true;
+    }
+#endif
+    (void)done;
+
+    written += cullScalar(frustum, bounds, end, out + written);
+    visible.resize(base + written);
+    return written;
+}
+
+} // namespace violet
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <EASTL/vector.h>
+#include <cstdint>
+
+#include "math/AABB.hpp"
+#include "math/Frustum.hpp"
+
+namespace violet {
+
+// Bounds in SoA layout for the brute-force culling kernel. Index i is the caller's object
+// index (e.g. a renderable), so results can be used without remapping.
+struct AABBSoA {
+    eastl::vector<float> minX, minY, minZ;
+    eastl::vector<float> maxX, maxY, maxZ;
+
+    uint32_t size() const { return static_cast<uint32_t>(minX.size()); }
+
+    void resize(uint32_t count) {
+        minX.resize(count);
+        minY.resize(count);
+        minZ.resize(count);
+        maxX.resize(count);
+        maxY.resize(count);
+        maxZ.resize(count);
+    }
+
+    void set(uint32_t index, const AABB& box) {
+        minX[index] = box.min.x;
+        minY[index] = box.min.y;
+        minZ[index] = box.min.z;
+        maxX[index] = box.max.x;
+        maxY[index] = box.max.y;
+        maxZ[index] = box.max.z;
+    }
+
+    void assign(const eastl::vector<AABB>& boxes) {
+        resize(static_cast<uint32_t>(boxes.size()));
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            set(i, boxes[i]);
+        }
+    }
+};
+
+enum class CullKernel {
+    Scalar,
+    SSE2,  // 4 boxes per iteration
+    AVX2   // 8 boxes per iteration
+};
+
+// Brute-force frustum culling over SoA bounds. Cost is linear in the object count but with
+// no hierarchy to maintain, so it suits small or highly dynamic sets and serves as the
+// reference for BVH culling. Results match Frustum::testAABB exactly.
+class FrustumCuller {
+public:
+    // Append the indices of all boxes passing Frustum::testAABB to visible, in ascending
+    // order, using the widest kernel the CPU supports. Returns the number appended.
+    static uint32_t cull(const Frustum& frustum, const AABBSoA& bounds, eastl::vector<uint32_t>& visible);
+
+    // Same with an explicit kernel; kernels the CPU or build lacks fall back to the next narrower one
+    static uint32_t cull(const Frustum& frustum, const AABBSoA& bounds, eastl::vector<uint32_t>& visible,
+                         CullKernel kernel);
+
+    // Widest kernel available on this CPU (detected once)
+    static CullKernel getBestKernel();
+};
+
+} // namespace violet
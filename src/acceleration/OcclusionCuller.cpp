@@ -0,0 +1,340 @@
+#include "OcclusionCuller.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <EASTL/algorithm.h>
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace violet {
+
+namespace {
+
+// Occluder vertices nearer than this in w are treated as crossing the near plane
+constexpr float MIN_OCCLUDER_W = 1e-3f;
+
+// Screen coordinates beyond this many screen sizes lose too much precision in the edge
+// functions; such triangles are dropped rather than risk over-occluding
+constexpr float GUARD_BAND = 16.0f;
+
+// Relative slack in the depth comparison so surfaces coplanar with an occluder stay visible
+constexpr float DEPTH_EPSILON = 1e-4f;
+
+// Edge function E(x, y) = a * x + b * y + c, positive inside a counter-clockwise triangle
+struct Edge {
+    float a, b, c;
+
+    Edge(const glm::vec3& from, const glm::vec3& to) {
+        a = from.y - to.y;
+        b = to.x - from.x;
+        c = -(a * from.x + b * from.y);
+    }
+};
+
+} // anonymous namespace
+
+OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height) {
+    resize(width, height);
+}
+
+void OcclusionCuller::resize(uint32_t newWidth, uint32_t newHeight) {
+    tilesX = eastl::max(1u, (newWidth + TILE_SIZE - 1) / TILE_SIZE);
+    tilesY = eastl::max(1u, (newHeight + TILE_SIZE - 1) / TILE_SIZE);
+    width  = tilesX * TILE_SIZE;
+    height = tilesY * TILE_SIZE;
+
+    for (uint32_t level = 0; level < LEVEL_COUNT; ++level) {
+        levels[level].assign(static_cast<size_t>(width >> level) * (height >> level), 0.0f);
+    }
+    tileBins.resize(tilesX * tilesY);
+}
+
+void OcclusionCuller::begin(const glm::mat4& newViewProj) {
+    viewProj = newViewProj;
+    triangles.clear();
+    stats = OcclusionStats{};
+}
+
+void OcclusionCuller::addOccluder(const glm::vec3* positions, uint32_t positionCount, const uint32_t* indices,
+                                  uint32_t indexCount, const glm::mat4& model) {
+    const glm::mat4 modelViewProj = viewProj * model;
+
+    clipScratch.resize(positionCount);
+    for (uint32_t i = 0; i < positionCount; ++i) {
+        clipScratch[i] = modelViewProj * glm::vec4(positions[i], 1.0f);
+    }
+
+    const float halfWidth  = 0.5f * static_cast<float>(width);
+    const float halfHeight = 0.5f * static_cast<float>(height);
+    const float guardX     = GUARD_BAND * static_cast<float>(width);
+    const float guardY     = GUARD_BAND * static_cast<float>(height);
+
+    for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+        if (indices[i] >= positionCount || indices[i + 1] >= positionCount || indices[i + 2] >= positionCount) {
+            ++stats.rejectedTriangles;
+            continue;
+        }
+        const glm::vec4* clip[3] = {&clipScratch[indices[i]], &clipScratch[indices[i + 1]], &clipScratch[indices[i + 2]]};
+
+        // All three vertices outside the same side plane: nothing to draw
+        bool outside = false;
+        for (int axis = 0; axis < 2 && !outside; ++axis) {
+            outside = ((*clip[0])[axis] > clip[0]->w && (*clip[1])[axis] > clip[1]->w && (*clip[2])[axis] > clip[2]->w) ||
+                      ((*clip[0])[axis] < -clip[0]->w && (*clip[1])[axis] < -clip[1]->w && (*clip[2])[axis] < -clip[2]->w);
+        }
+        if (outside || clip[0]->w < MIN_OCCLUDER_W || clip[1]->w < MIN_OCCLUDER_W || clip[2]->w < MIN_OCCLUDER_W) {
+            ++stats.rejectedTriangles;
+            continue;
+        }
+
+        ScreenTriangle triangle;
+        bool inGuardBand = true;
+        for (int k = 0; k < 3; ++k) {
+            const float invW = 1.0f / clip[k]->w;
+            triangle.v[k]    = glm::vec3((clip[k]->x * invW + 1.0f) * halfWidth, (clip[k]->y * invW + 1.0f) * halfHeight, invW);
+            inGuardBand &= std::abs(triangle.v[k].x) < guardX && std::abs(triangle.v[k].y) < guardY;
+        }
+
+        // Orient counter-clockwise so every edge function is positive inside
+        const float area = (triangle.v[1].x - triangle.v[0].x) * (triangle.v[2].y - triangle.v[0].y) -
+                           (triangle.v[1].y - triangle.v[0].y) * (triangle.v[2].x - triangle.v[0].x);
+        if (!inGuardBand || std::abs(area) < 1e-6f) {
+            ++stats.rejectedTriangles;
+            continue;
+        }
+        if (area < 0.0f) {
+            eastl::swap(triangle.v[1], triangle.v[2]);
+        }
+
+        triangles.push_back(triangle);
+        ++stats.occluderTriangles;
+    }
+}
+
+void OcclusionCuller::addOccluderBox(const AABB& box, const glm::mat4& model) {
+    const glm::vec3 corners[8] = {
+        {box.min.x, box.min.y, box.min.z}, {box.max.x, box.min.y, box.min.z},
+        {box.min.x, box.max.y, box.min.z}, {box.max.x, box.max.y, box.min.z},
+        {box.min.x, box.min.y, box.max.z}, {box.max.x, box.min.y, box.max.z},
+        {box.min.x, box.max.y, box.max.z}, {box.max.x, box.max.y, box.max.z},
+    };
+    static constexpr uint32_t FACES[36] = {
+        0, 2, 1, 1, 2, 3,  // -z
+        4, 5, 6, 5, 7, 6,  // +z
+        0, 1, 4, 1, 5, 4,  // -y
+        2, 6, 3, 3, 6, 7,  // +y
+        0, 4, 2, 2, 4, 6,  // -x
+        1, 3, 5, 3, 7, 5,  // +x
+    };
+    addOccluder(corners, 8, FACES, 36, model);
+}
+
+void OcclusionCuller::rasterize(ThreadPool* threadPool) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Bin every triangle into the tiles its screen bounds overlap
+    for (auto& bin : tileBins) {
+        bin.clear();
+    }
+    for (uint32_t t = 0; t < triangles.size(); ++t) {
+        const ScreenTriangle& triangle = triangles[t];
+        const float minX = eastl::min(triangle.v[0].x, eastl::min(triangle.v[1].x, triangle.v[2].x));
+        const float maxX = eastl::max(triangle.v[0].x, eastl::max(triangle.v[1].x, triangle.v[2].x));
+        const float minY = eastl::min(triangle.v[0].y, eastl::min(triangle.v[1].y, triangle.v[2].y));
+        const float maxY = eastl::max(triangle.v[0].y, eastl::max(triangle.v[1].y, triangle.v[2].y));
+        if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(width) || minY >= static_cast<float>(height)) {
+            continue;
+        }
+
+        const uint32_t tx0 = static_cast<uint32_t>(eastl::max(minX, 0.0f)) / TILE_SIZE;
+        const uint32_t ty0 = static_cast<uint32_t>(eastl::max(minY, 0.0f)) / TILE_SIZE;
+        const uint32_t tx1 = eastl::min(static_cast<uint32_t>(maxX) / TILE_SIZE, tilesX - 1);
+        const uint32_t ty1 = eastl::min(static_cast<uint32_t>(maxY) / TILE_SIZE, tilesY - 1);
+        for (uint32_t ty = ty0; ty <= ty1; ++ty) {
+            for (uint32_t tx = tx0; tx <= tx1; ++tx) {
+                tileBins[ty * tilesX + tx].push_back(t);
+            }
+        }
+    }
+
+    // Tiles write disjoint pixels and pyramid blocks, so they need no synchronization
+    const uint32_t tileCount = tilesX * tilesY;
+    auto processTiles = [this](uint32_t begin, uint32_t end) {
+        for (uint32_t tile = begin; tile < end; ++tile) {
+            rasterizeTile(tile);
+            buildTileLevels(tile);
+        }
+    };
+    if (threadPool && threadPool->getThreadCount() > 0 && !triangles.empty()) {
+        threadPool->parallelFor(tileCount, 1, processTiles);
+    } else {
+        processTiles(0, tileCount);
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    stats.rasterTimeMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+}
+
+void OcclusionCuller::rasterizeTile(uint32_t tileIndex) {
+    const uint32_t tileX0 = (tileIndex % tilesX) * TILE_SIZE;
+    const uint32_t tileY0 = (tileIndex / tilesX) * TILE_SIZE;
+    float*         depth  = levels[0].data();
+
+    for (uint32_t y = tileY0; y < tileY0 + TILE_SIZE; ++y) {
+        eastl::fill(depth + y * width + tileX0, depth + y * width + tileX0 + TILE_SIZE, 0.0f);
+    }
+
+    for (uint32_t t : tileBins[tileIndex]) {
+        const ScreenTriangle& triangle = triangles[t];
+        const glm::vec3& v0 = triangle.v[0];
+        const glm::vec3& v1 = triangle.v[1];
+        const glm::vec3& v2 = triangle.v[2];
+
+        // e0 is opposite v0 and so on; ei / area is the barycentric weight of vi
+        const Edge  e0(v1, v2), e1(v2, v0), e2(v0, v1);
+        const float invArea = 1.0f / (e2.a * v2.x + e2.b * v2.y + e2.c);
+
+        // 1/w is affine in screen space: z(x, y) = za * x + zb * y + zc
+        const float za = (e0.a * v0.z + e1.a * v1.z + e2.a * v2.z) * invArea;
+        const float zb = (e0.b * v0.z + e1.b * v1.z + e2.b * v2.z) * invArea;
+        const float zc = (e0.c * v0.z + e1.c * v1.z + e2.c * v2.z) * invArea;
+
+        // Pixel centers inside the triangle's bounds, clamped to the tile; x starts on a 4-pixel group
+        const float minX = eastl::min(v0.x, eastl::min(v1.x, v2.x));
+        const float maxX = eastl::max(v0.x, eastl::max(v1.x, v2.x));
+        const float minY = eastl::min(v0.y, eastl::min(v1.y, v2.y));
+        const float maxY = eastl::max(v0.y, eastl::max(v1.y, v2.y));
+
+        const int32_t x0 = eastl::max<int32_t>(static_cast<int32_t>(tileX0), static_cast<int32_t>(std::floor(minX - 0.5f))) & ~3;
+        const int32_t x1 = eastl::min<int32_t>(static_cast<int32_t>(tileX0 + TILE_SIZE) - 1, static_cast<int32_t>(std::ceil(maxX - 0.5f)));
+        const int32_t y0 = eastl::max<int32_t>(static_cast<int32_t>(tileY0), static_cast<int32_t>(std::floor(minY - 0.5f)));
+        const int32_t y1 = eastl::min<int32_t>(static_cast<int32_t>(tileY0 + TILE_SIZE) - 1, static_cast<int32_t>(std::ceil(maxY - 0.5f)));
+
+        for (int32_t y = y0; y <= y1; ++y) {
+            const float py   = static_cast<float>(y) + 0.5f;
+            const float row0 = e0.b * py + e0.c;
+            const float row1 = e1.b * py + e1.c;
+            const float row2 = e2.b * py + e2.c;
+            const float rowZ = zb * py + zc;
+            float*      out  = depth + static_cast<size_t>(y) * width;
+
+            for (int32_t x = x0; x <= x1; x += 4) {
+#if defined(VIOLET_SIMD_SSE)
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+                const __m128 w0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e0.a), px), _mm_set1_ps(row0));
+                const __m128 w1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e1.a), px), _mm_set1_ps(row1));
+                const __m128 w2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e2.a), px), _mm_set1_ps(row2));
+                const __m128 inside = _mm_and_ps(_mm_cmpge_ps(w0, _mm_setzero_ps()),
+                                                 _mm_and_ps(_mm_cmpge_ps(w1, _mm_setzero_ps()),
+                                                            _mm_cmpge_ps(w2, _mm_setzero_ps())));
+                if (_mm_movemask_ps(inside) == 0) {
+                    continue;
+                }
+
+                // Keep the nearest (largest 1/w) where covered
+                const __m128 z       = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(za), px), _mm_set1_ps(rowZ));
+                const __m128 current = _mm_loadu_ps(out + x);
+                const __m128 nearest = _mm_max_ps(current, z);
+                _mm_storeu_ps(out + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+#else
+                for (int32_t lane = 0; lane < 4; ++lane) {
+                    const float px = static_cast<float>(x + lane) + 0.5f;
+                    if (e0.a * px + row0 >= 0.0f && e1.a * px + row1 >= 0.0f && e2.a * px + row2 >= 0.0f) {
+                        out[x + lane] = eastl::max(out[x + lane], za * px + rowZ);
+                    }
+                }
+#endif
+            }
+        }
+    }
+}
+
+void OcclusionCuller::buildTileLevels(uint32_t tileIndex) {
+    const uint32_t tileX0 = (tileIndex % tilesX) * TILE_SIZE;
+    const uint32_t tileY0 = (tileIndex / tilesX) * TILE_SIZE;
+
+    // Each level keeps the farthest depth of its four children, so a block occludes a box only
+    // if every pixel under it does
+    for (uint32_t level = 1; level < LEVEL_COUNT; ++level) {
+        const uint32_t srcWidth = width >> (level - 1);
+        const uint32_t dstWidth = width >> level;
+        const float*   src      = levels[level - 1].data();
+        float*         dst      = levels[level].data();
+
+        const uint32_t blockX0 = tileX0 >> level;
+        const uint32_t blockY0 = tileY0 >> level;
+        const uint32_t blocks  = TILE_SIZE >> level;
+        for (uint32_t by = blockY0; by < blockY0 + blocks; ++by) {
+            for (uint32_t bx = blockX0; bx < blockX0 + blocks; ++bx) {
+                const float* top    = src + (by * 2) * srcWidth + bx * 2;
+                const float* bottom = top + srcWidth;
+                dst[by * dstWidth + bx] = eastl::min(eastl::min(top[0], top[1]), eastl::min(bottom[0], bottom[1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::testAABB(const AABB& box) const {
+    float minX = std::numeric_limits<float>::max(), maxX = std::numeric_limits<float>::lowest();
+    float minY = std::numeric_limits<float>::max(), maxY = std::numeric_limits<float>::lowest();
+    float nearest = 0.0f;  // Largest 1/w over the corners
+
+    for (int i = 0; i < 8; ++i) {
+        const glm::vec3 corner(i & 1 ? box.max.x : box.min.x, i & 2 ? box.max.y : box.min.y, i & 4 ? box.max.z : box.min.z);
+        const glm::vec4 clip = viewProj * glm::vec4(corner, 1.0f);
+        if (clip.w <= MIN_OCCLUDER_W) {
+            return true;  // Reaches behind the camera: the projection is unbounded
+        }
+
+        const float invW = 1.0f / clip.w;
+        const float x    = (clip.x * invW + 1.0f) * 0.5f * static_cast<float>(width);
+        const float y    = (clip.y * invW + 1.0f) * 0.5f * static_cast<float>(height);
+        minX    = eastl::min(minX, x);
+        maxX    = eastl::max(maxX, x);
+        minY    = eastl::min(minY, y);
+        maxY    = eastl::max(maxY, y);
+        nearest = eastl::max(nearest, invW);
+    }
+
+    if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(width) || minY >= static_cast<float>(height)) {
+        return true;  // Off screen: leave it to the frustum test
+    }
+
+    // Every pixel the rectangle touches, not just covered pixel centers
+    const int32_t px0 = eastl::max(0, static_cast<int32_t>(std::floor(minX)));
+    const int32_t py0 = eastl::max(0, static_cast<int32_t>(std::floor(minY)));
+    const int32_t px1 = eastl::min(static_cast<int32_t>(width) - 1, static_cast<int32_t>(std::floor(maxX)));
+    const int32_t py1 = eastl::min(static_cast<int32_t>(height) - 1, static_cast<int32_t>(std::floor(maxY)));
+
+    // Coarsest level at which the rectangle still spans no more than about four blocks per axis
+    const uint32_t span  = static_cast<uint32_t>(eastl::max(px1 - px0, py1 - py0) + 1);
+    uint32_t       level = 0;
+    while (level + 1 < LEVEL_COUNT && (span >> level) > 4) {
+        ++level;
+    }
+
+    const float*   blocks     = levels[level].data();
+    const uint32_t levelWidth = width >> level;
+    const float    threshold  = nearest * (1.0f + DEPTH_EPSILON);
+    for (int32_t by = py0 >> level; by <= (py1 >> level); ++by) {
+        for (int32_t bx = px0 >> level; bx <= (px1 >> level); ++bx) {
+            if (blocks[by * levelWidth + bx] <= threshold) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+uint32_t OcclusionCuller::testAABB4(const AABB4& boxes, uint32_t laneMask) const {
+    uint32_t visible = 0;
+    for (uint32_t lane = 0; lane < 4; ++lane) {
+        if ((laneMask & (1u << lane)) && testAABB(boxes.getLane(lane))) {
+            visible |= 1u << lane;
+        }
+    }
+    return visible;
+}
+
+} // namespace violet
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <EASTL/vector.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+
+#include "math/AABB.hpp"
+#include "math/AABB4.hpp"
+
+namespace violet {
+
+class ThreadPool;
+
+// Statistics of the last rasterize()
+struct OcclusionStats {
+    uint32_t occluderTriangles = 0;  // Triangles rasterized
+    uint32_t rejectedTriangles = 0;  // Dropped at setup: crossing the near plane, off screen or degenerate
+    float    rasterTimeMs      = 0.0f;
+};
+
+// Software occlusion culling against a small CPU depth buffer. Occluder triangles are binned
+// into screen tiles and rasterized four pixels at a time (SSE when available), one task per
+// tile; each tile then reduces its depth into a hierarchical-Z pyramid. Boxes are tested at the
+// pyramid level where their screen rectangle spans only a few texels.
+//
+// Depth is stored as 1/w (clip-space w, i.e. view depth for perspective projections), which is
+// linear in screen space and independent of the projection's depth range convention. Empty
+// pixels hold 0 (infinitely far); larger values are nearer.
+//
+// Tests are conservative with respect to the rasterized occluders: a box is reported hidden
+// only if every pyramid texel it touches is covered by a nearer occluder. Occluders themselves
+// are sampled at pixel centers, so submit only geometry that is actually solid (real triangles,
+// or boxes known to be filled), never bounding volumes of arbitrary meshes.
+class OcclusionCuller {
+public:
+    static constexpr uint32_t DEFAULT_WIDTH  = 256;
+    static constexpr uint32_t DEFAULT_HEIGHT = 128;
+    static constexpr uint32_t TILE_SIZE      = 32;  // Pixels per tile side; one raster task per tile
+    static constexpr uint32_t LEVEL_COUNT    = 6;   // Pyramid levels: 1x1 up to TILE_SIZE pixel blocks
+
+    explicit OcclusionCuller(uint32_t width = DEFAULT_WIDTH, uint32_t height = DEFAULT_HEIGHT);
+
+    // Dimensions are rounded up to whole tiles
+    void resize(uint32_t width, uint32_t height);
+    uint32_t getWidth() const { return width; }
+    uint32_t getHeight() const { return height; }
+
+    // Start a frame: drop queued occluders and set the view-projection used by occluders and tests
+    void begin(const glm::mat4& viewProj);
+
+    // Queue occluder triangles: object-space positions and a triangle list, placed by model.
+    // Triangles crossing the near plane are dropped (never clipped), which only loses occlusion.
+    void addOccluder(const glm::vec3* positions, uint32_t positionCount, const uint32_t* indices, uint32_t indexCount,
+                     const glm::mat4& model);
+
+    // Queue a solid box (walls, floors, crates modelled as boxes)
+    void addOccluderBox(const AABB& box, const glm::mat4& model = glm::mat4(1.0f));
+
+    // Rasterize the queued occluders and build the pyramid; tiles run on the pool when given
+    void rasterize(ThreadPool* threadPool = nullptr);
+
+    // False only when the box is certainly hidden; boxes reaching behind the camera are visible
+    bool testAABB(const AABB& box) const;
+
+    // The lanes of laneMask whose boxes are not hidden (lane filter for BVH::cullFrustumFiltered)
+    uint32_t testAABB4(const AABB4& boxes, uint32_t laneMask) const;
+
+    const OcclusionStats& getStats() const { return stats; }
+
+    // Full-resolution 1/w depth, row-major, for debug views and tests
+    const eastl::vector<float>& getDepth() const { return levels[0]; }
+
+private:
+    // Screen-space vertex: pixel coordinates and 1/w
+    struct ScreenTriangle {
+        glm::vec3 v[3];
+    };
+
+    void rasterizeTile(uint32_t tileIndex);
+    void buildTileLevels(uint32_t tileIndex);
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t tilesX = 0;
+    uint32_t tilesY = 0;
+
+    glm::mat4 viewProj{1.0f};
+    eastl::vector<ScreenTriangle> triangles;
+    eastl::vector<eastl::vector<uint32_t>> tileBins;  // Triangle indices overlapping each tile
+    eastl::vector<glm::vec4> clipScratch;             // Per-vertex clip positions of the occluder being added
+
+    // levels[k] holds, per 2^k x 2^k pixel block, the farthest (smallest) 1/w in it
+    eastl::vector<float> levels[LEVEL_COUNT];
+
+    OcclusionStats stats;
+};
+
+} // namespace violet
@@ -3,17 +3,19 @@
 #include "core/Exception.hpp"
 #include "resource/Mesh.hpp"
 #include "resource/ResourceManager.hpp"
+#include "core/ThreadPool.hpp"
 
 #include <EASTL/shared_ptr.h>
 #include <tiny_gltf.h>
 #include <EASTL/algorithm.h>
+#include <chrono>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/matrix_decompose.hpp>
 
 namespace violet {
 
-eastl::unique_ptr<GLTFAsset> AssetLoader::loadGLTF(const eastl::string& filePath) {
+eastl::unique_ptr<GLTFAsset> AssetLoader::loadGLTF(const eastl::string& filePath, ThreadPool* threadPool) {
     tinygltf::Model gltfModel;
     tinygltf::TinyGLTF loader;
     std::string err;
@@ -47,6 +49,7 @@ eastl::unique_ptr<GLTFAsset> AssetLoader::loadGLTF(const eastl::string& filePath
     loadTextures(&gltfModel, asset.get());
     loadMaterials(&gltfModel, asset.get());
     loadMeshes(&gltfModel, asset.get());
+    buildMeshGeometry(asset.get(), threadPool);
     loadNodes(&gltfModel, asset.get());
 
     return asset;
@@ -62,10 +65,10 @@ void AssetLoader::loadGLTFAsync(
     auto errorMsg = eastl::make_shared<eastl::string>();
 
     auto task = eastl::make_shared<AsyncLoadTask>(
-        // CPU work: file IO + parsing (runs on worker thread)
-        [filePath, assetPtr, errorMsg]() {
+        // CPU work: file IO + parsing + triangle BVH builds (runs on worker thread)
+        [filePath, assetPtr, errorMsg, threadPool = resourceManager->getThreadPool()]() {
             try {
-                *assetPtr = loadGLTF(filePath);
+                *assetPtr = loadGLTF(filePath, threadPool);
             } catch (const Exception& e) {
                 *errorMsg = e.what_c_str();
             } catch (const std::exception& e) {
@@ -227,6 +230,46 @@ void AssetLoader::loadMeshes(void* modelPtr, GLTFAsset* asset) {
     }
 }
 
+void AssetLoader::buildMeshGeometry(GLTFAsset* asset, ThreadPool* threadPool) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    auto buildRange = [asset](uint32_t begin, uint32_t end) {
+        for (uint32_t meshIdx = begin; meshIdx < end; ++meshIdx) {
+            GLTFAsset::MeshData& meshData = asset->meshes[meshIdx];
+
+            // Keep a position-only copy for CPU ray queries, shared by every instance of this mesh
+            auto geometry = eastl::make_shared<MeshGeometry>();
+            geometry->positions.reserve(meshData.vertices.size());
+            for (const auto& vertex : meshData.vertices) {
+                geometry->positions.push_back(vertex.pos);
+            }
+            geometry->indices = meshData.indices;
+
+            // Object-space triangle BVH per submesh, built once and reused by every instance
+            geometry->subMeshes.reserve(meshData.submeshes.size());
+            for (const auto& subMesh : meshData.submeshes) {
+                geometry->addSubMesh(subMesh.firstIndex, subMesh.indexCount);
+            }
+            meshData.geometry = eastl::move(geometry);
+        }
+    };
+
+    const uint32_t meshCount = static_cast<uint32_t>(asset->meshes.size());
+    if (threadPool && threadPool->getThreadCount() > 0) {
+        threadPool->parallelFor(meshCount, 1, buildRange);
+    } else {
+        buildRange(0, meshCount);
+    }
+
+    uint64_t triangleCount = 0;
+    for (const auto& meshData : asset->meshes) {
+        triangleCount += meshData.indices.size() / 3;
+    }
+    float buildTimeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+    violet::Log::info("AssetLoader", "Built triangle BVHs for {} meshes ({} triangles) in {:.2f}ms",
+                      meshCount, triangleCount, buildTimeMs);
+}
+
 void AssetLoader::loadTextures(void* modelPtr, GLTFAsset* asset) {
     const tinygltf::Model* model = static_cast<const tinygltf::Model*>(modelPtr);
     asset->textures.resize(model->textures.size());
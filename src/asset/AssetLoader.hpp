@@ -8,12 +8,14 @@
 namespace violet {
 
 class ResourceManager;
+class ThreadPool;
 
 // Asset loader for glTF files (no Vulkan dependencies)
 class AssetLoader {
 public:
-    // Load glTF file and parse into intermediate representation (synchronous)
-    static eastl::unique_ptr<GLTFAsset> loadGLTF(const eastl::string& filePath);
+    // Load glTF file and parse into intermediate representation (synchronous).
+    // Per-mesh triangle BVHs are built across the thread pool when one is given.
+    static eastl::unique_ptr<GLTFAsset> loadGLTF(const eastl::string& filePath, ThreadPool* threadPool = nullptr);
 
     // Async version: loads on worker thread, calls callback on main thread
     static void loadGLTFAsync(
@@ -28,6 +30,7 @@ private:
     static void loadTextures(void* model, GLTFAsset* asset);
     static void loadMaterials(void* model, GLTFAsset* asset);
     static void loadNodes(void* model, GLTFAsset* asset);
+    static void buildMeshGeometry(GLTFAsset* asset, ThreadPool* threadPool);
     static Transform extractTransform(const void* nodePtr);
 };
 
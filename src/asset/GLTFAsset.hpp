@@ -2,10 +2,12 @@
 
 #include <EASTL/vector.h>
 #include <EASTL/string.h>
+#include <EASTL/shared_ptr.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
 #include "resource/Vertex.hpp"
+#include "resource/MeshGeometry.hpp"
 #include "ecs/Components.hpp"
 
 namespace violet {
@@ -19,6 +21,7 @@ struct GLTFAsset {
         eastl::vector<Vertex> vertices;
         eastl::vector<uint32_t> indices;
         eastl::vector<SubMesh> submeshes;
+        eastl::shared_ptr<MeshGeometry> geometry;  // Positions + indices kept on the CPU for ray queries
     };
 
     // Texture data
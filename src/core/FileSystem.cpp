@@ -1,5 +1,6 @@
 #include "FileSystem.hpp"
 #include "Log.hpp"
+#include <EASTL/sort.h>
 #include <filesystem>
 #include <fstream>
 
@@ -12,6 +13,12 @@
 #include <unistd.h>
 #endif
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace violet {
 
 namespace fs = std::filesystem;
@@ -46,6 +53,86 @@ eastl::vector<uint8_t> FileSystem::readBinary(const eastl::string& path) {
     return buffer;
 }
 
+bool FileSystem::writeBinary(const eastl::string& path, const void* data, size_t size) {
+    eastl::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            violet::Log::error("Core", "Failed to open file for writing: {}", tempPath.c_str());
+            return false;
+        }
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        if (!file.good()) {
+            violet::Log::error("Core", "Failed to write file: {}", tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    fs::rename(tempPath.c_str(), path.c_str(), error);
+    if (error) {
+        violet::Log::error("Core", "Failed to replace {}: {}", path.c_str(), error.message());
+        fs::remove(tempPath.c_str(), error);
+        return false;
+    }
+    return true;
+}
+
+bool FileSystem::createDirectories(const eastl::string& path) {
+    std::error_code error;
+    fs::create_directories(path.c_str(), error);
+    return !error && fs::is_directory(path.c_str());
+}
+
+bool FileSystem::remove(const eastl::string& path) {
+    std::error_code error;
+    return fs::remove(path.c_str(), error) && !error;
+}
+
+void FileSystem::touch(const eastl::string& path) {
+    std::error_code error;
+    fs::last_write_time(path.c_str(), fs::file_time_type::clock::now(), error);
+}
+
+void FileSystem::trimDirectory(const eastl::string& path, const eastl::string& extension, uint64_t maxBytes) {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type writeTime;
+        uint64_t size;
+    };
+    eastl::vector<Entry> entries;
+    uint64_t totalSize = 0;
+
+    std::error_code error;
+    for (fs::directory_iterator it(path.c_str(), error), end; !error && it != end; it.increment(error)) {
+        std::error_code entryError;
+        if (!it->is_regular_file(entryError) || it->path().extension().string() != extension.c_str()) {
+            continue;
+        }
+        const uint64_t size = it->file_size(entryError);
+        const auto writeTime = it->last_write_time(entryError);
+        if (!entryError) {
+            entries.push_back({it->path(), writeTime, size});
+            totalSize += size;
+        }
+    }
+    if (totalSize <= maxBytes) {
+        return;
+    }
+
+    eastl::sort(entries.begin(), entries.end(),
+                [](const Entry& a, const Entry& b) { return a.writeTime < b.writeTime; });
+    for (const Entry& entry : entries) {
+        if (totalSize <= maxBytes) {
+            break;
+        }
+        std::error_code removeError;
+        if (fs::remove(entry.path, removeError)) {
+            totalSize -= entry.size;
+        }
+    }
+}
+
 eastl::string FileSystem::readText(const eastl::string& path) {
     std::ifstream file(path.c_str());
     
@@ -202,4 +289,64 @@ eastl::string FileSystem::resolveRelativePath(const eastl::string& relativePath)
     return resolved.string().c_str();
 }
 
+MappedFile::MappedFile(const eastl::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return;
+    }
+    fileHandle    = file;
+    mappingHandle = mapping;
+    mappedData    = static_cast<const uint8_t*>(view);
+    mappedSize    = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        return;
+    }
+    mappedData = static_cast<const uint8_t*>(view);
+    mappedSize = static_cast<size_t>(info.st_size);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if (!mappedData) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mappedData);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+#else
+    munmap(const_cast<uint8_t*>(mappedData), mappedSize);
+#endif
+}
+
 }
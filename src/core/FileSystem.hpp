@@ -13,6 +13,16 @@ public:
     
     static eastl::vector<uint8_t> readBinary(const eastl::string& path);
     static eastl::string readText(const eastl::string& path);
+
+    // Write via a temporary file and rename, so readers never see a partial file
+    static bool writeBinary(const eastl::string& path, const void* data, size_t size);
+    static bool createDirectories(const eastl::string& path);
+    static bool remove(const eastl::string& path);
+
+    // Mark a file as recently used, for trimDirectory's eviction order
+    static void touch(const eastl::string& path);
+    // Delete the least recently modified files with the extension until the rest fit in maxBytes
+    static void trimDirectory(const eastl::string& path, const eastl::string& extension, uint64_t maxBytes);
     
     static eastl::vector<eastl::string> listDirectory(const eastl::string& path, bool recursive = false);
     static eastl::vector<eastl::string> listFiles(const eastl::string& path, const eastl::string& extension = "", bool recursive = false);
@@ -28,4 +38,27 @@ public:
     static eastl::string resolveRelativePath(const eastl::string& relativePath);
 };
 
+// Read-only memory mapping of a whole file. Invalid (empty) if the file is missing or empty.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const eastl::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isValid() const { return mappedData != nullptr; }
+    const uint8_t* data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+
+private:
+    const uint8_t* mappedData = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
 }
@@ -1,6 +1,8 @@
 #include "ThreadPool.hpp"
 #include "Log.hpp"
 
+#include <EASTL/shared_ptr.h>
+
 namespace violet {
 
 ThreadPool::ThreadPool(size_t numThreads) {
@@ -85,6 +87,67 @@ void ThreadPool::waitForAll() {
     });
 }
 
+void ThreadPool::parallelFor(uint32_t count, uint32_t minChunkSize, const eastl::function<void(uint32_t, uint32_t)>& func) {
+    if (count == 0) {
+        return;
+    }
+
+    minChunkSize = eastl::max(minChunkSize, 1u);
+
+    // Oversubscribe a little so uneven chunks balance out across workers
+    uint32_t maxChunks  = static_cast<uint32_t>(workers.size() + 1) * 4;
+    uint32_t chunkCount = eastl::min(maxChunks, (count + minChunkSize - 1) / minChunkSize);
+    if (chunkCount <= 1 || workers.empty()) {
+        func(0, count);
+        return;
+    }
+
+    uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    chunkCount         = (count + chunkSize - 1) / chunkSize;
+
+    // Shared state outlives this call: helper tasks that start after all chunks were
+    // claimed only touch the counters and never dereference func
+    struct ParallelForState {
+        std::atomic<uint32_t>   nextChunk{0};
+        std::atomic<uint32_t>   completedChunks{0};
+        std::mutex              mutex;
+        std::condition_variable done;
+    };
+    auto state = eastl::make_shared<ParallelForState>();
+
+    const auto* body      = &func;
+    auto        runChunks = [state, body, count, chunkSize, chunkCount]() {
+        uint32_t chunk;
+        while ((chunk = state->nextChunk.fetch_add(1)) < chunkCount) {
+            uint32_t begin = chunk * chunkSize;
+            uint32_t end   = eastl::min(begin + chunkSize, count);
+
+            try {
+                (*body)(begin, end);
+            } catch (const std::exception& e) {
+                Log::error("ThreadPool", "parallelFor chunk failed: {}", e.what());
+            } catch (...) {
+                Log::error("ThreadPool", "parallelFor chunk failed with unknown exception");
+            }
+
+            if (state->completedChunks.fetch_add(1) + 1 == chunkCount) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done.notify_all();
+            }
+        }
+    };
+
+    uint32_t helperCount = eastl::min(static_cast<uint32_t>(workers.size()), chunkCount - 1);
+    for (uint32_t i = 0; i < helperCount; ++i) {
+        submit(runChunks);
+    }
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state, chunkCount] { return state->completedChunks.load() == chunkCount; });
+}
+
 size_t ThreadPool::getPendingTaskCount() const {
     std::unique_lock<std::mutex> lock(queueMutex);
     return tasks.size() + activeTasks.load();
@@ -11,7 +11,7 @@
 
 namespace violet {
 
-// Simple thread pool for async asset loading
+// Simple thread pool for async asset loading and data-parallel work
 // Uses EASTL containers with standard synchronization primitives
 class ThreadPool {
 public:
@@ -27,6 +27,11 @@ public:
     // Wait for all tasks to complete
     void waitForAll();
 
+    // Split [0, count) into chunks of at least minChunkSize and run func(begin, end) on the
+    // workers. The calling thread also executes chunks, so this is safe to call while the
+    // pool is busy with long-running tasks (e.g. async asset loads). Blocks until all chunks finish.
+    void parallelFor(uint32_t count, uint32_t minChunkSize, const eastl::function<void(uint32_t, uint32_t)>& func);
+
     // Get number of worker threads
     size_t getThreadCount() const { return workers.size(); }
 
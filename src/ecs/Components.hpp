@@ -42,12 +42,19 @@ struct Transform {
 };
 
 struct TransformComponent {
-    Transform local;        // Local transform relative to parent
-    Transform world;        // World transform (computed from hierarchy)
-    bool      dirty = true; // Whether world transform needs recomputation
+    Transform local;              // Local transform relative to parent
+    Transform world;              // World transform (computed from hierarchy)
+    glm::mat4 worldMatrix{1.0f};  // World matrix (computed from hierarchy), exact where world TRS is not
+    bool      dirty = true;       // Whether world transform needs recomputation
 
     TransformComponent() = default;
     TransformComponent(const Transform& localTransform) : local(localTransform) {}
+
+    // For entities outside a scene hierarchy, which nothing else computes the world transform for
+    void setWorld(const Transform& worldTransform) {
+        world       = worldTransform;
+        worldMatrix = worldTransform.getMatrix();
+    }
 };
 
 struct MeshComponent {
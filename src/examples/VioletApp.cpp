@@ -97,7 +97,7 @@ void VioletApp::createResources() {
                     // Update world bounds for all MeshComponents after world transforms are computed
                     auto view = world.getRegistry().view<TransformComponent, MeshComponent>();
                     for (auto&& [entity, transformComp, meshComp] : view.each()) {
-                        meshComp.updateWorldBounds(transformComp.world.getMatrix());
+                        meshComp.updateWorldBounds(transformComp.worldMatrix);
                     }
 
                     // Give SceneDebugLayer access to the scene for proper hierarchy handling
@@ -156,7 +156,7 @@ void VioletApp::initializeScene() {
     auto lightEntity = world.getRegistry().create();
     TransformComponent lightTransform;
     lightTransform.local.position = glm::vec3(0.0f, 100.0f, 0.0f);
-    lightTransform.world = lightTransform.local;
+    lightTransform.setWorld(lightTransform.local);
     lightTransform.dirty = false;
     world.getRegistry().emplace<TransformComponent>(lightEntity, lightTransform);
 
@@ -183,7 +183,9 @@ void VioletApp::update(float deltaTime) {
     }
 
     if (currentScene) {
-        currentScene->updateWorldTransforms(world.getRegistry());
+        currentScene->updateWorldTransforms(world.getRegistry(), resourceManager.getThreadPool());
+        renderer.markTransformsChanged(currentScene->getChangedEntities());
+        currentScene->clearChangedEntities();
     }
 }
 
@@ -224,7 +226,7 @@ void VioletApp::loadAsset(const eastl::string& path) {
                     // Update world bounds for all MeshComponents
                     auto view = world.getRegistry().view<TransformComponent, MeshComponent>();
                     for (auto&& [entity, transformComp, meshComp] : view.each()) {
-                        meshComp.updateWorldBounds(transformComp.world.getMatrix());
+                        meshComp.updateWorldBounds(transformComp.worldMatrix);
                     }
 
                     sceneDebug->setScene(currentScene.get());
@@ -233,7 +235,7 @@ void VioletApp::loadAsset(const eastl::string& path) {
                     auto lightEntity = world.getRegistry().create();
                     TransformComponent lightTransform;
                     lightTransform.local.position = glm::vec3(0.0f, 100.0f, 0.0f);
-                    lightTransform.world = lightTransform.local;
+                    lightTransform.setWorld(lightTransform.local);
                     lightTransform.dirty = false;
                     world.getRegistry().emplace<TransformComponent>(lightEntity, lightTransform);
 
@@ -286,11 +288,10 @@ void VioletApp::loadAssetAtPosition(const eastl::string& path, const glm::vec3&
 
                     // Apply position offset to the parent node (which groups the entire model)
                     auto& registry = world.getRegistry();
-                    const auto& rootNodeIds = tempScene->getRootNodes();
 
                     // For imported models with a parent node, we only need to move the parent
-                    if (rootNodeIds.size() == 1) {
-                        uint32_t rootNodeId = rootNodeIds[0];
+                    if (tempScene->getRootNodeCount() == 1) {
+                        uint32_t rootNodeId = tempScene->getFirstRootNode();
                         const Node* node = tempScene->getNode(rootNodeId);
 
                         // Check if this is a parent node (no entity) or a mesh node
@@ -304,7 +305,7 @@ void VioletApp::loadAssetAtPosition(const eastl::string& path, const glm::vec3&
                                 world.addComponent<TransformComponent>(parentEntity, parentTransform);
 
                                 // Update the node to reference this entity
-                                const_cast<Node*>(node)->entity = parentEntity;
+                                tempScene->setNodeEntity(rootNodeId, parentEntity);
 
                                 violet::Log::info("App", "Applied position to parent node '{}'", node->name.c_str());
                             } else if (registry.valid(node->entity)) {
@@ -312,19 +313,19 @@ void VioletApp::loadAssetAtPosition(const eastl::string& path, const glm::vec3&
                                 auto* transformComp = registry.try_get<TransformComponent>(node->entity);
                                 if (transformComp) {
                                     transformComp->local.setPosition(transformComp->local.position + position);
-                                    transformComp->dirty = true;
+                                    tempScene->markTransformDirty(registry, node->entity);
                                 }
                             }
                         }
                     } else {
                         // Multiple root nodes - apply to each
-                        for (uint32_t rootNodeId : rootNodeIds) {
-                            const Node* node = tempScene->getNode(rootNodeId);
-                            if (node && registry.valid(node->entity)) {
+                        for (const Node* node = tempScene->getNode(tempScene->getFirstRootNode()); node;
+                             node = tempScene->getNode(node->nextSiblingId)) {
+                            if (registry.valid(node->entity)) {
                                 auto* transformComp = registry.try_get<TransformComponent>(node->entity);
                                 if (transformComp) {
                                     transformComp->local.setPosition(transformComp->local.position + position);
-                                    transformComp->dirty = true;
+                                    tempScene->markTransformDirty(registry, node->entity);
                                 }
                             }
                         }
@@ -341,7 +342,7 @@ void VioletApp::loadAssetAtPosition(const eastl::string& path, const glm::vec3&
                         // Update world bounds for all MeshComponents
                         auto view = world.getRegistry().view<TransformComponent, MeshComponent>();
                         for (auto&& [entity, transformComp, meshComp] : view.each()) {
-                            meshComp.updateWorldBounds(transformComp.world.getMatrix());
+                            meshComp.updateWorldBounds(transformComp.worldMatrix);
                         }
 
                         // Mark scene dirty for BVH rebuild
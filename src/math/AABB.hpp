@@ -54,6 +54,18 @@ struct AABB {
 
     bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
 
+    // Touching boxes overlap
+    [[nodiscard]] bool overlaps(const AABB& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    // Squared distance from point to the box, 0 inside
+    [[nodiscard]] float distanceSquared(const glm::vec3& point) const {
+        glm::vec3 d = glm::max(glm::max(min - point, point - max), glm::vec3(0.0f));
+        return glm::dot(d, d);
+    }
+
 
     void reset() {
         min = glm::vec3(std::numeric_limits<float>::max());
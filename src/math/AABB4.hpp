@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <limits>
+#include "math/AABB.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VIOLET_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace violet {
+
+// Four AABBs in SoA layout so one SIMD register holds the same component of every box.
+// Unused lanes are stored inverted (min > max) and must be masked out by the caller.
+struct alignas(16) AABB4 {
+    float minX[4], minY[4], minZ[4];
+    float maxX[4], maxY[4], maxZ[4];
+
+    void setLane(uint32_t lane, const AABB& box) {
+        minX[lane] = box.min.x;
+        minY[lane] = box.min.y;
+        minZ[lane] = box.min.z;
+        maxX[lane] = box.max.x;
+        maxY[lane] = box.max.y;
+        maxZ[lane] = box.max.z;
+    }
+
+    [[nodiscard]] AABB getLane(uint32_t lane) const {
+        return AABB(glm::vec3(minX[lane], minY[lane], minZ[lane]), glm::vec3(maxX[lane], maxY[lane], maxZ[lane]));
+    }
+
+    void clearLane(uint32_t lane) { setLane(lane, AABB()); }
+
+    void clear() {
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            clearLane(lane);
+        }
+    }
+};
+
+} // namespace violet
@@ -2,7 +2,9 @@
 
 #include <glm/glm.hpp>
 #include <EASTL/array.h>
+#include <bit>
 #include "math/AABB.hpp"
+#include "math/AABB4.hpp"
 #include "core/Log.hpp"
 
 namespace violet {
@@ -10,6 +12,10 @@ namespace violet {
 struct Frustum {
     eastl::array<glm::vec4, 6> planes; // left, right, bottom, top, near, far
 
+    // Planes used for culling (the far plane is skipped) and the mask covering all of them
+    static constexpr uint32_t CULL_PLANE_COUNT = 5;
+    static constexpr uint32_t CULL_PLANE_MASK  = (1u << CULL_PLANE_COUNT) - 1;
+
     void extract(const glm::mat4& viewProj) {
         // Extract frustum planes from view-projection matrix
         // Planes are in world space, pointing inward
@@ -91,6 +97,118 @@ struct Frustum {
         return true;
     }
 
+    // Test four boxes at once; bit i of the result is set when lane i passes testAABB.
+    // Inverted (empty) lanes always fail.
+    uint32_t testAABB4(const AABB4& boxes) const {
+#if defined(VIOLET_SIMD_SSE)
+        const __m128 minX = _mm_load_ps(boxes.minX);
+        const __m128 minY = _mm_load_ps(boxes.minY);
+        const __m128 minZ = _mm_load_ps(boxes.minZ);
+        const __m128 maxX = _mm_load_ps(boxes.maxX);
+        const __m128 maxY = _mm_load_ps(boxes.maxY);
+        const __m128 maxZ = _mm_load_ps(boxes.maxZ);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int i = 0; i < 5; i++) {
+            const auto& plane = planes[i];
+            // Positive vertex selection is per plane, so it picks whole registers
+            __m128 px = plane.x > 0 ? maxX : minX;
+            __m128 py = plane.y > 0 ? maxY : minY;
+            __m128 pz = plane.z > 0 ? maxZ : minZ;
+
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(plane.x)), _mm_mul_ps(py, _mm_set1_ps(plane.y))),
+                _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+        }
+        return static_cast<uint32_t>(_mm_movemask_ps(inside));
+#else
+        uint32_t mask = 0;
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            AABB box = boxes.getLane(lane);
+            if (box.isValid() && testAABB(box)) {
+                mask |= 1u << lane;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    // Plane-masked four-box test for hierarchical culling. Only planes in planeMask are tested,
+    // starting at hintPlane, and testing stops once every lane in laneMask is rejected.
+    // Returns the lanes of laneMask that are not outside; childMasks[lane] receives the planes
+    // that lane still straddles (0 = fully inside the frustum). hintPlane is updated to the
+    // plane that rejected a lane, if any. planeTests, when given, counts box/plane tests.
+    uint32_t testAABB4Masked(const AABB4& boxes, uint32_t laneMask, uint32_t planeMask, uint32_t& hintPlane,
+                             uint32_t childMasks[4], uint32_t* planeTests = nullptr) const {
+        childMasks[0] = childMasks[1] = childMasks[2] = childMasks[3] = 0;
+
+#if defined(VIOLET_SIMD_SSE)
+        const __m128 minX = _mm_load_ps(boxes.minX);
+        const __m128 minY = _mm_load_ps(boxes.minY);
+        const __m128 minZ = _mm_load_ps(boxes.minZ);
+        const __m128 maxX = _mm_load_ps(boxes.maxX);
+        const __m128 maxY = _mm_load_ps(boxes.maxY);
+        const __m128 maxZ = _mm_load_ps(boxes.maxZ);
+#endif
+
+        uint32_t outside = 0;
+        uint32_t startPlane = hintPlane < CULL_PLANE_COUNT ? hintPlane : 0;
+        for (uint32_t step = 0; step < CULL_PLANE_COUNT; ++step) {
+            uint32_t i = (startPlane + step) % CULL_PLANE_COUNT;
+            if (!(planeMask & (1u << i))) {
+                continue;
+            }
+            if (planeTests) {
+                *planeTests += static_cast<uint32_t>(std::popcount(laneMask & ~outside));
+            }
+
+            const auto& plane = planes[i];
+            uint32_t outsideBits;
+            uint32_t straddleBits;
+#if defined(VIOLET_SIMD_SSE)
+            // Positive vertex decides "outside", negative vertex decides "fully inside"
+            __m128 px = plane.x > 0 ? maxX : minX, nx = plane.x > 0 ? minX : maxX;
+            __m128 py = plane.y > 0 ? maxY : minY, ny = plane.y > 0 ? minY : maxY;
+            __m128 pz = plane.z > 0 ? maxZ : minZ, nz = plane.z > 0 ? minZ : maxZ;
+            const __m128 a = _mm_set1_ps(plane.x), b = _mm_set1_ps(plane.y), c = _mm_set1_ps(plane.z);
+            const __m128 d = _mm_set1_ps(plane.w);
+
+            __m128 pDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, a), _mm_mul_ps(py, b)), _mm_add_ps(_mm_mul_ps(pz, c), d));
+            __m128 nDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, a), _mm_mul_ps(ny, b)), _mm_add_ps(_mm_mul_ps(nz, c), d));
+            outsideBits  = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(pDistance, _mm_setzero_ps())));
+            straddleBits = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(nDistance, _mm_setzero_ps())));
+#else
+            outsideBits  = 0;
+            straddleBits = 0;
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                AABB box = boxes.getLane(lane);
+                glm::vec3 p(plane.x > 0 ? box.max.x : box.min.x, plane.y > 0 ? box.max.y : box.min.y,
+                            plane.z > 0 ? box.max.z : box.min.z);
+                glm::vec3 n(plane.x > 0 ? box.min.x : box.max.x, plane.y > 0 ? box.min.y : box.max.y,
+                            plane.z > 0 ? box.min.z : box.max.z);
+                outsideBits  |= (glm::dot(glm::vec3(plane), p) + plane.w < 0 ? 1u : 0u) << lane;
+                straddleBits |= (glm::dot(glm::vec3(plane), n) + plane.w < 0 ? 1u : 0u) << lane;
+            }
+#endif
+            outsideBits &= laneMask & ~outside;
+            if (outsideBits) {
+                hintPlane = i;
+            }
+            outside |= outsideBits;
+
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                if (straddleBits & (1u << lane)) {
+                    childMasks[lane] |= 1u << i;
+                }
+            }
+            if (!(laneMask & ~outside)) {
+                break;
+            }
+        }
+        return laneMask & ~outside;
+    }
+
     // Debug version with detailed logging
     bool testAABBDebug(const AABB& box, int objectIndex = -1) const {
         const char* planeNames[] = {"left", "right", "bottom", "top", "near", "far"};
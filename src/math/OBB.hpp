@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "math/AABB.hpp"
+
+namespace violet {
+
+// Oriented box: center, orthonormal axes and half extents along them
+struct OBB {
+    glm::vec3 center{0.0f};
+    glm::vec3 axes[3] = {glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f)};
+    glm::vec3 halfExtents{0.0f};
+
+    OBB() = default;
+
+    // local placed by an affine transform without shear (rotation, translation, per-axis scale).
+    // Also covers the volume of an orthographic view-projection via OBB(NDC cube, inverse(viewProj)).
+    OBB(const AABB& local, const glm::mat4& transform) {
+        center = glm::vec3(transform * glm::vec4(local.center(), 1.0f));
+        const glm::vec3 localHalf = local.size() * 0.5f;
+        for (int i = 0; i < 3; ++i) {
+            const glm::vec3 column(transform[i]);
+            const float     scale = glm::length(column);
+            axes[i]        = scale > 0.0f ? column / scale : axes[i];
+            halfExtents[i] = localHalf[i] * scale;
+        }
+    }
+
+    [[nodiscard]] AABB getBounds() const {
+        glm::vec3 extent = glm::abs(axes[0]) * halfExtents.x + glm::abs(axes[1]) * halfExtents.y +
+                           glm::abs(axes[2]) * halfExtents.z;
+        return AABB(center - extent, center + extent);
+    }
+
+    // Separating axis test against an AABB (Ericson, Real-Time Collision Detection 4.4.1): the
+    // three box axes, the three OBB axes and their nine cross products. The epsilon keeps
+    // near-parallel cross products from producing false separations, so the test is conservative.
+    [[nodiscard]] bool intersects(const AABB& box) const {
+        constexpr float EPSILON = 1e-6f;
+
+        const glm::vec3 a = box.size() * 0.5f;
+        const glm::vec3 t = center - box.center();
+
+        float r[3][3], absR[3][3];  // r[i][j] = box axis i . OBB axis j
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                r[i][j]    = axes[j][i];
+                absR[i][j] = glm::abs(r[i][j]) + EPSILON;
+            }
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            float rb = halfExtents[0] * absR[i][0] + halfExtents[1] * absR[i][1] + halfExtents[2] * absR[i][2];
+            if (glm::abs(t[i]) > a[i] + rb) {
+                return false;
+            }
+        }
+        for (int j = 0; j < 3; ++j) {
+            float ra = a[0] * absR[0][j] + a[1] * absR[1][j] + a[2] * absR[2][j];
+            if (glm::abs(glm::dot(t, axes[j])) > ra + halfExtents[j]) {
+                return false;
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+            for (int j = 0; j < 3; ++j) {
+                const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+                float ra = a[i1] * absR[i2][j] + a[i2] * absR[i1][j];
+                float rb = halfExtents[j1] * absR[i][j2] + halfExtents[j2] * absR[i][j1];
+                if (glm::abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace violet
@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <limits>
 #include "math/AABB.hpp"
+#include "math/AABB4.hpp"
 
 namespace violet {
 
@@ -35,6 +36,74 @@ struct Ray {
 
         return tNear <= tFar && tFar >= tMin && tNear <= tMax;
     }
+
+    // Moller-Trumbore, two-sided. On a hit within [tMin, tMax] returns the distance in t (in
+    // units of direction's length) and barycentrics (u, v) for v1 and v2.
+    bool intersectTriangle(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2,
+                           float& t, float& u, float& v) const {
+        constexpr float EPSILON = 1e-8f;
+
+        glm::vec3 edge1 = v1 - v0;
+        glm::vec3 edge2 = v2 - v0;
+        glm::vec3 pvec = glm::cross(direction, edge2);
+        float det = glm::dot(edge1, pvec);
+        if (glm::abs(det) < EPSILON) {
+            return false;  // Parallel to the triangle plane
+        }
+
+        float invDet = 1.0f / det;
+        glm::vec3 tvec = origin - v0;
+        u = glm::dot(tvec, pvec) * invDet;
+        if (u < 0.0f || u > 1.0f) {
+            return false;
+        }
+
+        glm::vec3 qvec = glm::cross(tvec, edge1);
+        v = glm::dot(direction, qvec) * invDet;
+        if (v < 0.0f || u + v > 1.0f) {
+            return false;
+        }
+
+        t = glm::dot(edge2, qvec) * invDet;
+        return t >= tMin && t <= tMax;
+    }
+
+    // Slab test against four boxes at once; bit i of the result is set when lane i is hit,
+    // with the entry distance in tNear[i]. Empty lanes must be masked out by the caller.
+    uint32_t intersectAABB4(const AABB4& boxes, float tNear[4]) const {
+#if defined(VIOLET_SIMD_SSE)
+        const __m128 ox = _mm_set1_ps(origin.x);
+        const __m128 oy = _mm_set1_ps(origin.y);
+        const __m128 oz = _mm_set1_ps(origin.z);
+        const __m128 ix = _mm_set1_ps(invDirection.x);
+        const __m128 iy = _mm_set1_ps(invDirection.y);
+        const __m128 iz = _mm_set1_ps(invDirection.z);
+
+        __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(boxes.minX), ox), ix);
+        __m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(boxes.maxX), ox), ix);
+        __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(boxes.minY), oy), iy);
+        __m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(boxes.maxY), oy), iy);
+        __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(boxes.minZ), oz), iz);
+        __m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(boxes.maxZ), oz), iz);
+
+        __m128 nearT = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)), _mm_min_ps(t1z, t2z));
+        __m128 farT  = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)), _mm_max_ps(t1z, t2z));
+
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(nearT, farT),
+                                _mm_and_ps(_mm_cmpge_ps(farT, _mm_set1_ps(tMin)), _mm_cmple_ps(nearT, _mm_set1_ps(tMax))));
+        _mm_storeu_ps(tNear, nearT);
+        return static_cast<uint32_t>(_mm_movemask_ps(hit));
+#else
+        uint32_t mask = 0;
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            float tFar;
+            if (intersectAABB(boxes.getLane(lane), tNear[lane], tFar)) {
+                mask |= 1u << lane;
+            }
+        }
+        return mask;
+#endif
+    }
 };
 
 } // namespace violet
\ No newline at end of file
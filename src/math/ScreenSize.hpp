@@ -0,0 +1,96 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+#include "math/AABB.hpp"
+#include "math/AABB4.hpp"
+
+namespace violet {
+
+// Projected size test for contribution culling. A box is reduced to its bounding sphere, whose
+// on-screen diameter is estimated from the sphere's nearest distance to the eye. The estimate
+// over-approximates and never grows from a node to anything inside it, so a BVH subtree that
+// fails can be dropped as a whole.
+struct ScreenSizeTest {
+    glm::vec3 eye{0.0f};
+    float     pixelsPerUnit = 0.0f;  // At distance 1 for perspective projections, everywhere for orthographic
+    float     minPixels     = 0.0f;  // Boxes projecting smaller than this fail; 0 disables the test
+    bool      orthographic  = false;
+
+    // From a projection matrix (either kind, Vulkan Y flip allowed), the eye position and the
+    // size of the target in pixels (or shadow map texels)
+    static ScreenSizeTest fromProjection(const glm::mat4& projection, const glm::vec3& eye, float targetWidth,
+                                         float targetHeight, float minPixels) {
+        ScreenSizeTest test;
+        test.eye           = eye;
+        test.orthographic  = projection[2][3] == 0.0f;
+        test.pixelsPerUnit = 0.5f * glm::max(std::abs(projection[0][0]) * targetWidth,
+                                             std::abs(projection[1][1]) * targetHeight);
+        test.minPixels     = minPixels;
+        return test;
+    }
+
+    bool isEnabled() const { return minPixels > 0.0f; }
+
+    // Estimated diameter in pixels; infinite when the eye is inside the bounding sphere
+    float projectedSize(const AABB& box) const {
+        float radius = 0.5f * glm::length(box.size());
+        if (orthographic) {
+            return 2.0f * radius * pixelsPerUnit;
+        }
+        float distance = glm::length(box.center() - eye) - radius;
+        return distance > 0.0f ? 2.0f * radius * pixelsPerUnit / distance : INFINITY;
+    }
+
+    // size >= minPixels without the division: 2 r k >= minPixels (|c - eye| - r)
+    bool test(const AABB& box) const {
+        if (!isEnabled()) {
+            return true;
+        }
+        float radius = 0.5f * glm::length(box.size());
+        float reach  = orthographic ? 1.0f : glm::length(box.center() - eye) - radius;
+        return 2.0f * radius * pixelsPerUnit >= minPixels * reach;
+    }
+
+    // The lanes of laneMask whose boxes pass (lane filter for BVH traversals)
+    uint32_t testAABB4(const AABB4& boxes, uint32_t laneMask) const {
+        if (!isEnabled()) {
+            return laneMask;
+        }
+#if defined(VIOLET_SIMD_SSE)
+        const __m128 half = _mm_set1_ps(0.5f);
+        __m128 sizeX = _mm_sub_ps(_mm_load_ps(boxes.maxX), _mm_load_ps(boxes.minX));
+        __m128 sizeY = _mm_sub_ps(_mm_load_ps(boxes.maxY), _mm_load_ps(boxes.minY));
+        __m128 sizeZ = _mm_sub_ps(_mm_load_ps(boxes.maxZ), _mm_load_ps(boxes.minZ));
+        __m128 radius = _mm_mul_ps(half, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sizeX, sizeX),
+                                                                           _mm_mul_ps(sizeY, sizeY)),
+                                                                _mm_mul_ps(sizeZ, sizeZ))));
+        __m128 reach = _mm_set1_ps(1.0f);
+        if (!orthographic) {
+            __m128 dx = _mm_sub_ps(_mm_mul_ps(half, _mm_add_ps(_mm_load_ps(boxes.minX), _mm_load_ps(boxes.maxX))),
+                                   _mm_set1_ps(eye.x));
+            __m128 dy = _mm_sub_ps(_mm_mul_ps(half, _mm_add_ps(_mm_load_ps(boxes.minY), _mm_load_ps(boxes.maxY))),
+                                   _mm_set1_ps(eye.y));
+            __m128 dz = _mm_sub_ps(_mm_mul_ps(half, _mm_add_ps(_mm_load_ps(boxes.minZ), _mm_load_ps(boxes.maxZ))),
+                                   _mm_set1_ps(eye.z));
+            __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                                     _mm_mul_ps(dz, dz)));
+            reach = _mm_sub_ps(distance, radius);
+        }
+        __m128 size = _mm_mul_ps(radius, _mm_set1_ps(2.0f * pixelsPerUnit));
+        __m128 pass = _mm_cmpge_ps(size, _mm_mul_ps(reach, _mm_set1_ps(minPixels)));
+        return laneMask & static_cast<uint32_t>(_mm_movemask_ps(pass));
+#else
+        uint32_t mask = 0;
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            if ((laneMask & (1u << lane)) && test(boxes.getLane(lane))) {
+                mask |= 1u << lane;
+            }
+        }
+        return mask;
+#endif
+    }
+};
+
+} // namespace violet
@@ -1,8 +1,10 @@
 #include "renderer/ForwardRenderer.hpp"
 
+#include <bit>
 #include <glm/glm.hpp>
 
 #include <EASTL/unique_ptr.h>
+#include <EASTL/algorithm.h>
 #include "resource/gpu/ResourceFactory.hpp"
 #include "resource/ResourceManager.hpp"
 
@@ -22,6 +24,7 @@
 #include "renderer/LightingSystem.hpp"
 #include "renderer/ShadowSystem.hpp"
 #include "renderer/ShadowPass.hpp"
+#include "math/ScreenSize.hpp"
 
 namespace violet {
 
@@ -52,6 +55,9 @@ void ForwardRenderer::init(VulkanContext* ctx, ResourceManager* resMgr, vk::Form
     context = ctx;
     resourceManager = resMgr;
     maxFramesInFlight = framesInFlight;
+    bvhCacheDirectory = FileSystem::join(FileSystem::getExecutableDirectory(), "cache/bvh");
+    minScreenSizePixels = context->getRenderSettings().minScreenSizePixels;
+    minShadowSizeTexels = context->getRenderSettings().minShadowSizeTexels;
 
     // DescriptorManager is now owned by ResourceManager and already initialized
     auto& descMgr = resourceManager->getDescriptorManager();
@@ -131,6 +137,14 @@ void ForwardRenderer::cleanup() {
     // Step 1: Clear containers with raw pointers first
     renderables.clear();
     renderableCache.clear();
+    if (observedWorld) {
+        observedWorld->on_construct<MeshComponent>().disconnect(*this);
+        observedWorld->on_update<MeshComponent>().disconnect(*this);
+        observedWorld->on_destroy<MeshComponent>().disconnect(*this);
+        observedWorld->on_construct<TransformComponent>().disconnect(*this);
+        observedWorld->on_destroy<TransformComponent>().disconnect(*this);
+        observedWorld = nullptr;
+    }
 
     // Step 2: Cleanup high-level rendering components
     // These may still reference materials/textures, so clean them before destroying resources
@@ -181,12 +195,29 @@ void ForwardRenderer::beginFrame(entt::registry& world, uint32_t frameIndex) {
     updateGlobalUniforms(world, frameIndex);
     collectRenderables(world);
 
+    // Bring the scene BVH up to date first: light influence and shadow casters query it
+    updateSceneBVH(world);
+
     // Update lighting and shadow systems
+    sharedCameraCull = false;
     if (lightingSystem && shadowSystem) {
         Camera* activeCamera = findActiveCamera(world);
         if (activeCamera) {
-            lightingSystem->update(world, activeCamera->getFrustum(), frameIndex);
-            shadowSystem->update(world, *lightingSystem, activeCamera, frameIndex, getSceneBounds());
+            lightingSystem->update(world, activeCamera->getFrustum(), frameIndex, &sceneBVH);
+
+            // Plain BVH culling of the camera joins the shadow views' traversal; the temporal and
+            // brute-force paths keep culling on their own in renderScene
+            bool shareCameraCull = !temporalCullingEnabled && !useBruteForceCulling();
+            sharedCameraVisible.clear();
+            shadowSystem->setMinCasterSize(minShadowSizeTexels);
+            shadowSystem->setStaticCaching(staticShadowCacheEnabled);
+            shadowSystem->setTexelBudget(static_cast<uint64_t>(shadowTexelBudgetM * (1u << 20)));
+            shadowSystem->setViewportHeight(currentExtent.height);
+            shadowSystem->setSceneGeneration(sceneBVHGeneration);
+            shadowSystem->update(world, *lightingSystem, activeCamera, frameIndex, getSceneBounds(), &sceneBVH,
+                                 &renderables, shareCameraCull ? &activeCamera->getFrustum() : nullptr,
+                                 shareCameraCull ? &sharedCameraVisible : nullptr);
+            sharedCameraCull = shareCameraCull && shadowSystem->hasViewCasters();
 
             lightingSystem->uploadToGPU(frameIndex);
             shadowSystem->uploadToGPU(frameIndex);
@@ -203,6 +234,11 @@ void ForwardRenderer::renderFrame(vk::CommandBuffer cmd, uint32_t imageIndex, vk
         return;
     }
 
+    // Static shadow cache bake and restore go ahead of the graph, which then loads the atlas
+    if (shadowPass && shadowSystem && shadowSystem->getShadowCount() > 0) {
+        shadowPass->recordStaticCache(cmd);
+    }
+
     // Rebuild graph每帧 (swapchain image changes)
     rebuildRenderGraph(imageIndex);
 
@@ -268,7 +304,16 @@ void ForwardRenderer::rebuildRenderGraph(uint32_t imageIndex) {
     // Import shadow atlas from ShadowSystem as external resource
     if (shadowSystem) {
         const ImageResource* atlasRes = shadowSystem->getAtlasImage();
-        if (atlasRes && atlasRes->image) {
+        if (atlasRes && atlasRes->image && shadowPass && shadowPass->isAtlasRestored()) {
+            // Cached static shadow depth was copied in before the graph
+            renderGraph->importImage("shadowAtlas", atlasRes,
+                vk::ImageLayout::eTransferDstOptimal,
+                vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+                vk::PipelineStageFlagBits2::eTransfer,
+                vk::PipelineStageFlagBits2::eFragmentShader,
+                vk::AccessFlagBits2::eTransferWrite,
+                vk::AccessFlagBits2::eShaderSampledRead);
+        } else if (atlasRes && atlasRes->image) {
             renderGraph->importImage("shadowAtlas", atlasRes,
                 vk::ImageLayout::eUndefined,
                 vk::ImageLayout::eDepthStencilReadOnlyOptimal,
@@ -286,7 +331,8 @@ void ForwardRenderer::rebuildRenderGraph(uint32_t imageIndex) {
             clearValue.depthStencil = vk::ClearDepthStencilValue{1.0f, 0};
 
             b.write("shadowAtlas", ResourceUsage::DepthAttachment, AttachmentOptions{
-                .loadOp = vk::AttachmentLoadOp::eClear,
+                .loadOp = shadowPass && shadowPass->isAtlasRestored() ? vk::AttachmentLoadOp::eLoad
+                                                                      : vk::AttachmentLoadOp::eClear,
                 .storeOp = vk::AttachmentStoreOp::eStore,
                 .clearValue = clearValue,
                 .hasValue = true
@@ -396,7 +442,16 @@ void ForwardRenderer::rebuildRenderGraph(uint32_t imageIndex) {
 }
 
 void ForwardRenderer::collectRenderables(entt::registry& world) {
+    observeWorld(world);
+
+    // Only transforms changed since the last build: patch the reported entities in place
+    if (incrementalCollection && bvhBuilt && !sceneDirty && !renderables.empty()) {
+        collectChangedRenderables(world);
+        return;
+    }
+
     renderables.clear();
+    changedTransforms.clear();
     // Don't reset sceneDirty here - it should only be reset after BVH rebuild
 
     auto view = world.view<TransformComponent, MeshComponent>();
@@ -404,6 +459,94 @@ void ForwardRenderer::collectRenderables(entt::registry& world) {
     for (auto entity : view) {
         collectFromEntity(entity, world);
     }
+
+    // Renderables added or removed: the BVH topology no longer matches, refitting is not enough
+    if (bvhBuilt && renderables.size() != sceneBVH.getPrimitiveCount()) {
+        sceneDirty = true;
+    }
+
+    dirtyRenderables.clear();
+    for (uint32_t i = 0; i < renderables.size(); ++i) {
+        if (renderables[i].dirty) {
+            dirtyRenderables.push_back(i);
+        }
+    }
+}
+
+void ForwardRenderer::collectChangedRenderables(entt::registry& world) {
+    // Last frame's changes are consumed by now
+    for (uint32_t index : dirtyRenderables) {
+        renderables[index].dirty = false;
+    }
+    dirtyRenderables.clear();
+
+    for (entt::entity entity : changedTransforms) {
+        auto cached = renderableCache.find(entity);
+        if (cached == renderableCache.end()) {
+            continue;  // Not rendered: lights, grouping nodes
+        }
+        auto* transform = world.try_get<TransformComponent>(entity);
+        auto* meshComp  = world.try_get<MeshComponent>(entity);
+        if (!transform || !meshComp || !meshComp->mesh) {
+            continue;  // Structure signals already marked the scene dirty
+        }
+
+        meshComp->updateWorldBounds(transform->worldMatrix);
+        for (uint32_t index : cached->second) {
+            Renderable& renderable = renderables[index];
+            if (renderable.dirty) {
+                continue;  // Reported twice
+            }
+            renderable.worldTransform = transform->worldMatrix;
+            renderable.dirty          = true;
+            dirtyRenderables.push_back(index);
+            refitIndices.push_back(index);
+        }
+        meshComp->dirty  = false;
+        transform->dirty = false;
+    }
+    changedTransforms.clear();
+}
+
+void ForwardRenderer::markTransformsChanged(const eastl::vector<entt::entity>& entities) {
+    changedTransforms.insert(changedTransforms.end(), entities.begin(), entities.end());
+    incrementalCollection = true;
+}
+
+void ForwardRenderer::markTransformChanged(entt::entity entity) {
+    changedTransforms.push_back(entity);
+    incrementalCollection = true;
+}
+
+void ForwardRenderer::observeWorld(entt::registry& world) {
+    if (observedWorld == &world) {
+        return;
+    }
+    if (observedWorld) {
+        observedWorld->on_construct<MeshComponent>().disconnect(*this);
+        observedWorld->on_update<MeshComponent>().disconnect(*this);
+        observedWorld->on_destroy<MeshComponent>().disconnect(*this);
+        observedWorld->on_construct<TransformComponent>().disconnect(*this);
+        observedWorld->on_destroy<TransformComponent>().disconnect(*this);
+        observedWorld->on_construct<MaterialComponent>().disconnect(*this);
+        observedWorld->on_update<MaterialComponent>().disconnect(*this);
+        observedWorld->on_destroy<MaterialComponent>().disconnect(*this);
+    }
+    world.on_construct<MeshComponent>().connect<&ForwardRenderer::onRenderableStructureChanged>(*this);
+    world.on_update<MeshComponent>().connect<&ForwardRenderer::onRenderableStructureChanged>(*this);
+    world.on_destroy<MeshComponent>().connect<&ForwardRenderer::onRenderableStructureChanged>(*this);
+    world.on_construct<TransformComponent>().connect<&ForwardRenderer::onRenderableStructureChanged>(*this);
+    world.on_destroy<TransformComponent>().connect<&ForwardRenderer::onRenderableStructureChanged>(*this);
+    // Renderables hold the resolved material, which the incremental path does not re-resolve
+    world.on_construct<MaterialComponent>().connect<&ForwardRenderer::onRenderableStructureChanged>(*this);
+    world.on_update<MaterialComponent>().connect<&ForwardRenderer::onRenderableStructureChanged>(*this);
+    world.on_destroy<MaterialComponent>().connect<&ForwardRenderer::onRenderableStructureChanged>(*this);
+    observedWorld = &world;
+    sceneDirty    = true;
+}
+
+void ForwardRenderer::onRenderableStructureChanged(entt::registry&, entt::entity) {
+    sceneDirty = true;
 }
 
 void ForwardRenderer::updateGlobalUniforms(entt::registry& world, uint32_t frameIndex) {
@@ -455,13 +598,13 @@ void ForwardRenderer::collectFromEntity(entt::entity entity, entt::registry& wor
     }
 
     Mesh*     mesh           = meshComp->mesh.get();
-    glm::mat4 worldTransform = transform->world.getMatrix();
+    glm::mat4 worldTransform = transform->worldMatrix;
 
 
-    // Update world bounds if dirty
-    if (meshComp->dirty || transform->dirty) {
+    // Update world bounds if dirty; the BVH is refitted for these renderables instead of rebuilt
+    bool boundsChanged = meshComp->dirty || transform->dirty;
+    if (boundsChanged) {
         meshComp->updateWorldBounds(worldTransform);
-        sceneDirty = true; // Mark scene as dirty when any object is dirty
     }
 
     const auto& subMeshes = mesh->getSubMeshes();
@@ -492,16 +635,30 @@ void ForwardRenderer::collectFromEntity(entt::entity entity, entt::registry& wor
             static_cast<uint32_t>(i)
         );
         renderable.visible = true;
-        renderable.dirty   = meshComp->dirty || transform->dirty;
+        renderable.dirty   = boundsChanged;
 
+        uint32_t renderableIndex = static_cast<uint32_t>(renderables.size());
         renderables.push_back(renderable);
+
+        if (!bvhBuilt || sceneDirty) {
+            continue;
+        }
+
+        // A renderable at an index the BVH does not know for this entity means the set was reordered
+        auto cached = renderableCache.find(entity);
+        if (cached == renderableCache.end() ||
+            eastl::find(cached->second.begin(), cached->second.end(), renderableIndex) == cached->second.end()) {
+            sceneDirty = true;
+        } else if (boundsChanged) {
+            refitIndices.push_back(renderableIndex);
+        }
     }
 
     meshComp->dirty  = false;
     transform->dirty = false;
 }
 
-void ForwardRenderer::buildSceneBVH(entt::registry& world) {
+void ForwardRenderer::buildSceneBVH(entt::registry& world, bool useCache) {
     // Build BVH from renderables
     renderableBounds.clear();
     renderableBounds.reserve(renderables.size());
@@ -537,10 +694,284 @@ void ForwardRenderer::buildSceneBVH(entt::registry& world) {
         }
     }
 
-    // Build BVH once for the scene
-    sceneBVH.build(renderableBounds);
-    violet::Log::info("Renderer", "Scene BVH built with {} renderables", renderables.size());
+    renderableBoundsSoA.assign(renderableBounds);
+
+    renderableCache.clear();
+    for (uint32_t i = 0; i < renderables.size(); ++i) {
+        renderableCache[renderables[i].entity].push_back(i);
+    }
+    refitIndices.clear();
+
+    // Build BVH once for the scene, or reload the topology cached for exactly these bounds
+    ThreadPool* threadPool = resourceManager ? resourceManager->getThreadPool() : nullptr;
+    useCache = useCache && !bvhCacheDirectory.empty() && renderableBounds.size() >= BVH_CACHE_MIN_PRIMITIVES;
+
+    bool loaded = false;
+    eastl::string cachePath;
+    uint64_t cacheKey = 0;
+    if (useCache) {
+        cacheKey = BVH::computeCacheKey(renderableBounds, bvhBuildMethod);
+        eastl::string fileName;
+        fileName.sprintf("%016llx.bvh", static_cast<unsigned long long>(cacheKey));
+        cachePath = FileSystem::join(bvhCacheDirectory, fileName);
+
+        MappedFile cacheFile(cachePath);
+        loaded = cacheFile.isValid() &&
+                 sceneBVH.deserialize(cacheFile.data(), cacheFile.size(), cacheKey, renderableBounds, bvhBuildMethod,
+                                      threadPool);
+        if (loaded) {
+            FileSystem::touch(cachePath);
+        }
+    }
+
+    if (!loaded) {
+        sceneBVH.build(renderableBounds, threadPool, bvhBuildMethod);
+
+        if (useCache) {
+            eastl::vector<uint8_t> blob;
+            sceneBVH.serialize(cacheKey, blob);
+            if (!FileSystem::createDirectories(bvhCacheDirectory) ||
+                !FileSystem::writeBinary(cachePath, blob.data(), blob.size())) {
+                violet::Log::warn("Renderer", "Failed to write BVH cache {}", cachePath.c_str());
+            }
+            FileSystem::trimDirectory(bvhCacheDirectory, ".bvh", BVH_CACHE_MAX_BYTES);
+        }
+    }
+
+    sceneDirty = false;
+    bvhBuilt   = true;
+
+    const auto& buildStats   = sceneBVH.getBuildStats();
+    const auto& qualityStats = sceneBVH.getQualityStats();
+    violet::Log::info("Renderer", "Scene BVH ({}) {} with {} renderables in {:.2f}ms ({})",
+                      bvhBuildMethod == BVHBuildMethod::SAH ? "SAH" : "LBVH",
+                      buildStats.fromCache ? "loaded from cache" : "built", renderables.size(),
+                      buildStats.buildTimeMs, buildStats.parallel ? "parallel" : "serial");
+    violet::Log::info("Renderer", "Scene BVH quality: SAH cost {:.2f}, avg leaf size {:.2f}, max depth {}",
+                      qualityStats.sahCost, qualityStats.avgLeafSize, qualityStats.maxDepth);
+
+}
+
+void ForwardRenderer::updateSceneBVH(entt::registry& world) {
+    // Only rebuild BVH when objects have moved or changed
+    if (!bvhBuilt || sceneDirty) {
+        // Rebuild bounds when scene is dirty
+        if (sceneDirty) {
+            // The renderable set may have changed: casters cached by index or entity are stale
+            ++sceneBVHGeneration;
+            buildSceneBVH(world, bvhCacheReady);
+            bvhCacheReady = false;
+            violet::Log::info("Renderer", "Scene was dirty - rebuilt BVH with {} renderables", renderables.size());
+        } else {
+            sceneBVH.build(renderableBounds, resourceManager ? resourceManager->getThreadPool() : nullptr,
+                           bvhBuildMethod);
+            bvhBuilt = true;
+        }
+    } else if (!refitIndices.empty()) {
+        // Only bounds changed: refit the affected leaves instead of rebuilding
+        refitSceneBVH(world);
+    }
+}
+
+void ForwardRenderer::refitSceneBVH(entt::registry& world) {
+    // With most of the scene moving a fresh build is cheaper and restores tree quality. Same
+    // renderables either way, so the BVH generation stays.
+    const bool rebuild = refitIndices.size() * 2 > renderables.size();
+
+    for (uint32_t index : refitIndices) {
+        if (index >= renderables.size() || index >= renderableBounds.size()) {
+            continue;
+        }
+
+        const Renderable& renderable = renderables[index];
+        auto* meshComp = world.try_get<MeshComponent>(renderable.entity);
+        if (!meshComp || renderable.subMeshIndex >= meshComp->getSubMeshCount()) {
+            continue;
+        }
+
+        renderableBounds[index] = meshComp->getSubMeshWorldBounds(renderable.subMeshIndex);
+        renderableBoundsSoA.set(index, renderableBounds[index]);
+        if (!rebuild) {
+            sceneBVH.refit(index, renderableBounds[index]);
+        }
+    }
+    refitIndices.clear();
+
+    if (rebuild) {
+        sceneBVH.build(renderableBounds, resourceManager ? resourceManager->getThreadPool() : nullptr,
+                       bvhBuildMethod);
+        return;
+    }
+
+    // Refitted nodes only grow looser over time; rebuild once the tree has degraded enough
+    if (sceneBVH.needsRebuild()) {
+        violet::Log::info("Renderer", "Scene BVH degraded to {:.2f}x after refits - rebuilding",
+                          sceneBVH.getRefitDegradation());
+        sceneBVH.build(renderableBounds, resourceManager ? resourceManager->getThreadPool() : nullptr,
+                       bvhBuildMethod);
+    }
+}
+
+namespace {
+
+// Translate BVH primitive indices (renderable indices) to entity/submesh pairs
+uint32_t resolveRenderables(const eastl::vector<Renderable>& renderables, const eastl::vector<uint32_t>& indices,
+                            eastl::vector<RenderableID>& results) {
+    uint32_t appended = 0;
+    for (uint32_t index : indices) {
+        if (index < renderables.size()) {
+            results.push_back({renderables[index].entity, renderables[index].subMeshIndex});
+            ++appended;
+        }
+    }
+    return appended;
+}
+
+} // namespace
+
+uint32_t ForwardRenderer::queryRenderables(const AABB& box, eastl::vector<RenderableID>& results) const {
+    eastl::vector<uint32_t> indices;
+    sceneBVH.queryAABB(box, indices);
+    return resolveRenderables(renderables, indices, results);
+}
+
+uint32_t ForwardRenderer::queryRenderables(const glm::vec3& center, float radius,
+                                           eastl::vector<RenderableID>& results) const {
+    eastl::vector<uint32_t> indices;
+    sceneBVH.querySphere(center, radius, indices);
+    return resolveRenderables(renderables, indices, results);
+}
+
+uint32_t ForwardRenderer::queryRenderables(const OBB& box, eastl::vector<RenderableID>& results) const {
+    eastl::vector<uint32_t> indices;
+    sceneBVH.queryOBB(box, indices);
+    return resolveRenderables(renderables, indices, results);
+}
+
+uint32_t ForwardRenderer::queryRenderables(const Frustum& frustum, eastl::vector<RenderableID>& results) const {
+    eastl::vector<uint32_t> indices;
+    sceneBVH.queryFrustum(frustum, indices);
+    return resolveRenderables(renderables, indices, results);
+}
+
+uint32_t ForwardRenderer::queryNearestRenderables(const glm::vec3& point, uint32_t k, float maxDistance,
+                                                  eastl::vector<RenderableID>& results) const {
+    eastl::vector<BVHNeighbor> neighbors;
+    sceneBVH.queryNearest(point, k, maxDistance, neighbors);
+
+    uint32_t appended = 0;
+    for (const BVHNeighbor& neighbor : neighbors) {
+        if (neighbor.primitiveIndex < renderables.size()) {
+            const Renderable& renderable = renderables[neighbor.primitiveIndex];
+            results.push_back({renderable.entity, renderable.subMeshIndex});
+            ++appended;
+        }
+    }
+    return appended;
+}
+
+bool ForwardRenderer::raycast(const Ray& worldRay, RayHit& hit, bool anyHit) const {
+    Ray queryRay = worldRay;
+
+    auto intersectRenderable = [&](uint32_t index, Ray& ray) -> bool {
+        if (index >= renderables.size() || index >= renderableBounds.size()) {
+            return false;
+        }
+        const Renderable& renderable = renderables[index];
+        if (!renderable.mesh || renderable.subMeshIndex >= renderable.mesh->getSubMeshCount()) {
+            return false;
+        }
+
+        const MeshGeometry* geometry = renderable.mesh->getGeometry();
+        if (!geometry) {
+            // No CPU geometry retained: the submesh bounds are the best surface we have
+            float tNear, tFar;
+            if (!ray.intersectAABB(renderableBounds[index], tNear, tFar)) {
+                return false;
+            }
+            ray.tMax          = eastl::max(tNear, ray.tMin);
+            hit.entity        = renderable.entity;
+            hit.subMeshIndex  = renderable.subMeshIndex;
+            hit.triangleIndex = ~0u;
+            hit.barycentrics  = glm::vec2(0.0f);
+            return true;
+        }
+
+        // Descend into the mesh's static triangle BVH in object space. The direction is not
+        // renormalized, so t stays comparable across instances and with the world-space ray.
+        glm::mat4 invWorld = glm::inverse(renderable.worldTransform);
+        Ray localRay(glm::vec3(invWorld * glm::vec4(ray.origin, 1.0f)),
+                     glm::vec3(invWorld * glm::vec4(ray.direction, 0.0f)), ray.tMin, ray.tMax);
+
+        uint32_t  triangleIndex;
+        glm::vec2 barycentrics;
+        bool found = geometry->intersect(renderable.subMeshIndex, localRay, anyHit, triangleIndex, barycentrics);
+        if (found) {
+            ray.tMax          = localRay.tMax;
+            hit.entity        = renderable.entity;
+            hit.subMeshIndex  = renderable.subMeshIndex;
+            hit.triangleIndex = triangleIndex;
+            hit.barycentrics  = barycentrics;
+        }
+        return found;
+    };
+
+    bool found = anyHit ? sceneBVH.intersectAny(queryRay, intersectRenderable)
+                        : sceneBVH.intersectClosest(queryRay, intersectRenderable);
+    if (found) {
+        hit.t        = queryRay.tMax;
+        hit.position = worldRay.origin + worldRay.direction * queryRay.tMax;
+    }
+    return found;
+}
+
+bool ForwardRenderer::useBruteForceCulling() const {
+    return cullingMode == CullingMode::BruteForce ||
+           (cullingMode == CullingMode::Auto && renderables.size() < BRUTE_FORCE_CULL_THRESHOLD);
+}
+
+void ForwardRenderer::prepareOcclusion(const glm::mat4& viewProj, const glm::vec3& cameraPosition) {
+    occlusionCuller.begin(viewProj);
+
+    // Rank last frame's visible renderables by projected size; the ones that covered the most
+    // screen last frame are the best occluders this frame
+    occluderScores.clear();
+    for (uint32_t index : previousVisible) {
+        if (index >= renderables.size() || index >= renderableBounds.size()) {
+            continue;  // Renderable list changed since last frame
+        }
+        const Renderable& renderable = renderables[index];
+        if (!renderable.mesh || renderable.subMeshIndex >= renderable.mesh->getSubMeshCount()) {
+            continue;
+        }
+        if (renderable.material && renderable.material->getAlphaMode() != Material::AlphaMode::Opaque) {
+            continue;  // See-through surfaces hide nothing
+        }
+        const MeshGeometry* geometry = renderable.mesh->getGeometry();
+        if (!geometry || renderable.mesh->getSubMesh(renderable.subMeshIndex).indexCount / 3 > MAX_OCCLUDER_TRIANGLES) {
+            continue;
+        }
+
+        const AABB& bounds = renderableBounds[index];
+        float size2 = glm::dot(bounds.size(), bounds.size());
+        float distance2 = eastl::max(bounds.distanceSquared(cameraPosition), 1e-4f);
+        occluderScores.push_back(eastl::make_pair(size2 / distance2, index));
+    }
+
+    uint32_t occluderCount = eastl::min(static_cast<uint32_t>(occluderScores.size()), MAX_OCCLUDERS);
+    eastl::partial_sort(occluderScores.begin(), occluderScores.begin() + occluderCount, occluderScores.end(),
+                        [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    for (uint32_t i = 0; i < occluderCount; ++i) {
+        const Renderable& renderable = renderables[occluderScores[i].second];
+        const MeshGeometry* geometry = renderable.mesh->getGeometry();
+        const SubMesh& subMesh = renderable.mesh->getSubMesh(renderable.subMeshIndex);
+        occlusionCuller.addOccluder(geometry->positions.data(), static_cast<uint32_t>(geometry->positions.size()),
+                                    geometry->indices.data() + subMesh.firstIndex, subMesh.indexCount,
+                                    renderable.worldTransform);
+    }
 
+    occlusionCuller.rasterize(resourceManager ? resourceManager->getThreadPool() : nullptr);
 }
 
 void ForwardRenderer::renderScene(vk::CommandBuffer commandBuffer, uint32_t frameIndex, entt::registry& world) {
@@ -564,7 +995,11 @@ void ForwardRenderer::renderScene(vk::CommandBuffer commandBuffer, uint32_t fram
     glm::mat4 viewProjMatrix = projMatrix * viewMatrix;
 
 
+    // Last frame's result seeds this frame's occluders
+    previousVisible.swap(visibleIndices);
     visibleIndices.clear();
+    renderStats.occlusionCulled = 0;
+    renderStats.screenSizeCulled = 0;
 
     // Debug: Temporarily disable culling to test if it's the cause
     static bool disableCulling = false;  // Re-enable culling
@@ -575,28 +1010,72 @@ void ForwardRenderer::renderScene(vk::CommandBuffer commandBuffer, uint32_t fram
         }
         // Render all objects without culling (debug mode)
     } else {
-        // Only rebuild BVH when objects have moved or changed
-        if (!bvhBuilt || sceneDirty) {
-            // Rebuild bounds when scene is dirty
-            if (sceneDirty) {
-                buildSceneBVH(world);
-                violet::Log::info("Renderer", "Scene was dirty - rebuilt BVH with {} renderables", renderables.size());
-            } else {
-                sceneBVH.build(renderableBounds);
-            }
-            sceneDirty = false;
-            bvhBuilt = true;
+        // Normally already done in beginFrame
+        updateSceneBVH(world);
+
+        bool bruteForce = useBruteForceCulling();
+        bool occlusion = occlusionCullingEnabled && !previousVisible.empty();
+        if (occlusion) {
+            prepareOcclusion(viewProjMatrix, camPos);
         }
 
-        // Use BVH traversal for frustum culling
-        sceneBVH.traverse(
-            [&frustum](const AABB& bounds) -> bool {
-                return frustum.testAABB(bounds);
-            },
-            [&](uint32_t primitiveIndex) {
+        // Contribution culling against the camera projection at the current viewport size
+        const ScreenSizeTest sizeTest = ScreenSizeTest::fromProjection(
+            projMatrix, camPos, static_cast<float>(currentExtent.width), static_cast<float>(currentExtent.height),
+            minScreenSizePixels);
+
+        bool occlusionPerRenderable = false;
+        coherenceStats = BVHCoherenceStats{};
+        if (bruteForce) {
+            // Small scenes: testing every renderable with the SIMD kernel beats walking the tree
+            FrustumCuller::cull(frustum, renderableBoundsSoA, visibleIndices);
+            occlusionPerRenderable = occlusion;
+        } else if (sharedCameraCull) {
+            // Already culled in beginFrame, in the same BVH traversal as the shadow casters
+            visibleIndices.assign(sharedCameraVisible.begin(), sharedCameraVisible.end());
+            occlusionPerRenderable = occlusion;
+        } else if (temporalCullingEnabled) {
+            // Only the previous frame's cut near the frustum boundary is re-tested; a static
+            // camera over a static scene costs nothing
+            const auto& visible = sceneBVH.cullFrustumCoherent(frustum, cullCoherence, &coherenceStats);
+            visibleIndices.assign(visible.begin(), visible.end());
+            occlusionPerRenderable = occlusion;
+        } else if (occlusion || sizeTest.isEnabled()) {
+            // Children too small on screen or occluded are dropped with their whole subtree
+            sceneBVH.cullFrustumFiltered(frustum, cullPlaneHints,
+                [&](const AABB4& bounds, uint32_t lanes) {
+                    uint32_t kept = sizeTest.testAABB4(bounds, lanes);
+                    renderStats.screenSizeCulled += static_cast<uint32_t>(std::popcount(lanes & ~kept));
+                    if (occlusion && kept) {
+                        uint32_t unoccluded = occlusionCuller.testAABB4(bounds, kept);
+                        renderStats.occlusionCulled += static_cast<uint32_t>(std::popcount(kept & ~unoccluded));
+                        kept = unoccluded;
+                    }
+                    return kept;
+                },
+                [&](uint32_t primitiveIndex) { visibleIndices.push_back(primitiveIndex); });
+        } else {
+            // Wide BVH frustum culling: four child boxes per step, planes that already contain a node
+            // are skipped below it and fully visible subtrees are emitted without further tests
+            sceneBVH.cullFrustum(frustum, cullPlaneHints, [&](uint32_t primitiveIndex) {
                 visibleIndices.push_back(primitiveIndex);
-            }
-        );
+            });
+        }
+
+        // The per-renderable paths apply the same filters after the frustum test
+        bool perRenderableSize = sizeTest.isEnabled() && (bruteForce || sharedCameraCull || temporalCullingEnabled);
+        if (perRenderableSize) {
+            auto small = eastl::remove_if(visibleIndices.begin(), visibleIndices.end(),
+                [&](uint32_t index) { return !sizeTest.test(renderableBounds[index]); });
+            renderStats.screenSizeCulled = static_cast<uint32_t>(visibleIndices.end() - small);
+            visibleIndices.erase(small, visibleIndices.end());
+        }
+        if (occlusionPerRenderable) {
+            auto hidden = eastl::remove_if(visibleIndices.begin(), visibleIndices.end(),
+                [&](uint32_t index) { return !occlusionCuller.testAABB(renderableBounds[index]); });
+            renderStats.occlusionCulled = static_cast<uint32_t>(visibleIndices.end() - hidden);
+            visibleIndices.erase(hidden, visibleIndices.end());
+        }
     }
 
     // Reset render statistics
@@ -604,6 +1083,29 @@ void ForwardRenderer::renderScene(vk::CommandBuffer commandBuffer, uint32_t fram
     renderStats.visibleRenderables = static_cast<uint32_t>(visibleIndices.size());
     renderStats.drawCalls = 0;
     renderStats.skippedRenderables = 0;
+    renderStats.shadowSizeCulled = shadowSystem ? shadowSystem->getSmallCastersCulled() : 0;
+    renderStats.shadowViews = 0;
+    renderStats.shadowCasters = 0;
+    if (shadowSystem && shadowSystem->hasViewCasters()) {
+        renderStats.shadowViews = static_cast<uint32_t>(shadowSystem->getViews().size());
+        renderStats.shadowCasters = static_cast<uint32_t>(shadowSystem->getViewCasterIndices().size());
+    }
+    renderStats.shadowDrawCalls = shadowPass ? shadowPass->getStats().drawCalls : 0;
+    renderStats.shadowMeshBinds = shadowPass ? shadowPass->getStats().meshBinds : 0;
+    renderStats.shadowCacheDraws = shadowPass ? shadowPass->getStats().cacheDraws : 0;
+    renderStats.shadowCacheReused = shadowSystem ? shadowSystem->getCacheStats().reused : 0;
+    renderStats.shadowCacheScrolled = shadowSystem ? shadowSystem->getCacheStats().scrolled : 0;
+    renderStats.shadowCacheRebaked = shadowSystem ? shadowSystem->getCacheStats().rebaked : 0;
+    if (shadowSystem) {
+        const ShadowAtlasStats& atlasStats = shadowSystem->getAtlasStats();
+        const uint64_t atlasTexels = static_cast<uint64_t>(atlasStats.atlasSize) * atlasStats.atlasSize;
+        renderStats.shadowAtlasSize = atlasStats.atlasSize;
+        renderStats.shadowAtlasUsage = atlasTexels ? static_cast<float>(atlasStats.usedTexels) / atlasTexels : 0.0f;
+        renderStats.shadowAtlasFragmentation = atlasStats.fragmentation;
+        renderStats.shadowAtlasDowngraded = atlasStats.downgraded + atlasStats.dropped;
+        renderStats.shadowBudgetCut = atlasStats.budgetCut;
+        renderStats.shadowRequestedTexelsM = static_cast<float>(atlasStats.requestedTexels) / (1u << 20);
+    }
 
     // ========== BINDLESS RENDERING ==========
     auto pbrBindlessMaterial = getMaterialManager()->getMaterialByName("PBRBindless");
@@ -24,6 +24,8 @@
 #include "renderer/ShadowPass.hpp"
 #include "renderer/graph/RenderPass.hpp"
 #include "acceleration/BVH.hpp"
+#include "acceleration/FrustumCuller.hpp"
+#include "acceleration/OcclusionCuller.hpp"
 #include "renderer/graph/RenderGraph.hpp"
 
 namespace violet {
@@ -44,6 +46,41 @@ struct RenderStats {
     uint32_t visibleRenderables = 0;
     uint32_t drawCalls = 0;
     uint32_t skippedRenderables = 0;
+    uint32_t occlusionCulled = 0;  // Rejected by the occlusion buffer: renderables (brute force) or BVH subtrees
+    uint32_t screenSizeCulled = 0; // Below minScreenSize: renderables (brute force) or BVH subtrees
+    uint32_t shadowSizeCulled = 0; // Caster/shadow view pairs dropped below minShadowSize
+    uint32_t shadowViews = 0;      // Cascades and cube faces culled this frame
+    uint32_t shadowCasters = 0;    // Sum of the per-view caster lists
+    uint32_t shadowDrawCalls = 0;  // Issued by the shadow pass
+    uint32_t shadowMeshBinds = 0;
+    uint32_t shadowCacheReused = 0;    // Shadow views per static cache mode
+    uint32_t shadowCacheScrolled = 0;
+    uint32_t shadowCacheRebaked = 0;
+    uint32_t shadowCacheDraws = 0;     // Static casters drawn into the cache
+    uint32_t shadowAtlasSize = 0;
+    float shadowAtlasUsage = 0.0f;     // Allocated fraction of the atlas
+    float shadowAtlasFragmentation = 0.0f;
+    uint32_t shadowAtlasDowngraded = 0; // Shadow maps below their requested resolution or dropped
+    uint32_t shadowBudgetCut = 0;      // Resolution halvings to fit the shadow texel budget
+    float shadowRequestedTexelsM = 0.0f; // Millions of texels requested after the budget
+};
+
+// How renderScene culls: through the scene BVH, by testing every renderable with the SIMD
+// brute-force kernel, or picking by scene size
+enum class CullingMode {
+    Auto,
+    BVH,
+    BruteForce
+};
+
+// Result of a scene ray query
+struct RayHit {
+    entt::entity entity        = entt::null;
+    uint32_t     subMeshIndex  = 0;
+    uint32_t     triangleIndex = ~0u;  // Relative to the submesh; ~0u when only bounds were hit (no CPU geometry)
+    float        t             = 0.0f; // Distance along the query ray, in units of its direction
+    glm::vec2    barycentrics{0.0f};   // Weights of the triangle's second and third vertex
+    glm::vec3    position{0.0f};       // World-space hit point
 };
 
 // GlobalUniforms class removed - now using DescriptorManager::createUniform() + UniformHandle
@@ -86,11 +123,98 @@ public:
     const MaterialManager* getMaterialManager() const;
 
     void                             clearRenderables() { renderables.clear(); }
+
+    // Incremental collection: once the application reports moved entities (see
+    // Scene::getChangedEntities), renderables persist between frames and only the reported
+    // entities are re-collected and refitted. Adding or removing meshes or transforms, or
+    // assigning materials (emplace, replace or patch), seen through registry signals, still
+    // re-collects everything.
+    void markTransformsChanged(const eastl::vector<entt::entity>& entities);
+    void markTransformChanged(entt::entity entity);
     const eastl::vector<Renderable>& getRenderables() const { return renderables; }
 
-    // BVH management
-    void buildSceneBVH(entt::registry& world);
+    // BVH management. useCache is for the first build after a scene load (see markSceneLoaded):
+    // rebuilds of a changing scene never hit the disk cache and would only fill it.
+    void buildSceneBVH(entt::registry& world, bool useCache = false);
     const AABB& getSceneBounds() const { return sceneBVH.getSceneBounds(); }
+    const BVH& getSceneBVH() const { return sceneBVH; }
+    // Changes with every rebuild of a dirty scene, i.e. whenever the renderable set may have changed
+    uint32_t getSceneBVHGeneration() const { return sceneBVHGeneration; }
+
+    // Closest-hit (or, with anyHit, first-found) ray query against the scene's triangles.
+    // Two levels: the scene BVH over submesh world bounds (refit on moves) selects instances,
+    // then the ray is transformed into object space and traced through the mesh's static
+    // triangle BVH (MeshGeometry). Ray t limits are honoured.
+    bool raycast(const Ray& ray, RayHit& hit, bool anyHit = false) const;
+
+    // Overlap queries over the scene BVH (renderable world bounds vs AABB, sphere, OBB or
+    // frustum) and the k nearest renderables within maxDistance, nearest first. Results are
+    // appended to the caller's buffer; each returns the number appended.
+    uint32_t queryRenderables(const AABB& box, eastl::vector<RenderableID>& results) const;
+    uint32_t queryRenderables(const glm::vec3& center, float radius, eastl::vector<RenderableID>& results) const;
+    uint32_t queryRenderables(const OBB& box, eastl::vector<RenderableID>& results) const;
+    uint32_t queryRenderables(const Frustum& frustum, eastl::vector<RenderableID>& results) const;
+    uint32_t queryNearestRenderables(const glm::vec3& point, uint32_t k, float maxDistance,
+                                     eastl::vector<RenderableID>& results) const;
+
+    // LBVH for scenes that rebuild often, SAH for mostly static content; changing it forces a rebuild
+    void setBVHBuildMethod(BVHBuildMethod method) {
+        if (bvhBuildMethod != method) {
+            bvhBuildMethod = method;
+            sceneDirty     = true;
+        }
+    }
+    BVHBuildMethod getBVHBuildMethod() const { return bvhBuildMethod; }
+
+    // Scene BVH topology is cached on disk per input (see BVH::computeCacheKey), so reloading an
+    // unchanged scene skips the build. Defaults to cache/bvh next to the executable; empty disables.
+    void setBVHCacheDirectory(const eastl::string& directory) { bvhCacheDirectory = directory; }
+    const eastl::string& getBVHCacheDirectory() const { return bvhCacheDirectory; }
+
+    // Smaller scenes build faster than a file round trip is worth
+    static constexpr uint32_t BVH_CACHE_MIN_PRIMITIVES = 4096;
+    // Least recently used entries are evicted past this size
+    static constexpr uint64_t BVH_CACHE_MAX_BYTES = 256ull << 20;
+
+    void        setCullingMode(CullingMode mode) { cullingMode = mode; }
+    CullingMode getCullingMode() const { return cullingMode; }
+
+    // Below this many renderables Auto culls brute force; measured crossover is 2-8k boxes
+    // depending on how much of the scene is visible (bvh_test culling benchmark)
+    static constexpr uint32_t BRUTE_FORCE_CULL_THRESHOLD = 2048;
+
+    // Software occlusion culling after the frustum test. Occluders are the largest opaque
+    // renderables that were visible last frame and have CPU geometry (MeshGeometry); their real
+    // triangles are rasterized into a small depth buffer each frame.
+    void setOcclusionCulling(bool enabled) { occlusionCullingEnabled = enabled; }
+    bool getOcclusionCulling() const { return occlusionCullingEnabled; }
+    const OcclusionCuller& getOcclusionCuller() const { return occlusionCuller; }
+
+    // Contribution culling thresholds, initialized from RenderSettings: renderables projecting
+    // smaller than minScreenSize pixels are not drawn, shadow casters smaller than minShadowSize
+    // texels of a shadow view are not drawn into it. 0 disables.
+    void  setMinScreenSize(float pixels) { minScreenSizePixels = eastl::max(pixels, 0.0f); }
+    float getMinScreenSize() const { return minScreenSizePixels; }
+    void  setMinShadowSize(float texels) { minShadowSizeTexels = eastl::max(texels, 0.0f); }
+    float getMinShadowSize() const { return minShadowSizeTexels; }
+
+    // Static shadow cache: directional shadow views keep the depth of casters that stopped
+    // moving and redraw only dynamic ones (see ShadowSystem::setStaticCaching)
+    void setStaticShadowCache(bool enabled) { staticShadowCacheEnabled = enabled; }
+    bool getStaticShadowCache() const { return staticShadowCacheEnabled; }
+
+    // Global shadow texel budget in millions of texels (see ShadowSystem::setTexelBudget)
+    void  setShadowTexelBudget(float megaTexels) { shadowTexelBudgetM = eastl::max(megaTexels, 1.0f); }
+    float getShadowTexelBudget() const { return shadowTexelBudgetM; }
+
+    // Temporal coherence for BVH culling: each frame re-tests only the previous frame's
+    // traversal cut where the camera moved enough to matter (see BVH::cullFrustumCoherent)
+    void setTemporalCulling(bool enabled) { temporalCullingEnabled = enabled; }
+    bool getTemporalCulling() const { return temporalCullingEnabled; }
+    const BVHCoherenceStats& getCoherenceStats() const { return coherenceStats; }
+
+    static constexpr uint32_t MAX_OCCLUDERS          = 32;
+    static constexpr uint32_t MAX_OCCLUDER_TRIANGLES = 2048;  // Per occluder; denser meshes cost more than they hide
 
     // Debug rendering
     DebugRenderer& getDebugRenderer() { return debugRenderer; }
@@ -100,6 +224,12 @@ public:
 
     // Scene state management
     void markSceneDirty() { sceneDirty = true; }
+    // A scene was just loaded: the next rebuild, once transforms and bounds are final, may reuse
+    // the on-disk BVH cache
+    void markSceneLoaded() {
+        sceneDirty    = true;
+        bvhCacheReady = true;
+    }
 
     // Swapchain resize
     void resize(vk::Extent2D newExtent);
@@ -130,6 +260,13 @@ public:
 
 private:
     void collectFromEntity(entt::entity entity, entt::registry& world);
+    void collectChangedRenderables(entt::registry& world);
+    void observeWorld(entt::registry& world);
+    void onRenderableStructureChanged(entt::registry& world, entt::entity entity);
+    void updateSceneBVH(entt::registry& world);
+    void refitSceneBVH(entt::registry& world);
+    void prepareOcclusion(const glm::mat4& viewProj, const glm::vec3& cameraPosition);
+    bool useBruteForceCulling() const;
 
     // Declarative descriptor layouts registration
     void registerDescriptorLayouts();
@@ -139,11 +276,36 @@ private:
 
     eastl::vector<Renderable>                          renderables;
     eastl::vector<AABB>                                renderableBounds;
-    eastl::hash_map<entt::entity, eastl::vector<uint32_t>> renderableCache;
-    BVH sceneBVH;
+    AABBSoA                                            renderableBoundsSoA;  // Mirror of renderableBounds for brute-force culling
+    eastl::hash_map<entt::entity, eastl::vector<uint32_t>> renderableCache;  // Renderable indices per entity as of the last BVH build
+    eastl::vector<uint32_t> refitIndices;  // Renderables whose bounds changed since the last BVH update
+    eastl::vector<entt::entity> changedTransforms;  // Reported since the last collection
+    eastl::vector<uint32_t> dirtyRenderables;       // Renderables flagged dirty by the last collection
+    bool incrementalCollection = false;             // Set once changes are reported
+    entt::registry* observedWorld = nullptr;        // Registry whose structure signals are connected
+    BVH sceneBVH;  // Top level over submesh instances; triangle-level BVHs live in each MeshGeometry
+    uint32_t sceneBVHGeneration = 0;
+    BVHBuildMethod bvhBuildMethod = BVHBuildMethod::LBVH;
+    eastl::string bvhCacheDirectory;
+    CullingMode cullingMode = CullingMode::Auto;
     eastl::vector<uint32_t> visibleIndices;
+    eastl::vector<uint8_t> cullPlaneHints;  // Per wide BVH node, plane that last rejected a child
+    eastl::vector<uint32_t> sharedCameraVisible;  // Camera view of the shadow casters' multi-view traversal
+    bool sharedCameraCull = false;                // sharedCameraVisible holds this frame's camera culling
+    BVHCullCoherence cullCoherence;  // Temporal culling state of the main view
+    BVHCoherenceStats coherenceStats;
+    bool temporalCullingEnabled = false;
+    float minScreenSizePixels = 0.0f;
+    float minShadowSizeTexels = 0.0f;
+    bool staticShadowCacheEnabled = true;
+    float shadowTexelBudgetM = 32.0f;
+    OcclusionCuller occlusionCuller;
+    bool occlusionCullingEnabled = false;
+    eastl::vector<uint32_t> previousVisible;  // Last frame's visibleIndices, the occluder candidates
+    eastl::vector<eastl::pair<float, uint32_t>> occluderScores;
     bool sceneDirty = true;
     bool bvhBuilt = false;
+    bool bvhCacheReady = false;  // Set by markSceneLoaded until the next rebuild
     RenderStats renderStats;
     entt::registry* currentWorld = nullptr;
     vk::Extent2D currentExtent = {1280, 720};
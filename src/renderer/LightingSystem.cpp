@@ -1,4 +1,5 @@
 #include "LightingSystem.hpp"
+#include "acceleration/BVH.hpp"
 #include "ecs/Components.hpp"
 #include "renderer/camera/Camera.hpp"
 #include "renderer/vulkan/VulkanContext.hpp"
@@ -43,21 +44,24 @@ void LightingSystem::cleanup() {
     }
 
     cpuLightData.clear();
+    lightEntities.clear();
 
     context = nullptr;
     descriptorManager = nullptr;
 }
 
-void LightingSystem::update(entt::registry& world, const Frustum& cameraFrustum, uint32_t frameIndex) {
+void LightingSystem::update(entt::registry& world, const Frustum& cameraFrustum, uint32_t frameIndex,
+                            const BVH* sceneBVH) {
     cpuLightData.clear();
-    collectLights(world, cameraFrustum);
+    lightEntities.clear();
+    collectLights(world, cameraFrustum, sceneBVH);
 
     if (!cpuLightData.empty()) {
         ensureBufferCapacity(static_cast<uint32_t>(cpuLightData.size()));
     }
 }
 
-void LightingSystem::collectLights(entt::registry& world, const Frustum& cameraFrustum) {
+void LightingSystem::collectLights(entt::registry& world, const Frustum& cameraFrustum, const BVH* sceneBVH) {
     auto lightView = world.view<LightComponent, TransformComponent>();
 
     for (auto entity : lightView) {
@@ -72,6 +76,13 @@ void LightingSystem::collectLights(entt::registry& world, const Frustum& cameraF
             if (!cameraFrustum.testAABB(lightBounds)) {
                 continue;
             }
+
+            // A light that reaches no geometry contributes nothing; one hit is enough to keep it
+            influenceScratch.clear();
+            if (sceneBVH && sceneBVH->getPrimitiveCount() > 0 &&
+                sceneBVH->querySphere(transform.world.position, light.radius, influenceScratch, 1) == 0) {
+                continue;
+            }
         }
 
         // Build LightData
@@ -88,6 +99,7 @@ void LightingSystem::collectLights(entt::registry& world, const Frustum& cameraF
         lightData.shadowIndex = -1;  // Will be set by ShadowPass if needed
 
         cpuLightData.push_back(lightData);
+        lightEntities.push_back(entity);
 
         // Check if we hit the limit
         if (cpuLightData.size() >= MAX_LIGHTS) {
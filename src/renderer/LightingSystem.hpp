@@ -12,6 +12,7 @@ namespace violet {
 class VulkanContext;
 class DescriptorManager;
 class Frustum;
+class BVH;
 
 // GPU light data (must match shader)
 struct LightData {
@@ -32,7 +33,9 @@ public:
     void init(VulkanContext* context, DescriptorManager* descMgr, uint32_t maxFramesInFlight);
     void cleanup();
 
-    void update(entt::registry& world, const Frustum& cameraFrustum, uint32_t frameIndex);
+    // With the scene BVH, point lights whose influence sphere reaches no renderable are skipped
+    void update(entt::registry& world, const Frustum& cameraFrustum, uint32_t frameIndex,
+                const BVH* sceneBVH = nullptr);
     void uploadToGPU(uint32_t frameIndex);
 
     vk::DescriptorSet getDescriptorSet(uint32_t frameIndex) const;
@@ -41,8 +44,11 @@ public:
     eastl::vector<LightData>& getLightData() { return cpuLightData; }
     const eastl::vector<LightData>& getLightData() const { return cpuLightData; }
 
+    // Entity of each entry in getLightData()
+    const eastl::vector<entt::entity>& getLightEntities() const { return lightEntities; }
+
 private:
-    void collectLights(entt::registry& world, const Frustum& cameraFrustum);
+    void collectLights(entt::registry& world, const Frustum& cameraFrustum, const BVH* sceneBVH);
     void ensureBufferCapacity(uint32_t lightCount);
 
 private:
@@ -51,6 +57,8 @@ private:
     uint32_t maxFramesInFlight = 3;
 
     eastl::vector<LightData> cpuLightData;
+    eastl::vector<entt::entity> lightEntities;
+    eastl::vector<uint32_t> influenceScratch;  // Scene BVH query output
     class BufferResource lightBuffer;          // Single buffer with per-frame sections
     vk::DescriptorSet descriptorSet;          // Single descriptor set with dynamic offset
     uint32_t alignedFrameSize = 0;             // Aligned size for each frame's data
@@ -90,16 +90,31 @@ RenderSettings RenderSettings::loadFromFile(const eastl::string& configPath, vk:
                     settings.msaaSamples = vk::SampleCountFlagBits::e1;
                 }
             }
+
+            // Load contribution culling thresholds
+            if (rendererConfig.contains("screenSizeCulling")) {
+                auto& sizeConfig = rendererConfig["screenSizeCulling"];
+
+                if (sizeConfig.contains("minPixels")) {
+                    settings.minScreenSizePixels = std::max(sizeConfig["minPixels"].get<float>(), 0.0f);
+                }
+                if (sizeConfig.contains("minShadowTexels")) {
+                    settings.minShadowSizeTexels = std::max(sizeConfig["minShadowTexels"].get<float>(), 0.0f);
+                }
+            }
         }
 
         // Format MSAA samples for logging
         int msaaSamplesInt = static_cast<int>(settings.msaaSamples);
 
-        violet::Log::info("Renderer", "Loaded config from {}: anisotropy={}, maxAnisotropy={:.0f}x, MSAA={}x",
+        violet::Log::info("Renderer", "Loaded config from {}: anisotropy={}, maxAnisotropy={:.0f}x, MSAA={}x, "
+                          "minScreenSize={:.1f}px, minShadowSize={:.1f}texels",
                           configPath.c_str(),
                           settings.enableAnisotropy ? "enabled" : "disabled",
                           settings.maxAnisotropy,
-                          msaaSamplesInt);
+                          msaaSamplesInt,
+                          settings.minScreenSizePixels,
+                          settings.minShadowSizeTexels);
 
     } catch (const nlohmann::json::exception& e) {
         violet::Log::error("Renderer", "Failed to parse config file {}: {}", configPath.c_str(), e.what());
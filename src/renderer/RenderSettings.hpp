@@ -14,6 +14,11 @@ struct RenderSettings {
     // MSAA (note: requires render target recreation - not yet implemented)
     vk::SampleCountFlagBits msaaSamples = vk::SampleCountFlagBits::e1;
 
+    // Contribution culling: objects whose projected bounds span fewer pixels (main view) or
+    // shadow map texels (shadow views) than this are not drawn. 0 disables.
+    float minScreenSizePixels = 0.0f;
+    float minShadowSizeTexels = 0.0f;
+
     // Get default settings based on device capabilities
     static RenderSettings getDefaults(vk::PhysicalDevice physicalDevice) {
         RenderSettings settings;
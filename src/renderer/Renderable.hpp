@@ -23,4 +23,10 @@ struct Renderable {
         : mesh(m), material(mat), worldTransform(transform), subMeshIndex(subMesh), entity(e) {}
 };
 
+// Identifies a renderable across frames (indices into the renderable list are not stable)
+struct RenderableID {
+    entt::entity entity       = entt::null;
+    uint32_t     subMeshIndex = 0;
+};
+
 } // namespace violet
\ No newline at end of file
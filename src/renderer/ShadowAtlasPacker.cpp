@@ -0,0 +1,209 @@
+#include "ShadowAtlasPacker.hpp"
+#include <EASTL/algorithm.h>
+#include <bit>
+
+namespace violet {
+
+void ShadowAtlasPacker::init(uint32_t atlasSize, uint32_t minimumSize) {
+    nodes.clear();
+    freeNodes.clear();
+    allocationCount = 0;
+    minSize = std::bit_ceil(eastl::max(minimumSize, 1u));
+    root = createNode(glm::uvec2(0), std::bit_ceil(eastl::max(atlasSize, minSize)), INVALID);
+}
+
+void ShadowAtlasPacker::clear() {
+    if (root != INVALID) {
+        init(getAtlasSize(), minSize);
+    }
+}
+
+uint32_t ShadowAtlasPacker::roundSize(uint32_t size) const {
+    return std::bit_ceil(eastl::max(size, minSize));
+}
+
+uint32_t ShadowAtlasPacker::allocate(uint32_t size) {
+    size = roundSize(size);
+    if (root == INVALID || size > nodes[root].largestFree) {
+        return INVALID;
+    }
+
+    uint32_t id = root;
+    while (true) {
+        if (nodes[id].state == NodeState::Free) {
+            if (nodes[id].size == size) {
+                nodes[id].state = NodeState::Allocated;
+                ++allocationCount;
+                refresh(id);
+                return id;
+            }
+            split(id);
+        }
+
+        // Best fit: the quadrant whose largest free square is the smallest one that still fits,
+        // which keeps large squares whole for large requests
+        uint32_t best = INVALID;
+        for (uint32_t child : nodes[id].children) {
+            const uint32_t largest = nodes[child].largestFree;
+            if (largest >= size && (best == INVALID || largest < nodes[best].largestFree)) {
+                best = child;
+            }
+        }
+        id = best;  // largestFree of the parent guarantees a fit
+    }
+}
+
+void ShadowAtlasPacker::free(uint32_t id) {
+    if (id >= nodes.size() || nodes[id].state != NodeState::Allocated) {
+        return;
+    }
+    nodes[id].state = NodeState::Free;
+    --allocationCount;
+    refresh(id);
+    tryMerge(nodes[id].parent);
+}
+
+void ShadowAtlasPacker::grow() {
+    const uint32_t oldRoot = root;
+    const uint32_t size    = nodes[oldRoot].size;
+
+    const uint32_t newRoot = createNode(glm::uvec2(0), size * 2, INVALID);
+    nodes[newRoot].state       = NodeState::Split;
+    nodes[newRoot].children[0] = oldRoot;
+    nodes[oldRoot].parent      = newRoot;
+    for (uint32_t q = 1; q < 4; ++q) {
+        const uint32_t child = createNode(glm::uvec2(q & 1u, q >> 1) * size, size, newRoot);
+        nodes[newRoot].children[q] = child;
+    }
+    root = newRoot;
+    refresh(root);
+    tryMerge(root);
+}
+
+bool ShadowAtlasPacker::canShrink() const {
+    const Node& node = nodes[root];
+    if (node.size / 2 < minSize) {
+        return false;
+    }
+    if (node.state != NodeState::Split) {
+        return node.state == NodeState::Free;
+    }
+    for (uint32_t q = 1; q < 4; ++q) {
+        if (nodes[node.children[q]].state != NodeState::Free) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ShadowAtlasPacker::shrink() {
+    if (!canShrink()) {
+        return false;
+    }
+    if (nodes[root].state == NodeState::Free) {
+        nodes[root].size /= 2;
+        nodes[root].largestFree = nodes[root].size;
+        return true;
+    }
+
+    const uint32_t oldRoot = root;
+    root = nodes[oldRoot].children[0];
+    nodes[root].parent = INVALID;
+    for (uint32_t q = 1; q < 4; ++q) {
+        releaseNode(nodes[oldRoot].children[q]);
+    }
+    releaseNode(oldRoot);
+    return true;
+}
+
+ShadowAtlasStats ShadowAtlasPacker::getStats() const {
+    ShadowAtlasStats stats;
+    stats.atlasSize   = getAtlasSize();
+    stats.allocations = allocationCount;
+    for (const Node& node : nodes) {
+        if (node.size != 0 && node.state == NodeState::Allocated) {
+            stats.usedTexels += static_cast<uint64_t>(node.size) * node.size;
+        }
+    }
+    stats.freeTexels  = static_cast<uint64_t>(stats.atlasSize) * stats.atlasSize - stats.usedTexels;
+    stats.largestFree = getLargestFree();
+    if (stats.freeTexels > 0) {
+        const double largest = static_cast<double>(stats.largestFree) * stats.largestFree;
+        stats.fragmentation = static_cast<float>(1.0 - largest / static_cast<double>(stats.freeTexels));
+    }
+    return stats;
+}
+
+uint32_t ShadowAtlasPacker::createNode(glm::uvec2 offset, uint32_t size, uint32_t parent) {
+    uint32_t id;
+    if (!freeNodes.empty()) {
+        id = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        id = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node{});
+    }
+    Node& node = nodes[id];
+    node = Node{};
+    node.offset      = offset;
+    node.size        = size;
+    node.largestFree = size;
+    node.parent      = parent;
+    return id;
+}
+
+void ShadowAtlasPacker::releaseNode(uint32_t id) {
+    nodes[id] = Node{};  // Size 0 marks the slot unused
+    freeNodes.push_back(id);
+}
+
+void ShadowAtlasPacker::split(uint32_t id) {
+    const glm::uvec2 offset = nodes[id].offset;
+    const uint32_t   half   = nodes[id].size / 2;
+    for (uint32_t q = 0; q < 4; ++q) {
+        // createNode may reallocate nodes, so the parent is indexed afresh
+        const uint32_t child = createNode(offset + glm::uvec2(q & 1u, q >> 1) * half, half, id);
+        nodes[id].children[q] = child;
+    }
+    nodes[id].state = NodeState::Split;
+}
+
+void ShadowAtlasPacker::refresh(uint32_t id) {
+    while (id != INVALID) {
+        Node& node = nodes[id];
+        switch (node.state) {
+            case NodeState::Free:
+                node.largestFree = node.size;
+                break;
+            case NodeState::Allocated:
+                node.largestFree = 0;
+                break;
+            case NodeState::Split:
+                node.largestFree = 0;
+                for (uint32_t child : node.children) {
+                    node.largestFree = eastl::max(node.largestFree, nodes[child].largestFree);
+                }
+                break;
+        }
+        id = node.parent;
+    }
+}
+
+void ShadowAtlasPacker::tryMerge(uint32_t id) {
+    while (id != INVALID && nodes[id].state == NodeState::Split) {
+        for (uint32_t child : nodes[id].children) {
+            if (nodes[child].state != NodeState::Free) {
+                return;
+            }
+        }
+        for (uint32_t& child : nodes[id].children) {
+            releaseNode(child);
+            child = INVALID;
+        }
+        nodes[id].state = NodeState::Free;
+        refresh(id);
+        id = nodes[id].parent;
+    }
+}
+
+} // namespace violet
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <EASTL/vector.h>
+#include <cstdint>
+
+namespace violet {
+
+struct ShadowAtlasStats {
+    uint32_t atlasSize       = 0;
+    uint32_t allocations     = 0;
+    uint32_t downgraded      = 0;     // Allocations below their requested size (ShadowSystem)
+    uint32_t dropped         = 0;     // Requests that did not fit at any size (ShadowSystem)
+    uint32_t budgetCut       = 0;     // Halvings to fit the texel budget (ShadowSystem)
+    uint64_t requestedTexels = 0;     // Sum of the budgeted requests (ShadowSystem)
+    uint64_t usedTexels      = 0;
+    uint64_t freeTexels      = 0;
+    uint32_t largestFree     = 0;     // Side of the largest square that can still be allocated
+    float    fragmentation   = 0.0f;  // 1 - largestFree^2 / freeTexels: 0 when all free space is one square
+};
+
+// Quadtree packer for the square, power-of-two shadow maps of a square atlas. A node is free,
+// allocated, or split into four quadrants; freeing merges quadrants back up. Allocations keep
+// their place until freed, so shadow maps stay put from frame to frame, and growing doubles the
+// atlas in place: the old tree becomes the top-left quadrant and every allocation keeps its
+// texel offset.
+class ShadowAtlasPacker {
+public:
+    static constexpr uint32_t INVALID = ~0u;
+
+    void init(uint32_t atlasSize, uint32_t minSize);
+    void clear();
+
+    // Sizes are rounded up to a power of two no smaller than the minimum size. Returns an
+    // allocation id or INVALID when no free square is large enough.
+    uint32_t allocate(uint32_t size);
+    void free(uint32_t id);
+
+    // Doubles the atlas, keeping every allocation where it is
+    void grow();
+    // Halves the atlas when everything allocated lies in its top-left quadrant
+    bool canShrink() const;
+    bool shrink();
+
+    glm::uvec2 getOffset(uint32_t id) const { return nodes[id].offset; }
+    uint32_t   getSize(uint32_t id) const { return nodes[id].size; }
+    uint32_t   getAtlasSize() const { return nodes.empty() ? 0 : nodes[root].size; }
+    uint32_t   getMinSize() const { return minSize; }
+    uint32_t   getLargestFree() const { return nodes.empty() ? 0 : nodes[root].largestFree; }
+    uint32_t   roundSize(uint32_t size) const;
+
+    ShadowAtlasStats getStats() const;
+
+private:
+    enum class NodeState : uint8_t { Free, Allocated, Split };
+
+    struct Node {
+        glm::uvec2 offset{0};
+        uint32_t   size        = 0;
+        uint32_t   largestFree = 0;  // Side of the largest free square in the subtree
+        uint32_t   parent      = INVALID;
+        uint32_t   children[4] = {INVALID, INVALID, INVALID, INVALID};
+        NodeState  state       = NodeState::Free;
+    };
+
+    uint32_t createNode(glm::uvec2 offset, uint32_t size, uint32_t parent);
+    void     releaseNode(uint32_t id);
+    void     split(uint32_t id);
+    void     refresh(uint32_t id);      // Recomputes largestFree from id up to the root
+    void     tryMerge(uint32_t id);     // Collapses id and its ancestors while all quadrants are free
+
+    eastl::vector<Node> nodes;
+    eastl::vector<uint32_t> freeNodes;
+    uint32_t root = INVALID;
+    uint32_t minSize = 1;
+    uint32_t allocationCount = 0;
+};
+
+} // namespace violet
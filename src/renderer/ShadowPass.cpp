@@ -9,6 +9,7 @@
 #include "resource/Mesh.hpp"
 #include "core/Log.hpp"
 #include <glm/glm.hpp>
+#include <cmath>
 
 namespace violet {
 
@@ -34,6 +35,9 @@ void ShadowPass::init(VulkanContext* ctx, DescriptorManager* descMgr, ShaderLibr
     config.enableDepthWrite = true;
     config.depthCompareOp = vk::CompareOp::eLess;
     config.cullMode = vk::CullModeFlagBits::eNone;  // No culling for shadow pass
+    // Casters are culled against views extruded toward the light; the ones in front of a view's
+    // near plane are flattened onto it instead of being clipped
+    config.depthClampEnable = context->getPhysicalDevice().getFeatures().depthClamp;
 
     // Dynamic rendering - depth-only pass (no color attachments)
     config.colorFormats = {};  // Empty - depth-only
@@ -50,13 +54,152 @@ void ShadowPass::cleanup() {
     shadowPipeline.reset();
 }
 
+bool ShadowPass::recordStaticCache(vk::CommandBuffer cmd) {
+    atlasRestored = false;
+    stats.cacheDraws = 0;
+    if (!shadowPipeline || !shadowSystem || !shadowSystem->hasViewCasters()) {
+        return false;
+    }
+    const ImageResource* cache = shadowSystem->getCacheImage();
+    const ImageResource* atlas = shadowSystem->getAtlasImage();
+    if (!cache || !cache->image || !atlas || !atlas->image) {
+        return false;
+    }
+
+    const auto& views = shadowSystem->getViews();
+    bool rebake = false;
+    bool restore = false;
+    for (const ShadowView& view : views) {
+        rebake  |= view.cacheMode == ShadowCacheMode::Rebake;
+        restore |= view.cacheMode != ShadowCacheMode::None;
+    }
+    // Without anything baked yet the shadow pass simply draws every caster
+    if (!restore || (!rebake && !cacheInitialized)) {
+        return false;
+    }
+
+    auto transition = [cmd](vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
+                            vk::PipelineStageFlags2 srcStage, vk::AccessFlags2 srcAccess,
+                            vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess) {
+        vk::ImageMemoryBarrier2 barrier;
+        barrier.srcStageMask = srcStage;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstStageMask = dstStage;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = newLayout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = vk::ImageSubresourceRange{vk::ImageAspectFlagBits::eDepth, 0, 1, 0, 1};
+
+        vk::DependencyInfo dependencyInfo;
+        dependencyInfo.imageMemoryBarrierCount = 1;
+        dependencyInfo.pImageMemoryBarriers = &barrier;
+        cmd.pipelineBarrier2(dependencyInfo);
+    };
+    const vk::PipelineStageFlags2 depthStages =
+        vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests;
+    const vk::ClearAttachment depthClear{vk::ImageAspectFlagBits::eDepth, 0, vk::ClearDepthStencilValue{1.0f, 0}};
+
+    if (rebake) {
+        // Other views' regions of the cache are kept, so its layout is only discarded on first use
+        transition(cache->image,
+                   cacheInitialized ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::eUndefined,
+                   vk::ImageLayout::eDepthAttachmentOptimal,
+                   vk::PipelineStageFlagBits2::eTransfer, {},
+                   depthStages,
+                   vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite);
+
+        vk::RenderingAttachmentInfo depthAttachment;
+        depthAttachment.imageView = cache->view;
+        depthAttachment.imageLayout = vk::ImageLayout::eDepthAttachmentOptimal;
+        depthAttachment.loadOp = vk::AttachmentLoadOp::eLoad;
+        depthAttachment.storeOp = vk::AttachmentStoreOp::eStore;
+
+        const uint32_t cacheSize = shadowSystem->getCacheSize();
+        vk::RenderingInfo renderingInfo;
+        renderingInfo.renderArea = vk::Rect2D{{0, 0}, {cacheSize, cacheSize}};
+        renderingInfo.layerCount = 1;
+        renderingInfo.pDepthAttachment = &depthAttachment;
+        cmd.beginRendering(renderingInfo);
+
+        shadowPipeline->bind(cmd);
+        for (const ShadowView& view : views) {
+            if (view.cacheMode != ShadowCacheMode::Rebake) {
+                continue;
+            }
+            vk::Viewport viewport;
+            viewport.x = static_cast<float>(view.cacheOffset.x);
+            viewport.y = static_cast<float>(view.cacheOffset.y);
+            viewport.width = static_cast<float>(view.resolution);
+            viewport.height = static_cast<float>(view.resolution);
+            viewport.minDepth = 0.0f;
+            viewport.maxDepth = 1.0f;
+            cmd.setViewport(0, 1, &viewport);
+
+            vk::Rect2D scissor;
+            scissor.offset.x = static_cast<int32_t>(view.cacheOffset.x);
+            scissor.offset.y = static_cast<int32_t>(view.cacheOffset.y);
+            scissor.extent.width = view.resolution;
+            scissor.extent.height = view.resolution;
+            cmd.setScissor(0, 1, &scissor);
+
+            const vk::ClearRect clearRect{scissor, 0, 1};
+            cmd.clearAttachments(1, &depthClear, 1, &clearRect);
+            drawCasters(cmd, view.viewProj, view.firstCaster, view.staticCount, stats.cacheDraws);
+        }
+        cmd.endRendering();
+
+        transition(cache->image, vk::ImageLayout::eDepthAttachmentOptimal, vk::ImageLayout::eTransferSrcOptimal,
+                   vk::PipelineStageFlagBits2::eLateFragmentTests, vk::AccessFlagBits2::eDepthStencilAttachmentWrite,
+                   vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferRead);
+        cacheInitialized = true;
+    }
+
+    // The atlas is rewritten from scratch each frame: cached regions by copy, the rest by the
+    // shadow pass
+    transition(atlas->image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+               vk::PipelineStageFlagBits2::eFragmentShader, {},
+               vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite);
+
+    eastl::vector<vk::ImageCopy> regions;
+    for (const ShadowView& view : views) {
+        if (view.cacheMode == ShadowCacheMode::None) {
+            continue;
+        }
+        const vk::Rect2D rect = getAtlasRect(view);
+        const glm::ivec2 shift = view.cacheMode == ShadowCacheMode::Scroll ? view.scroll : glm::ivec2(0);
+
+        vk::ImageCopy region;
+        region.srcSubresource = vk::ImageSubresourceLayers{vk::ImageAspectFlagBits::eDepth, 0, 0, 1};
+        region.dstSubresource = region.srcSubresource;
+        region.srcOffset = vk::Offset3D{static_cast<int32_t>(view.cacheOffset.x) + glm::max(shift.x, 0),
+                                        static_cast<int32_t>(view.cacheOffset.y) + glm::max(shift.y, 0), 0};
+        region.dstOffset = vk::Offset3D{rect.offset.x + glm::max(-shift.x, 0), rect.offset.y + glm::max(-shift.y, 0), 0};
+        region.extent = vk::Extent3D{view.resolution - static_cast<uint32_t>(glm::abs(shift.x)),
+                                     view.resolution - static_cast<uint32_t>(glm::abs(shift.y)), 1};
+        regions.push_back(region);
+    }
+    cmd.copyImage(cache->image, vk::ImageLayout::eTransferSrcOptimal, atlas->image,
+                  vk::ImageLayout::eTransferDstOptimal, static_cast<uint32_t>(regions.size()), regions.data());
+
+    atlasRestored = true;
+    return true;
+}
+
 void ShadowPass::executePass(vk::CommandBuffer cmd, uint32_t frameIndex, entt::registry& world) {
+    stats.views = 0;
+    stats.drawCalls = 0;
+    stats.meshBinds = 0;
     if (!shadowPipeline || !shadowSystem || !lightingSystem) {
         return;
     }
 
-    // Get shadow renderables from ShadowSystem (not camera-culled)
+    // Get shadow renderables from ShadowSystem (not camera-culled); with per-view casters each
+    // cascade draws only the ones culled for it, grouped by mesh
     const auto& renderables = shadowSystem->getShadowRenderables();
+    const bool perViewCasters = shadowSystem->hasViewCasters();
 
     const auto& shadowData = shadowSystem->getShadowData();
     if (shadowData.empty()) {
@@ -64,6 +207,7 @@ void ShadowPass::executePass(vk::CommandBuffer cmd, uint32_t frameIndex, entt::r
     }
 
     uint32_t atlasSize = shadowSystem->getAtlasSize();
+    const vk::ClearAttachment depthClear{vk::ImageAspectFlagBits::eDepth, 0, vk::ClearDepthStencilValue{1.0f, 0}};
 
     // Bind shadow pipeline once
     shadowPipeline->bind(cmd);
@@ -90,47 +234,119 @@ void ShadowPass::executePass(vk::CommandBuffer cmd, uint32_t frameIndex, entt::r
             scissor.extent.width = static_cast<uint32_t>(viewport.width);
             scissor.extent.height = static_cast<uint32_t>(viewport.height);
             cmd.setScissor(0, 1, &scissor);
+            stats.views++;
 
-            // Render all objects from this cascade's perspective
-            Mesh* currentMesh = nullptr;
-
-            for (const auto& renderable : renderables) {
-                if (!renderable.mesh || !renderable.visible) continue;
-
-                // Bind vertex and index buffers if mesh changed
-                if (currentMesh != renderable.mesh) {
-                    currentMesh = renderable.mesh;
+            // Render this cascade's casters from its perspective
+            uint32_t firstCaster = 0;
+            uint32_t casterCount = static_cast<uint32_t>(renderables.size());
+            uint32_t staticCount = 0;
+            ShadowCacheMode mode = ShadowCacheMode::None;
+            if (perViewCasters) {
+                const ShadowView* view = shadowSystem->findView(static_cast<uint32_t>(i), c);
+                casterCount = view ? view->casterCount : 0;
+                firstCaster = view ? view->firstCaster : 0;
+                staticCount = view ? view->staticCount : 0;
+                mode = view && atlasRestored ? view->cacheMode : ShadowCacheMode::None;
 
-                    vk::Buffer vertexBuffer = currentMesh->getVertexBuffer().getBuffer();
-                    vk::DeviceSize offset = 0;
-                    cmd.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
-                    cmd.bindIndexBuffer(currentMesh->getIndexBuffer().getBuffer(), 0,
-                                       currentMesh->getIndexBuffer().getIndexType());
+                if (mode == ShadowCacheMode::Scroll) {
+                    // The shifted cache leaves strips along the edges it scrolled away from;
+                    // they are cleared first so the corner two strips share keeps its casters
+                    vk::Rect2D strips[2];
+                    uint32_t stripCount = 0;
+                    if (view->scroll.x != 0) {
+                        const uint32_t width = static_cast<uint32_t>(std::abs(view->scroll.x));
+                        strips[stripCount++] = vk::Rect2D{
+                            {scissor.offset.x + static_cast<int32_t>(view->scroll.x > 0 ? scissor.extent.width - width : 0),
+                             scissor.offset.y},
+                            {width, scissor.extent.height}};
+                    }
+                    if (view->scroll.y != 0) {
+                        const uint32_t height = static_cast<uint32_t>(std::abs(view->scroll.y));
+                        strips[stripCount++] = vk::Rect2D{
+                            {scissor.offset.x,
+                             scissor.offset.y + static_cast<int32_t>(view->scroll.y > 0 ? scissor.extent.height - height : 0)},
+                            {scissor.extent.width, height}};
+                    }
+                    for (uint32_t s = 0; s < stripCount; ++s) {
+                        const vk::ClearRect clearRect{strips[s], 0, 1};
+                        cmd.clearAttachments(1, &depthClear, 1, &clearRect);
+                    }
+                    for (uint32_t s = 0; s < stripCount; ++s) {
+                        cmd.setScissor(0, 1, &strips[s]);
+                        drawCasters(cmd, shadow.cascadeViewProjMatrices[c], firstCaster, staticCount, stats.drawCalls);
+                    }
+                    cmd.setScissor(0, 1, &scissor);
                 }
+            }
 
-                const SubMesh& subMesh = renderable.mesh->getSubMesh(renderable.subMeshIndex);
+            if (mode == ShadowCacheMode::None) {
+                // With the atlas restored from the cache it is loaded, not cleared
+                if (atlasRestored) {
+                    const vk::ClearRect clearRect{scissor, 0, 1};
+                    cmd.clearAttachments(1, &depthClear, 1, &clearRect);
+                }
+                drawCasters(cmd, shadow.cascadeViewProjMatrices[c], firstCaster, casterCount, stats.drawCalls);
+            } else {
+                // Static depth came from the cache; dynamic casters go on top
+                drawCasters(cmd, shadow.cascadeViewProjMatrices[c], firstCaster + staticCount,
+                            casterCount - staticCount, stats.drawCalls);
+            }
+        }
+    }
+}
 
-                // Push constants: light space matrix + model matrix
-                struct ShadowPushConstants {
-                    glm::mat4 lightSpaceMatrix;
-                    glm::mat4 model;
-                } push;
+void ShadowPass::drawCasters(vk::CommandBuffer cmd, const glm::mat4& lightSpaceMatrix, uint32_t first,
+                             uint32_t count, uint32_t& drawCalls) {
+    const auto& renderables = shadowSystem->getShadowRenderables();
+    const auto& viewCasterIndices = shadowSystem->getViewCasterIndices();
+    const bool perViewCasters = shadowSystem->hasViewCasters();
 
-                push.lightSpaceMatrix = shadow.cascadeViewProjMatrices[c];
-                push.model = renderable.worldTransform;
+    Mesh* currentMesh = nullptr;
+    for (uint32_t k = 0; k < count; ++k) {
+        const auto& renderable = renderables[perViewCasters ? viewCasterIndices[first + k] : first + k];
+        if (!renderable.mesh || !renderable.visible) continue;
 
-            cmd.pushConstants(
-                shadowPipeline->getPipelineLayout(),
-                vk::ShaderStageFlagBits::eVertex,
-                0,
-                sizeof(ShadowPushConstants),
-                &push
-            );
+        // Bind vertex and index buffers if mesh changed
+        if (currentMesh != renderable.mesh) {
+            currentMesh = renderable.mesh;
 
-            cmd.drawIndexed(subMesh.indexCount, 1, subMesh.firstIndex, 0, 0);
-            }
+            vk::Buffer vertexBuffer = currentMesh->getVertexBuffer().getBuffer();
+            vk::DeviceSize offset = 0;
+            cmd.bindVertexBuffers(0, 1, &vertexBuffer, &offset);
+            cmd.bindIndexBuffer(currentMesh->getIndexBuffer().getBuffer(), 0,
+                               currentMesh->getIndexBuffer().getIndexType());
+            stats.meshBinds++;
         }
+
+        const SubMesh& subMesh = renderable.mesh->getSubMesh(renderable.subMeshIndex);
+
+        // Push constants: light space matrix + model matrix
+        struct ShadowPushConstants {
+            glm::mat4 lightSpaceMatrix;
+            glm::mat4 model;
+        } push;
+
+        push.lightSpaceMatrix = lightSpaceMatrix;
+        push.model = renderable.worldTransform;
+
+        cmd.pushConstants(
+            shadowPipeline->getPipelineLayout(),
+            vk::ShaderStageFlagBits::eVertex,
+            0,
+            sizeof(ShadowPushConstants),
+            &push
+        );
+
+        cmd.drawIndexed(subMesh.indexCount, 1, subMesh.firstIndex, 0, 0);
+        drawCalls++;
     }
 }
 
+vk::Rect2D ShadowPass::getAtlasRect(const ShadowView& view) const {
+    const glm::vec4& rect = shadowSystem->getShadowData()[view.shadowIndex].atlasRects[view.slot];
+    const float atlasSize = static_cast<float>(shadowSystem->getAtlasSize());
+    return vk::Rect2D{{static_cast<int32_t>(rect.x * atlasSize), static_cast<int32_t>(rect.y * atlasSize)},
+                      {static_cast<uint32_t>(rect.z * atlasSize), static_cast<uint32_t>(rect.w * atlasSize)}};
+}
+
 } // namespace violet
\ No newline at end of file
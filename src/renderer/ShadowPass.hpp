@@ -5,6 +5,7 @@
 #include <EASTL/vector.h>
 #include <EASTL/unique_ptr.h>
 #include <entt/entt.hpp>
+#include <glm/glm.hpp>
 
 namespace violet {
 
@@ -15,6 +16,15 @@ class LightingSystem;
 class ShaderLibrary;
 class GraphicsPipeline;
 class DescriptorManager;
+struct ShadowView;
+
+// Work of the last executePass
+struct ShadowPassStats {
+    uint32_t views      = 0;  // Cascades rendered
+    uint32_t drawCalls  = 0;
+    uint32_t meshBinds  = 0;  // Vertex/index buffer binds
+    uint32_t cacheDraws = 0;  // Static casters drawn into the static cache
+};
 
 class ShadowPass {
 public:
@@ -23,9 +33,22 @@ public:
               RenderGraph* renderGraph, const eastl::string& atlasImageName);
     void cleanup();
 
+    // Static shadow cache work of the frame, recorded ahead of the render graph: rebaked views
+    // get their static casters drawn into the cache atlas, then every cached view is copied into
+    // the shadow atlas. Returns whether the atlas was written; it is then left in
+    // TransferDstOptimal and the shadow pass loads it instead of clearing.
+    bool recordStaticCache(vk::CommandBuffer cmd);
+    bool isAtlasRestored() const { return atlasRestored; }
+
     void executePass(vk::CommandBuffer cmd, uint32_t frameIndex, entt::registry& world);
 
+    const ShadowPassStats& getStats() const { return stats; }
+
 private:
+    void drawCasters(vk::CommandBuffer cmd, const glm::mat4& lightSpaceMatrix, uint32_t first, uint32_t count,
+                     uint32_t& drawCalls);
+    vk::Rect2D getAtlasRect(const ShadowView& view) const;
+
     VulkanContext* context = nullptr;
     DescriptorManager* descriptorManager = nullptr;
     ShaderLibrary* shaderLibrary = nullptr;
@@ -35,6 +58,9 @@ private:
 
     eastl::unique_ptr<GraphicsPipeline> shadowPipeline;
     eastl::string atlasImageName;
+    ShadowPassStats stats;
+    bool atlasRestored = false;
+    bool cacheInitialized = false;  // Cache atlas left in TransferSrcOptimal by an earlier bake
 };
 
 } // namespace violet
\ No newline at end of file
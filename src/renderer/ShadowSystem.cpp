@@ -1,5 +1,7 @@
 #include "ShadowSystem.hpp"
 #include "LightingSystem.hpp"
+#include "acceleration/BVH.hpp"
+#include "math/ScreenSize.hpp"
 #include "ecs/Components.hpp"
 #include "renderer/vulkan/VulkanContext.hpp"
 #include "renderer/vulkan/DescriptorManager.hpp"
@@ -9,6 +11,9 @@
 #include "resource/TextureManager.hpp"
 #include "resource/Texture.hpp"
 #include "core/Log.hpp"
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+#include <bit>
 #include <cmath>
 
 namespace {
@@ -60,6 +65,57 @@ namespace {
 
         return splits;
     }
+
+    // Atlas allocations and static cache entries are keyed by light entity and cascade or face
+    uint64_t shadowKey(entt::entity entity, uint32_t slot) {
+        return (static_cast<uint64_t>(entt::to_integral(entity)) << 8) | slot;
+    }
+
+    // Cascades per directional light: CSM needs a perspective camera
+    uint32_t getCascadeCount(const violet::LightComponent& light, violet::Camera* camera) {
+        const bool perspective = dynamic_cast<violet::PerspectiveCamera*>(camera) != nullptr;
+        return eastl::min(perspective && light.cascadeCount > 1 ? light.cascadeCount : 1u, 4u);
+    }
+
+    // FNV-1a, chained through seed
+    uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            seed = (seed ^ bytes[i]) * 1099511628211ull;
+        }
+        return seed;
+    }
+
+    template<typename T>
+    uint64_t hashValue(const T& value, uint64_t seed = 14695981039346656037ull) {
+        return hashBytes(&value, sizeof(T), seed);
+    }
+
+    // Whether current differs from baked only by a whole-texel shift across the light, i.e. the
+    // cached depth is still valid once moved by scroll texels (atlas texel (x, y) holds cached
+    // texel (x, y) + scroll)
+    bool findCacheScroll(const glm::mat4& baked, const glm::mat4& current, uint32_t resolution, glm::ivec2& scroll) {
+        const glm::mat4 delta = current * glm::inverse(baked);
+        for (int c = 0; c < 3; ++c) {
+            for (int r = 0; r < 3; ++r) {
+                if (std::abs(delta[c][r] - (c == r ? 1.0f : 0.0f)) > 1e-4f) {
+                    return false;
+                }
+            }
+        }
+        if (std::abs(delta[3][2]) > 1e-5f) {
+            return false;  // Depths moved
+        }
+
+        // NDC shift to texels; the viewport maps both axes the same way
+        const glm::vec2 shift   = glm::vec2(delta[3][0], delta[3][1]) * (0.5f * static_cast<float>(resolution));
+        const glm::vec2 rounded = glm::round(shift);
+        if (std::abs(shift.x - rounded.x) > 0.01f || std::abs(shift.y - rounded.y) > 0.01f) {
+            return false;
+        }
+        scroll = -glm::ivec2(rounded);
+        return true;
+    }
 }
 
 namespace violet {
@@ -88,10 +144,18 @@ void ShadowSystem::init(VulkanContext* ctx, DescriptorManager* descMgr, TextureM
         descriptorManager->updateSet(descriptorSets[i], bindings);
     }
 
+    // The atlas may grow to the device limit (16k at most, 1 GiB of D32)
+    const vk::PhysicalDeviceProperties properties = context->getPhysicalDevice().getProperties();
+    maxAtlasSize  = eastl::max(eastl::min(properties.limits.maxImageDimension2D, 16384u), atlasSize);
+    baseAtlasSize = atlasSize;
+    atlasPacker.init(atlasSize, MIN_SHADOW_RESOLUTION);
     createAtlas();
 
-    violet::Log::info("ShadowSystem", "Initialized (atlas: {}x{}, capacity: {})",
-                      atlasSize, atlasSize, INITIAL_CAPACITY);
+    cachePacker.init(cacheSize, MIN_SHADOW_RESOLUTION);
+    createCacheAtlas();
+
+    violet::Log::info("ShadowSystem", "Initialized (atlas: {}x{}, static cache: {}x{}, capacity: {})",
+                      atlasSize, atlasSize, cacheSize, cacheSize, INITIAL_CAPACITY);
 }
 
 void ShadowSystem::cleanup() {
@@ -108,87 +172,86 @@ void ShadowSystem::cleanup() {
         textureManager->removeTexture(atlasTextureHandle);
         atlasTextureHandle = TextureHandle{};
     }
+    if (cacheTextureHandle.isValid() && textureManager) {
+        textureManager->removeTexture(cacheTextureHandle);
+        cacheTextureHandle = TextureHandle{};
+    }
+    resetStaticCache();
+    casterMotion.clear();
 
     shadowBuffers.clear();
     cpuShadowData.clear();
-    allocations.clear();
+    atlasSlots.clear();
+    atlasPacker.clear();
 
     context = nullptr;
     descriptorManager = nullptr;
     textureManager = nullptr;
 }
 
-void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem, Camera* camera, uint32_t frameIndex, const AABB& sceneBounds) {
+void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem, Camera* camera, uint32_t frameIndex,
+                          const AABB& sceneBounds, const BVH* sceneBVH, const eastl::vector<Renderable>* sceneRenderables,
+                          const Frustum* cameraFrustum, eastl::vector<uint32_t>* cameraVisible) {
     cpuShadowData.clear();
-    clearAllAllocations();
     shadowRenderables.clear();
+    views.clear();
+    shadowFirstView.clear();
+    viewCasterIndices.clear();
+    viewCastersValid = false;
+    casterCullStats = BVHCullStats{};
+    smallCastersCulled = 0;
+    ++updateCount;
 
     if (!camera) {
         violet::Log::warn("ShadowSystem", "No active camera, skipping shadow update");
         return;
     }
 
-    // Collect ALL potentially shadow-casting objects from the world
-    // (Not camera-frustum culled - we need objects outside camera view that can still cast shadows into it)
-    auto entityView = world.view<TransformComponent, MeshComponent>();
-    for (auto entity : entityView) {
-        auto& transform = entityView.get<TransformComponent>(entity);
-        auto& meshComp = entityView.get<MeshComponent>(entity);
-
-        if (!meshComp.mesh) continue;
-
-        Mesh* mesh = meshComp.mesh.get();
-        glm::mat4 worldTransform = transform.world.getMatrix();
-
-        // Update world bounds if needed
-        if (meshComp.dirty || transform.dirty) {
-            meshComp.updateWorldBounds(worldTransform);
-        }
-
-        const auto& subMeshes = mesh->getSubMeshes();
-        for (size_t i = 0; i < subMeshes.size(); ++i) {
-            const SubMesh& subMesh = subMeshes[i];
-            if (!subMesh.isValid()) continue;
-
-            // Get material for this submesh
-            Material* material = nullptr;
-            if (auto* matComp = world.try_get<MaterialComponent>(entity)) {
-                // TODO: Get actual material from MaterialComponent
-                // For now, we'll add all objects as potential shadow casters
-            }
-
-            Renderable renderable(
-                entity,
-                mesh,
-                material,
-                worldTransform,
-                static_cast<uint32_t>(i)
-            );
-            renderable.visible = true;
-            shadowRenderables.push_back(renderable);
-        }
+    // With a scene BVH matching the renderables, casters are culled per shadow view once all
+    // views are known; otherwise every mesh in the world is a potential caster
+    const bool queryCasters = sceneBVH && sceneRenderables && sceneBVH->getPrimitiveCount() > 0 &&
+                              sceneBVH->getPrimitiveCount() == sceneRenderables->size();
+    if (!queryCasters) {
+        collectAllCasters(world);
     }
 
+    // Every shadow map gets its square of the atlas up front, so space goes by importance rather
+    // than light order
+    gatherAtlasRequests(world, lightingSystem, camera, sceneBounds);
+    packAtlas();
+
     auto& lightData = lightingSystem.getLightData();
 
     // Get camera matrices for frustum calculation
     const glm::mat4 view = camera->getViewMatrix();
     const glm::mat4 proj = camera->getProjectionMatrix();
 
-    // Collect shadow-casting lights
-    uint32_t lightIndex = 0;
-    auto lightView = world.view<LightComponent, TransformComponent>();
-
-    for (auto entity : lightView) {
-        const auto& light = lightView.get<LightComponent>(entity);
-        const auto& transform = lightView.get<TransformComponent>(entity);
+    // Collect shadow-casting lights, in the order LightingSystem emitted them
+    const auto& lightEntities = lightingSystem.getLightEntities();
 
-        if (!light.enabled || !light.castsShadows) {
-            lightIndex++;
+    for (uint32_t lightIndex = 0; lightIndex < lightData.size() && lightIndex < lightEntities.size(); ++lightIndex) {
+        const entt::entity entity = lightEntities[lightIndex];
+        const auto* lightPtr      = world.try_get<LightComponent>(entity);
+        const auto* transformPtr  = world.try_get<TransformComponent>(entity);
+        if (!lightPtr || !transformPtr || !lightPtr->enabled || !lightPtr->castsShadows) {
             continue;
         }
-
-        if (lightIndex >= lightData.size()) break;
+        const auto& light     = *lightPtr;
+        const auto& transform = *transformPtr;
+        const uint32_t shadowIndex = static_cast<uint32_t>(cpuShadowData.size());
+        const uint32_t firstView   = static_cast<uint32_t>(views.size());
+
+        // Everything the light's shadow depth depends on besides the camera and the casters
+        uint64_t lightHash = hashValue(entity);
+        lightHash = hashValue(light.type, lightHash);
+        lightHash = hashValue(light.direction, lightHash);
+        lightHash = hashValue(transform.world.position, lightHash);
+        lightHash = hashValue(light.radius, lightHash);
+        lightHash = hashValue(light.shadowResolution, lightHash);
+        lightHash = hashValue(light.shadowNearPlane, lightHash);
+        lightHash = hashValue(light.shadowFarPlane, lightHash);
+        lightHash = hashValue(light.cascadeCount, lightHash);
+        lightHash = hashValue(light.cascadeSplitLambda, lightHash);
 
         // Build shadow data
         ShadowData shadowData{};
@@ -203,8 +266,7 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
 
             // Try to use CSM if camera is PerspectiveCamera
             PerspectiveCamera* perspCam = dynamic_cast<PerspectiveCamera*>(camera);
-            uint32_t cascadeCount = (perspCam && light.cascadeCount > 1) ? light.cascadeCount : 1;
-            cascadeCount = eastl::min(cascadeCount, 4u);  // Max 4 cascades
+            uint32_t cascadeCount = getCascadeCount(light, camera);  // Max 4 cascades
             shadowData.cascadeCount = cascadeCount;
 
             // Calculate cascade split depths
@@ -214,6 +276,13 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
 
             // For each cascade, compute light space matrix and allocate atlas space
             for (uint32_t c = 0; c < cascadeCount; c++) {
+                const uint32_t cascadeAllocation = findAtlasAllocation(shadowKey(entity, c));
+                if (cascadeAllocation == ShadowAtlasPacker::INVALID) {
+                    // Dropped for lack of atlas space, skip remaining cascades
+                    shadowData.cascadeCount = c;
+                    break;
+                }
+
                 // Create projection matrix for this cascade's frustum slice
                 float cascadeNear = splits[c];
                 float cascadeFar = splits[c + 1];
@@ -233,19 +302,10 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
                 // Get frustum corners for this cascade
                 auto frustumCorners = getFrustumCornersWorldSpace(cascadeProj, view);
 
-                // Compute frustum center
-                glm::vec3 center = glm::vec3(0.0f);
-                for (const auto& corner : frustumCorners) {
-                    center += corner;
-                }
-                center /= frustumCorners.size();
-
-                // Build light view matrix looking at cascade frustum center
-                glm::mat4 lightViewMatrix = glm::lookAt(
-                    center - lightDir * light.shadowFarPlane,  // Position light behind frustum
-                    center,                                     // Look at frustum center
-                    up
-                );
+                // Light space is anchored at the world origin rather than at the cascade: with the
+                // bounds snapped below, a moving camera then scrolls the cascade by whole texels
+                // and leaves its depths unchanged, which the static shadow cache relies on
+                glm::mat4 lightViewMatrix = glm::lookAt(glm::vec3(0.0f), lightDir, up);
 
                 // Transform frustum corners to light space and find bounds
                 float minX = std::numeric_limits<float>::max();
@@ -328,15 +388,17 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
                 maxX = std::ceil(maxX / quantize) * quantize;
                 minY = std::floor(minY / quantize) * quantize;
                 maxY = std::ceil(maxY / quantize) * quantize;
+                // The depth range too, so cached static depth survives small camera moves
+                minZ = std::floor(minZ / quantize) * quantize;
+                maxZ = std::ceil(maxZ / quantize) * quantize;
 
                 // Calculate projection dimensions
                 float projWidth = maxX - minX;
                 float projHeight = maxY - minY;
 
                 // ============= Optimization 3: Texel Snapping to Prevent Shimmer =============
-                // Get cascade resolution for texel size calculation
-                uint32_t cascadeResolution = light.shadowResolution >> c;
-                cascadeResolution = eastl::max(cascadeResolution, 256u);
+                // Get cascade resolution for texel size calculation (the atlas may have downgraded it)
+                const uint32_t cascadeResolution = atlasPacker.getSize(cascadeAllocation);
 
                 // Calculate texel size in light space
                 float texelSizeX = projWidth / cascadeResolution;
@@ -350,20 +412,17 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
                 maxX = minX + projWidth;
                 maxY = minY + projHeight;
 
-                // Build stabilized orthographic projection
-                glm::mat4 lightProjMatrix = glm::ortho(minX, maxX, minY, maxY, minZ, maxZ);
+                // Build stabilized orthographic projection (light space looks down -Z, so the
+                // near and far distances are the negated Z bounds)
+                glm::mat4 lightProjMatrix = glm::ortho(minX, maxX, minY, maxY, -maxZ, -minZ);
                 shadowData.cascadeViewProjMatrices[c] = lightProjMatrix * lightViewMatrix;
 
-                // Allocate atlas space for this cascade
-                auto cascadeAlloc = allocateSpace(cascadeResolution, lightIndex * 10 + c);
-
-                if (!cascadeAlloc.inUse) {
-                    // Atlas full, skip remaining cascades
-                    shadowData.cascadeCount = c;
-                    break;
-                }
+                shadowData.atlasRects[c] = getAtlasRect(cascadeAllocation);
 
-                shadowData.atlasRects[c] = cascadeAlloc.rect;
+                addView(shadowIndex, c, shadowData.cascadeViewProjMatrices[c], cascadeResolution,
+                        ScreenSizeTest::fromProjection(lightProjMatrix, glm::vec3(0.0f),
+                                                       static_cast<float>(cascadeResolution),
+                                                       static_cast<float>(cascadeResolution), minCasterTexels));
 
                 // Store cascade split depth (view space Z, which is negative in right-handed view space)
                 // We store the far plane of each cascade
@@ -375,7 +434,7 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
             // ============= Static Fallback Cascade (Entire Scene AABB) =============
             // Add a fallback cascade covering the entire scene as insurance
             if (sceneBounds.isValid() && cascadeCount < 4) {
-                uint32_t fallbackIdx = cascadeCount;
+                uint32_t fallbackIdx = shadowData.cascadeCount;
 
                 // Center of scene AABB
                 glm::vec3 sceneCenter = (sceneBounds.min + sceneBounds.max) * 0.5f;
@@ -411,16 +470,22 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
                     }
                 }
 
-                // Orthographic projection covering entire scene
-                glm::mat4 lightProj = glm::ortho(minX, maxX, minY, maxY, minZ, maxZ);
+                // Orthographic projection covering entire scene (light space looks down -Z)
+                glm::mat4 lightProj = glm::ortho(minX, maxX, minY, maxY, -maxZ, -minZ);
                 shadowData.cascadeViewProjMatrices[fallbackIdx] = lightProj * lightView;
 
-                // Allocate atlas space
-                auto fallbackAlloc = allocateSpace(1024, lightIndex * 10 + fallbackIdx);
-                if (fallbackAlloc.inUse) {
-                    shadowData.atlasRects[fallbackIdx] = fallbackAlloc.rect;
+                const uint32_t fallbackAllocation = findAtlasAllocation(shadowKey(entity, FALLBACK_CASCADE_SLOT));
+                if (fallbackAllocation != ShadowAtlasPacker::INVALID) {
+                    const uint32_t fallbackResolution = atlasPacker.getSize(fallbackAllocation);
+                    shadowData.atlasRects[fallbackIdx] = getAtlasRect(fallbackAllocation);
                     shadowData.cascadeSplitDepths[fallbackIdx] = FLT_MAX;  // Always use as last resort
                     shadowData.cascadeCount++;
+
+                    addView(shadowIndex, fallbackIdx, shadowData.cascadeViewProjMatrices[fallbackIdx],
+                            fallbackResolution, ScreenSizeTest::fromProjection(lightProj, glm::vec3(0.0f),
+                                                           static_cast<float>(fallbackResolution),
+                                                           static_cast<float>(fallbackResolution),
+                                                           minCasterTexels));
                 }
             }
 
@@ -429,15 +494,13 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
             // Point light: allocate single cubemap space in atlas
             shadowData.cascadeCount = 1;
 
-            uint32_t resolution = light.shadowResolution;
-            auto alloc = allocateSpace(resolution, lightIndex);
-
-            if (!alloc.inUse) {
-                lightIndex++;
-                continue; // Atlas full, skip this point light
+            const uint32_t allocation = findAtlasAllocation(shadowKey(entity, 0));
+            if (allocation == ShadowAtlasPacker::INVALID) {
+                continue; // Dropped for lack of atlas space, skip this point light
             }
 
-            shadowData.atlasRects[0] = alloc.rect;
+            const uint32_t resolution = atlasPacker.getSize(allocation);
+            shadowData.atlasRects[0] = getAtlasRect(allocation);
 
             // Generate 6 cube face matrices
             glm::vec3 lightPos = transform.world.position;
@@ -446,6 +509,10 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
 
             glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, farPlane);
 
+            // Every cube face has the same projection, so one size test covers all six
+            const ScreenSizeTest faceSizeTest = ScreenSizeTest::fromProjection(
+                projection, lightPos, static_cast<float>(resolution), static_cast<float>(resolution), minCasterTexels);
+
             glm::vec3 directions[6] = {
                 {1, 0, 0}, {-1, 0, 0},
                 {0, 1, 0}, {0, -1, 0},
@@ -460,28 +527,356 @@ void ShadowSystem::update(entt::registry& world, LightingSystem& lightingSystem,
             for (int i = 0; i < 6; i++) {
                 glm::mat4 view = glm::lookAt(lightPos, lightPos + directions[i], ups[i]);
                 shadowData.cubeFaceMatrices[i] = projection * view;
+                addView(shadowIndex, static_cast<uint32_t>(i), shadowData.cubeFaceMatrices[i], resolution,
+                        faceSizeTest);
             }
         }
 
-        uint32_t shadowIndex = static_cast<uint32_t>(cpuShadowData.size());
+        // Only directional views are cached: ShadowPass does not render cube faces yet
+        for (uint32_t v = firstView; v < views.size(); ++v) {
+            views[v].lightHash = lightHash;
+            views[v].cacheKey  = shadowKey(entity, views[v].slot);
+            views[v].cacheable = light.type == LightType::Directional;
+        }
+
         cpuShadowData.push_back(shadowData);
+        shadowFirstView.push_back(firstView);
 
         // Update light's shadow index
         lightingSystem.getLightData()[lightIndex].shadowIndex = static_cast<int32_t>(shadowIndex);
 
-        lightIndex++;
-
         if (cpuShadowData.size() >= MAX_SHADOWS) {
             violet::Log::warn("ShadowSystem", "Reached MAX_SHADOWS ({})", MAX_SHADOWS);
             break;
         }
     }
 
+    if (queryCasters) {
+        trackCasterMotion(*sceneBVH, *sceneRenderables);
+        cullViewCasters(*sceneBVH, *sceneRenderables, cameraFrustum, cameraVisible);
+    }
+    updateStaticCache();
+
     if (!cpuShadowData.empty()) {
         ensureBufferCapacity(static_cast<uint32_t>(cpuShadowData.size()));
     }
 }
 
+void ShadowSystem::addView(uint32_t shadowIndex, uint32_t slot, const glm::mat4& viewProj, uint32_t resolution,
+                           const ScreenSizeTest& sizeTest) {
+    ShadowView view;
+    view.frustum.extract(viewProj);
+    view.depthPlane = view.frustum.planes[4];
+    // Frustum culling tests the first five planes; the far plane takes the near plane's slot
+    eastl::swap(view.frustum.planes[4], view.frustum.planes[5]);
+    view.sizeTest    = sizeTest;
+    view.shadowIndex = shadowIndex;
+    view.slot        = slot;
+    view.viewProj    = viewProj;
+    view.resolution  = resolution;
+    views.push_back(view);
+}
+
+const ShadowView* ShadowSystem::findView(uint32_t shadowIndex, uint32_t slot) const {
+    if (shadowIndex >= shadowFirstView.size()) {
+        return nullptr;
+    }
+    // At most six views per shadow
+    for (uint32_t i = shadowFirstView[shadowIndex]; i < views.size() && views[i].shadowIndex == shadowIndex; ++i) {
+        if (views[i].slot == slot) {
+            return &views[i];
+        }
+    }
+    return nullptr;
+}
+
+void ShadowSystem::cullViewCasters(const BVH& sceneBVH, const eastl::vector<Renderable>& sceneRenderables,
+                                   const Frustum* cameraFrustum, eastl::vector<uint32_t>* cameraVisible) {
+    casterSlots.assign(sceneRenderables.size(), 0);
+
+    // Views go through the tree MAX_CULL_VIEWS at a time (the camera takes a bit of the first
+    // batch); a primitive is reached once per batch however many views see it
+    Frustum frusta[BVH::MAX_CULL_VIEWS];
+    bool cameraPending = cameraFrustum && cameraVisible;
+    uint32_t nextView = 0;
+    while (nextView < views.size() || cameraPending) {
+        const uint32_t base      = cameraPending ? 1 : 0;
+        const uint32_t viewCount = eastl::min(static_cast<uint32_t>(views.size()) - nextView,
+                                              BVH::MAX_CULL_VIEWS - base);
+        if (cameraPending) {
+            frusta[0] = *cameraFrustum;
+        }
+        for (uint32_t i = 0; i < viewCount; ++i) {
+            frusta[base + i] = views[nextView + i].frustum;
+        }
+
+        // Casters too small in a view lose that view's bit right away
+        uint32_t counts[BVH::MAX_CULL_VIEWS] = {};
+        casterHits.clear();
+        sceneBVH.cullFrusta(frusta, base + viewCount, [&](uint32_t primitiveIndex, uint32_t viewMask) {
+            if (cameraPending && (viewMask & 1u)) {
+                cameraVisible->push_back(primitiveIndex);
+            }
+            uint32_t shadowMask = viewMask >> base;
+            for (uint32_t bits = shadowMask; bits; bits &= bits - 1) {
+                uint32_t i = static_cast<uint32_t>(std::countr_zero(bits));
+                const ScreenSizeTest& sizeTest = views[nextView + i].sizeTest;
+                if (sizeTest.isEnabled() && !sizeTest.test(sceneBVH.getPrimitiveBounds(primitiveIndex))) {
+                    shadowMask &= ~(1u << i);
+                    ++smallCastersCulled;
+                    continue;
+                }
+                ++counts[i];
+            }
+            if (shadowMask) {
+                casterHits.push_back({primitiveIndex, shadowMask});
+            }
+        }, &casterCullStats);
+
+        // Lay the batch's lists out contiguously, then scatter the hits into them
+        uint32_t cursor[BVH::MAX_CULL_VIEWS];
+        uint32_t offset = static_cast<uint32_t>(viewCasterIndices.size());
+        for (uint32_t i = 0; i < viewCount; ++i) {
+            views[nextView + i].firstCaster = offset;
+            views[nextView + i].casterCount = counts[i];
+            views[nextView + i].staticCount = 0;
+            cursor[i] = offset;
+            offset += counts[i];
+        }
+        viewCasterIndices.resize(offset);
+        casterOrder.resize(offset);
+
+        for (const auto& [primitiveIndex, shadowMask] : casterHits) {
+            uint32_t& slot = casterSlots[primitiveIndex];
+            if (!slot) {
+                shadowRenderables.push_back(sceneRenderables[primitiveIndex]);
+                shadowRenderables.back().visible = true;  // Camera visibility does not apply to casters
+                slot = static_cast<uint32_t>(shadowRenderables.size());
+            }
+            const uintptr_t mesh   = reinterpret_cast<uintptr_t>(sceneRenderables[primitiveIndex].mesh);
+            const glm::vec3 center = sceneBVH.getPrimitiveBounds(primitiveIndex).center();
+            const bool isStatic    = isStaticCaster(sceneRenderables[primitiveIndex].entity);
+            for (uint32_t bits = shadowMask; bits; bits &= bits - 1) {
+                uint32_t i = static_cast<uint32_t>(std::countr_zero(bits));
+                ShadowView& view = views[nextView + i];
+                const glm::vec4& plane = view.depthPlane;
+                casterOrder[cursor[i]++] = {mesh, glm::dot(glm::vec3(plane), center) + plane.w, slot - 1, isStatic};
+                view.staticCount += isStatic ? 1 : 0;
+            }
+        }
+        for (uint32_t i = 0; i < viewCount; ++i) {
+            sortViewCasters(views[nextView + i]);
+        }
+
+        nextView += viewCount;
+        cameraPending = false;
+    }
+    viewCastersValid = true;
+}
+
+void ShadowSystem::sortViewCasters(const ShadowView& view) {
+    auto first = casterOrder.begin() + view.firstCaster;
+    auto last  = first + view.casterCount;
+    eastl::sort(first, last, [](const CasterSortEntry& a, const CasterSortEntry& b) {
+        if (a.isStatic != b.isStatic) {
+            return a.isStatic;
+        }
+        return a.mesh != b.mesh ? a.mesh < b.mesh : a.depth < b.depth;
+    });
+
+    // Static casters first (the cache bakes them on their own), then within each part mesh
+    // groups front to back by their nearest caster
+    meshGroups.clear();
+    for (auto group = first; group != last;) {
+        auto end = group;
+        while (end != last && end->mesh == group->mesh && end->isStatic == group->isStatic) {
+            ++end;
+        }
+        meshGroups.push_back({group->depth, static_cast<uint32_t>(group - casterOrder.begin()),
+                              static_cast<uint32_t>(end - group)});
+        group = end;
+    }
+    const uint32_t staticGroups = static_cast<uint32_t>(
+        eastl::find_if(meshGroups.begin(), meshGroups.end(),
+                       [this](const MeshGroup& g) { return !casterOrder[g.first].isStatic; }) - meshGroups.begin());
+    auto byDepth = [](const MeshGroup& a, const MeshGroup& b) { return a.depth < b.depth; };
+    eastl::sort(meshGroups.begin(), meshGroups.begin() + staticGroups, byDepth);
+    eastl::sort(meshGroups.begin() + staticGroups, meshGroups.end(), byDepth);
+
+    uint32_t out = view.firstCaster;
+    for (const MeshGroup& group : meshGroups) {
+        for (uint32_t k = 0; k < group.count; ++k) {
+            viewCasterIndices[out++] = casterOrder[group.first + k].caster;
+        }
+    }
+}
+
+void ShadowSystem::trackCasterMotion(const BVH& sceneBVH, const eastl::vector<Renderable>& sceneRenderables) {
+    cacheInvalidations.clear();
+
+    // Added or removed renderables may take baked static depth with them. The count alone
+    // misses a caster replaced by another in the same frame, so any rebuild of the set counts.
+    if (sceneGeneration != cachedSceneGeneration) {
+        cachedSceneGeneration = sceneGeneration;
+        for (auto& [key, entry] : staticCache) {
+            entry.valid = false;
+        }
+    }
+
+    for (uint32_t i = 0; i < sceneRenderables.size(); ++i) {
+        const Renderable& renderable = sceneRenderables[i];
+        const uint32_t entityIndex = static_cast<uint32_t>(entt::to_entity(renderable.entity));
+        if (entityIndex >= casterMotion.size()) {
+            casterMotion.resize(entityIndex + 1);
+        }
+        CasterMotion& motion = casterMotion[entityIndex];
+
+        if (renderable.dirty || motion.lastMoved == 0) {
+            // A static caster starting to move leaves its baked depth behind
+            if (motion.lastMoved != 0 && updateCount - motion.lastMoved > STATIC_CASTER_FRAMES) {
+                cacheInvalidations.push_back(motion.staticBounds);
+            }
+            motion.lastMoved = updateCount;
+        } else if (updateCount - motion.lastMoved == STATIC_CASTER_FRAMES) {
+            // Settled this update: every submesh adds its bounds, then views around it rebake
+            const AABB& bounds = sceneBVH.getPrimitiveBounds(i);
+            if (motion.staticSince != updateCount) {
+                motion.staticSince  = updateCount;
+                motion.staticBounds = bounds;
+            } else {
+                motion.staticBounds.expand(bounds);
+            }
+            cacheInvalidations.push_back(bounds);
+        }
+    }
+}
+
+bool ShadowSystem::isStaticCaster(entt::entity entity) const {
+    const uint32_t entityIndex = static_cast<uint32_t>(entt::to_entity(entity));
+    if (entityIndex >= casterMotion.size()) {
+        return false;
+    }
+    const CasterMotion& motion = casterMotion[entityIndex];
+    return motion.lastMoved != 0 && updateCount - motion.lastMoved >= STATIC_CASTER_FRAMES;
+}
+
+void ShadowSystem::updateStaticCache() {
+    cacheStats = ShadowCacheStats{};
+
+    // Entries of lights or cascades that went away give their space back
+    for (auto it = staticCache.begin(); it != staticCache.end();) {
+        if (updateCount - it->second.lastUsed > CACHE_EVICT_FRAMES) {
+            cachePacker.free(it->second.allocation);
+            it = staticCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const AABB& bounds : cacheInvalidations) {
+        for (auto& [key, entry] : staticCache) {
+            if (entry.valid && entry.frustum.testAABB(bounds)) {
+                entry.valid = false;
+            }
+        }
+    }
+
+    for (ShadowView& view : views) {
+        view.cacheMode = ShadowCacheMode::None;
+        if (!staticCachingEnabled || !cacheTextureHandle.isValid() || !viewCastersValid || !view.cacheable ||
+            view.staticCount == 0 || view.resolution > cacheSize) {
+            ++cacheStats.uncached;
+            continue;
+        }
+
+        StaticCacheEntry& entry = staticCache[view.cacheKey];
+        if (entry.resolution != view.resolution) {
+            // New view or a resolution change
+            cachePacker.free(entry.allocation);
+            entry = StaticCacheEntry{};
+            entry.allocation = cachePacker.allocate(view.resolution);
+            if (entry.allocation == ShadowAtlasPacker::INVALID) {
+                staticCache.erase(view.cacheKey);
+                ++cacheStats.uncached;
+                continue;
+            }
+            entry.offset     = cachePacker.getOffset(entry.allocation);
+            entry.resolution = view.resolution;
+        }
+        entry.lastUsed   = updateCount;
+        view.cacheOffset = entry.offset;
+
+        glm::ivec2 scroll(0);
+        const bool current = entry.valid && entry.lightHash == view.lightHash &&
+                             findCacheScroll(entry.viewProj, view.viewProj, view.resolution, scroll);
+        const uint32_t scrollLimit = view.resolution / MAX_CACHE_SCROLL_DIVISOR;
+        if (current && scroll == glm::ivec2(0)) {
+            view.cacheMode = ShadowCacheMode::Reuse;
+            ++cacheStats.reused;
+        } else if (current && static_cast<uint32_t>(std::abs(scroll.x)) <= scrollLimit &&
+                   static_cast<uint32_t>(std::abs(scroll.y)) <= scrollLimit) {
+            view.cacheMode = ShadowCacheMode::Scroll;
+            view.scroll    = scroll;
+            ++cacheStats.scrolled;
+        } else {
+            view.cacheMode  = ShadowCacheMode::Rebake;
+            entry.frustum   = view.frustum;
+            entry.viewProj  = view.viewProj;
+            entry.lightHash = view.lightHash;
+            entry.valid     = true;
+            ++cacheStats.rebaked;
+        }
+    }
+}
+
+void ShadowSystem::resetStaticCache() {
+    staticCache.clear();
+    cachePacker.clear();
+}
+
+void ShadowSystem::collectAllCasters(entt::registry& world) {
+    // Collect ALL potentially shadow-casting objects from the world
+    // (Not camera-frustum culled - we need objects outside camera view that can still cast shadows into it)
+    auto entityView = world.view<TransformComponent, MeshComponent>();
+    for (auto entity : entityView) {
+        auto& transform = entityView.get<TransformComponent>(entity);
+        auto& meshComp = entityView.get<MeshComponent>(entity);
+
+        if (!meshComp.mesh) continue;
+
+        Mesh* mesh = meshComp.mesh.get();
+        glm::mat4 worldTransform = transform.worldMatrix;
+
+        // Update world bounds if needed
+        if (meshComp.dirty || transform.dirty) {
+            meshComp.updateWorldBounds(worldTransform);
+        }
+
+        const auto& subMeshes = mesh->getSubMeshes();
+        for (size_t i = 0; i < subMeshes.size(); ++i) {
+            const SubMesh& subMesh = subMeshes[i];
+            if (!subMesh.isValid()) continue;
+
+            // Get material for this submesh
+            Material* material = nullptr;
+            if (auto* matComp = world.try_get<MaterialComponent>(entity)) {
+                // TODO: Get actual material from MaterialComponent
+                // For now, we'll add all objects as potential shadow casters
+            }
+
+            Renderable renderable(
+                entity,
+                mesh,
+                material,
+                worldTransform,
+                static_cast<uint32_t>(i)
+            );
+            renderable.visible = true;
+            shadowRenderables.push_back(renderable);
+        }
+    }
+}
+
 void ShadowSystem::uploadToGPU(uint32_t frameIndex) {
     if (frameIndex >= maxFramesInFlight || cpuShadowData.empty()) {
         return;
@@ -503,70 +898,285 @@ vk::DescriptorSet ShadowSystem::getDescriptorSet(uint32_t frameIndex) const {
     return descriptorSets[frameIndex];
 }
 
-ShadowAtlasAllocation ShadowSystem::allocateSpace(uint32_t resolution, uint32_t lightIndex) {
-    // Simple linear packing algorithm
-    // TODO: Implement proper rectangle packing (shelf algorithm or guillotine)
-
-    uint32_t currentX = 0;
-    uint32_t currentY = 0;
-    uint32_t rowHeight = 0;
+void ShadowSystem::gatherAtlasRequests(entt::registry& world, LightingSystem& lightingSystem, Camera* camera,
+                                       const AABB& sceneBounds) {
+    shadowCandidates.clear();
+
+    // Screen pixels per world unit at distance 1 from the camera
+    const glm::mat4 projection = camera->getProjectionMatrix();
+    const float height = static_cast<float>(viewportHeight ? viewportHeight : 1080u);
+    const float pixelsPerUnit = 0.5f * std::abs(projection[1][1]) * height;
+    PerspectiveCamera* perspCam = dynamic_cast<PerspectiveCamera*>(camera);
+
+    // The same lights, in the same order, as update() turns into shadows
+    const auto& lightEntities = lightingSystem.getLightEntities();
+    const size_t lightCount = eastl::min(lightingSystem.getLightData().size(), lightEntities.size());
+    uint32_t shadowCount = 0;
+    for (uint32_t lightIndex = 0; lightIndex < lightCount && shadowCount < MAX_SHADOWS; ++lightIndex) {
+        const entt::entity entity = lightEntities[lightIndex];
+        const auto* light         = world.try_get<LightComponent>(entity);
+        const auto* transform     = world.try_get<TransformComponent>(entity);
+        if (!light || !transform || !light->enabled || !light->castsShadows) {
+            continue;
+        }
+        ++shadowCount;
+
+        if (light->type == LightType::Directional) {
+            // Cascades partition the whole view, so they rank above any local light, nearer
+            // first. A slice is about farSplit / tan(fov / 2) wide and needs one texel per pixel
+            // at its near end: height * farSplit / nearSplit texels.
+            const uint32_t cascadeCount = getCascadeCount(*light, camera);
+            const auto splits = calculateCascadeSplits(perspCam ? perspCam->getNearPlane() : 0.1f,
+                                                       perspCam ? perspCam->getFarPlane() : 100.0f,
+                                                       cascadeCount, light->cascadeSplitLambda);
+            for (uint32_t c = 0; c < cascadeCount; ++c) {
+                const float needed = perspCam ? height * splits[c + 1] / eastl::max(splits[c], 1e-3f) : INFINITY;
+                addShadowCandidate(shadowKey(entity, c), light->shadowResolution, needed,
+                                   2.0f - 0.25f * static_cast<float>(c));
+            }
+            if (sceneBounds.isValid() && cascadeCount < 4) {
+                addShadowCandidate(shadowKey(entity, FALLBACK_CASCADE_SLOT), 1024, INFINITY, 1.0f);
+            }
+        } else if (light->type == LightType::Point) {
+            // Local lights by the share of the screen their range covers, with about as many
+            // texels as its projected diameter has pixels; from inside the range, all of it
+            const float radius   = eastl::max(light->radius, 1e-3f);
+            const float distance = glm::length(transform->world.position - camera->getPosition()) - radius;
+            const float diameter = distance > 0.0f ? 2.0f * radius * pixelsPerUnit / distance : INFINITY;
+            const float coverage = eastl::min(diameter / height, 1.0f);
+            addShadowCandidate(shadowKey(entity, 0), light->shadowResolution, diameter, coverage * coverage);
+        }
+    }
 
-    for (const auto& existing : allocations) {
-        if (!existing.inUse) continue;
+    assignShadowResolutions();
+}
 
-        uint32_t allocWidth = static_cast<uint32_t>(existing.rect.z * atlasSize);
-        uint32_t allocHeight = static_cast<uint32_t>(existing.rect.w * atlasSize);
+void ShadowSystem::addShadowCandidate(uint64_t key, uint32_t maxResolution, float neededResolution, float importance) {
+    shadowCandidates.push_back({key, atlasPacker.roundSize(maxResolution), neededResolution, importance});
+}
 
-        if (currentX + allocWidth <= atlasSize) {
-            currentX += allocWidth;
-            rowHeight = eastl::max(rowHeight, allocHeight);
+void ShadowSystem::assignShadowResolutions() {
+    atlasRequests.clear();
+    budgetSizes.resize(shadowCandidates.size());
+
+    // Each estimate through the hysteresis first
+    uint64_t totalTexels = 0;
+    for (uint32_t i = 0; i < shadowCandidates.size(); ++i) {
+        const ShadowCandidate& candidate = shadowCandidates[i];
+        const float needed = eastl::min(candidate.needed, static_cast<float>(candidate.maxResolution));
+        uint32_t target = atlasPacker.roundSize(static_cast<uint32_t>(std::ceil(needed)));
+        target = eastl::min(target, candidate.maxResolution);
+
+        ResolutionState& state = resolutionStates[candidate.key];
+        state.lastSeen = updateCount;
+        if (state.resolution == 0) {
+            state.resolution = target;  // New shadow map: nothing to pop from
         } else {
-            currentX = allocWidth;
-            currentY += rowHeight;
-            rowHeight = allocHeight;
+            // Dead band around the power-of-two boundaries
+            const float margin = 1.0f + RESOLUTION_HYSTERESIS_MARGIN;
+            const float current = static_cast<float>(state.resolution);
+            if ((target > state.resolution && needed <= current * margin) ||
+                (target < state.resolution && needed >= 0.5f * current / margin)) {
+                target = state.resolution;
+            }
+
+            if (target == state.resolution) {
+                state.pendingFrames = 0;
+            } else if (target == state.pending) {
+                if (++state.pendingFrames >= RESOLUTION_HYSTERESIS_FRAMES) {
+                    state.resolution = target;
+                    state.pendingFrames = 0;
+                }
+            } else {
+                state.pending = target;
+                state.pendingFrames = 1;
+            }
+            // A lowered cap applies at once
+            state.resolution = eastl::min(state.resolution, candidate.maxResolution);
         }
+        budgetSizes[i] = state.resolution;
+        totalTexels += static_cast<uint64_t>(state.resolution) * state.resolution;
     }
 
-    // Check if we need to start a new row
-    if (currentX + resolution > atlasSize) {
-        currentX = 0;
-        currentY += rowHeight;
-        rowHeight = resolution;
+    // Then fit the budget: halve whichever shadow map holds the most texels per importance
+    uint32_t budgetCut = 0;
+    while (totalTexels > texelBudget) {
+        uint32_t victim = ~0u;
+        float    victimCost = 0.0f;
+        for (uint32_t i = 0; i < shadowCandidates.size(); ++i) {
+            if (budgetSizes[i] <= atlasPacker.getMinSize()) {
+                continue;
+            }
+            const float texels = static_cast<float>(budgetSizes[i]) * static_cast<float>(budgetSizes[i]);
+            const float cost   = texels / eastl::max(shadowCandidates[i].importance, 1e-6f);
+            if (victim == ~0u || cost > victimCost) {
+                victim     = i;
+                victimCost = cost;
+            }
+        }
+        if (victim == ~0u) {
+            break;  // Everything at the minimum already
+        }
+        const uint64_t size = budgetSizes[victim];
+        totalTexels -= size * size - (size / 2) * (size / 2);
+        budgetSizes[victim] /= 2;
+        ++budgetCut;
     }
 
-    // Check if allocation fits
-    if (currentY + resolution > atlasSize) {
-        violet::Log::warn("ShadowSystem", "Atlas full, cannot allocate {}x{}", resolution, resolution);
-        return ShadowAtlasAllocation{{0, 0, 0, 0}, 0, 0, false};
+    for (uint32_t i = 0; i < shadowCandidates.size(); ++i) {
+        requestAtlasSpace(shadowCandidates[i].key, budgetSizes[i], shadowCandidates[i].importance);
     }
 
-    ShadowAtlasAllocation alloc;
-    alloc.rect = glm::vec4(
-        static_cast<float>(currentX) / atlasSize,
-        static_cast<float>(currentY) / atlasSize,
-        static_cast<float>(resolution) / atlasSize,
-        static_cast<float>(resolution) / atlasSize
-    );
-    alloc.resolution = resolution;
-    alloc.lightIndex = lightIndex;
-    alloc.inUse = true;
+    for (auto it = resolutionStates.begin(); it != resolutionStates.end();) {
+        it = it->second.lastSeen != updateCount ? resolutionStates.erase(it) : eastl::next(it);
+    }
 
-    allocations.push_back(alloc);
+    atlasStats.budgetCut       = budgetCut;
+    atlasStats.requestedTexels = totalTexels;
+}
 
-    return alloc;
+void ShadowSystem::requestAtlasSpace(uint64_t key, uint32_t resolution, float importance) {
+    atlasRequests.push_back({key, atlasPacker.roundSize(resolution), importance});
 }
 
-void ShadowSystem::freeSpace(const ShadowAtlasAllocation& alloc) {
-    for (auto& existing : allocations) {
-        if (existing.lightIndex == alloc.lightIndex && existing.inUse) {
-            existing.inUse = false;
+void ShadowSystem::packAtlas() {
+    // Most important first: when space runs out, the tail is what gets downgraded
+    eastl::sort(atlasRequests.begin(), atlasRequests.end(), [](const AtlasRequest& a, const AtlasRequest& b) {
+        return a.importance != b.importance ? a.importance > b.importance : a.key < b.key;
+    });
+
+    for (auto& [key, slot] : atlasSlots) {
+        slot.used = false;
+    }
+
+    // Allocations no larger than their request stay where they are (smaller ones are downgraded
+    // and try to grow back below); a request that shrank gives its space back first
+    eastl::vector<uint32_t> pending;
+    for (uint32_t i = 0; i < atlasRequests.size(); ++i) {
+        const AtlasRequest& request = atlasRequests[i];
+        auto it = atlasSlots.find(request.key);
+        if (it != atlasSlots.end()) {
+            if (atlasPacker.getSize(it->second.allocation) <= request.size) {
+                it->second.requested = request.size;
+                it->second.used      = true;
+                continue;
+            }
+            atlasPacker.free(it->second.allocation);
+            atlasSlots.erase(it);
+        }
+        pending.push_back(i);
+    }
+
+    // Space of shadows that went away
+    for (auto it = atlasSlots.begin(); it != atlasSlots.end();) {
+        if (!it->second.used) {
+            atlasPacker.free(it->second.allocation);
+            it = atlasSlots.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    bool repack = false;
+    for (uint32_t i : pending) {
+        uint32_t allocation;
+        if (!placeAtlasRequest(atlasRequests[i].size, allocation)) {
+            repack = true;
             break;
         }
+        atlasSlots[atlasRequests[i].key] = AtlasSlot{allocation, atlasRequests[i].size, true};
+    }
+
+    uint32_t dropped = 0;
+    if (repack) {
+        // Full even at the largest atlas: start over in importance order, halving whatever does
+        // not fit. Everything moves this once; the downgraded sizes then stay until they fit again.
+        atlasPacker.clear();
+        atlasSlots.clear();
+        for (const AtlasRequest& request : atlasRequests) {
+            uint32_t size = request.size;
+            uint32_t allocation = ShadowAtlasPacker::INVALID;
+            while (!placeAtlasRequest(size, allocation) && size > atlasPacker.getMinSize()) {
+                size /= 2;
+            }
+            if (allocation == ShadowAtlasPacker::INVALID) {
+                ++dropped;
+                continue;
+            }
+            atlasSlots[request.key] = AtlasSlot{allocation, request.size, true};
+        }
+        violet::Log::warn("ShadowSystem", "Shadow atlas full at {}x{}, repacked ({} shadow maps dropped)",
+                          atlasPacker.getAtlasSize(), atlasPacker.getAtlasSize(), dropped);
+    } else {
+        // Downgraded shadow maps take their full size back once it fits, without moving others
+        for (const AtlasRequest& request : atlasRequests) {
+            AtlasSlot& slot = atlasSlots[request.key];
+            if (atlasPacker.getSize(slot.allocation) < slot.requested) {
+                const uint32_t allocation = atlasPacker.allocate(slot.requested);
+                if (allocation != ShadowAtlasPacker::INVALID) {
+                    atlasPacker.free(slot.allocation);
+                    slot.allocation = allocation;
+                }
+            }
+        }
+    }
+
+    // Give back a grown atlas once the top-left quadrant has held everything for a while
+    if (atlasPacker.getAtlasSize() > baseAtlasSize && atlasPacker.canShrink()) {
+        if (++atlasShrinkFrames >= ATLAS_SHRINK_FRAMES) {
+            atlasPacker.shrink();
+            atlasShrinkFrames = 0;
+        }
+    } else {
+        atlasShrinkFrames = 0;
+    }
+    if (atlasPacker.getAtlasSize() != atlasSize) {
+        resizeAtlas();
+    }
+
+    const ShadowAtlasStats budget = atlasStats;
+    atlasStats = atlasPacker.getStats();
+    atlasStats.dropped         = dropped;
+    atlasStats.budgetCut       = budget.budgetCut;
+    atlasStats.requestedTexels = budget.requestedTexels;
+    for (const auto& [key, slot] : atlasSlots) {
+        atlasStats.downgraded += atlasPacker.getSize(slot.allocation) < slot.requested ? 1 : 0;
+    }
+}
+
+bool ShadowSystem::placeAtlasRequest(uint32_t size, uint32_t& allocation) {
+    while ((allocation = atlasPacker.allocate(size)) == ShadowAtlasPacker::INVALID) {
+        if (atlasPacker.getAtlasSize() * 2 > maxAtlasSize) {
+            return false;
+        }
+        atlasPacker.grow();
     }
+    return true;
+}
+
+uint32_t ShadowSystem::findAtlasAllocation(uint64_t key) const {
+    auto it = atlasSlots.find(key);
+    return it != atlasSlots.end() ? it->second.allocation : ShadowAtlasPacker::INVALID;
 }
 
-void ShadowSystem::clearAllAllocations() {
-    allocations.clear();
+glm::vec4 ShadowSystem::getAtlasRect(uint32_t allocation) const {
+    const glm::vec2 offset = glm::vec2(atlasPacker.getOffset(allocation)) / static_cast<float>(atlasSize);
+    const float size = static_cast<float>(atlasPacker.getSize(allocation)) / static_cast<float>(atlasSize);
+    return glm::vec4(offset, size, size);
+}
+
+void ShadowSystem::resizeAtlas() {
+    // Frames in flight may still sample the old atlas; resizes are rare enough to just wait
+    context->getDevice().waitIdle();
+    if (atlasTextureHandle.isValid()) {
+        textureManager->removeTexture(atlasTextureHandle);
+        atlasTextureHandle = TextureHandle{};
+    }
+
+    violet::Log::info("ShadowSystem", "Resizing shadow atlas {}x{} -> {}x{}", atlasSize, atlasSize,
+                      atlasPacker.getAtlasSize(), atlasPacker.getAtlasSize());
+    atlasSize = atlasPacker.getAtlasSize();
+    createAtlas();
 }
 
 void ShadowSystem::ensureBufferCapacity(uint32_t shadowCount) {
@@ -604,7 +1214,8 @@ void ShadowSystem::createAtlas() {
         context,
         atlasSize,
         atlasSize,
-        vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled
+        vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled |
+            vk::ImageUsageFlagBits::eTransferDst  // Static shadow cache copies
     );
 
     // Set shadow sampler for the texture
@@ -637,6 +1248,27 @@ void ShadowSystem::createAtlas() {
                      atlasSize, atlasSize, atlasBindlessIndex, atlasTextureHandle.index);
 }
 
+void ShadowSystem::createCacheAtlas() {
+    // Only ever rendered to and copied from, so it stays out of the bindless array
+    auto cacheTexture = eastl::make_unique<Texture>();
+    cacheTexture->createDepthTexture(
+        context,
+        cacheSize,
+        cacheSize,
+        vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eTransferSrc
+    );
+    cacheTextureHandle = textureManager->addTexture(eastl::move(cacheTexture));
+}
+
+const ImageResource* ShadowSystem::getCacheImage() const {
+    if (!cacheTextureHandle.isValid() || !textureManager) {
+        return nullptr;
+    }
+
+    const Texture* texture = textureManager->getTexture(cacheTextureHandle);
+    return texture ? texture->getImageResource() : nullptr;
+}
+
 const ImageResource* ShadowSystem::getAtlasImage() const {
     if (!atlasTextureHandle.isValid() || !textureManager) {
         return nullptr;
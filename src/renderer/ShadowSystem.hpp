@@ -3,12 +3,17 @@
 #include <vulkan/vulkan.hpp>
 #include <glm/glm.hpp>
 #include <EASTL/vector.h>
+#include <EASTL/hash_map.h>
 #include <EASTL/unique_ptr.h>
 #include <entt/entt.hpp>
 #include "resource/gpu/ResourceFactory.hpp"
 #include "resource/TextureManager.hpp"
+#include "acceleration/BVH.hpp"
 #include "math/AABB.hpp"
+#include "math/Frustum.hpp"
+#include "math/ScreenSize.hpp"
 #include "renderer/Renderable.hpp"
+#include "renderer/ShadowAtlasPacker.hpp"
 
 namespace violet {
 
@@ -37,11 +42,44 @@ struct ShadowData {
     alignas(4) uint32_t padding1[2];
 };
 
-struct ShadowAtlasAllocation {
-    glm::vec4 rect;            // Normalized UV coords (x, y, width, height)
-    uint32_t resolution;       // Actual pixel resolution
-    uint32_t lightIndex;       // Index into LightData array
-    bool inUse;
+// How ShadowPass fills a view's atlas region
+enum class ShadowCacheMode : uint8_t {
+    None,    // Not cached: cleared and every caster drawn
+    Reuse,   // Cached static depth copied in, dynamic casters drawn on top
+    Rebake,  // Static casters drawn into the cache first, then as Reuse
+    Scroll   // As Reuse with the cache shifted; static casters are drawn into the exposed strips
+};
+
+struct ShadowCacheStats {
+    uint32_t reused   = 0;  // Views per mode, last update
+    uint32_t scrolled = 0;
+    uint32_t rebaked  = 0;
+    uint32_t uncached = 0;
+};
+
+// One shadow map rendered from the atlas: a cascade of a directional light or a face of a point
+// light's cube. Casters are culled per view, all views of a frame in one BVH traversal, against
+// the side planes and the far plane only: the volume is extruded toward the light, so casters
+// in front of the near plane are kept (the shadow pipeline clamps their depth).
+struct ShadowView {
+    Frustum        frustum;           // Near plane replaced by the far plane in the culled slots
+    glm::vec4      depthPlane{0.0f};  // The view's near plane, distance grows away from the light
+    ScreenSizeTest sizeTest;          // Caster contribution test in the view's texels
+    uint32_t       shadowIndex = 0;   // Into getShadowData()
+    uint32_t       slot        = 0;   // Cascade (directional) or cube face (point)
+    uint32_t       firstCaster = 0;   // Range of getViewCasterIndices()
+    uint32_t       casterCount = 0;
+    uint32_t       staticCount = 0;   // The range's static casters, which come first
+
+    // Static shadow cache
+    glm::mat4       viewProj{1.0f};
+    uint32_t        resolution = 0;
+    uint64_t        cacheKey   = 0;     // Light entity and slot
+    uint64_t        lightHash  = 0;     // Light parameters the view's depth depends on
+    bool            cacheable  = false;
+    ShadowCacheMode cacheMode  = ShadowCacheMode::None;
+    glm::uvec2      cacheOffset{0};     // Texel origin of the view's region in the cache atlas
+    glm::ivec2      scroll{0};          // Atlas texel (x, y) holds cached texel (x, y) + scroll
 };
 
 class ShadowSystem {
@@ -55,7 +93,14 @@ public:
     void init(VulkanContext* context, DescriptorManager* descMgr, TextureManager* texMgr, uint32_t maxFramesInFlight);
     void cleanup();
 
-    void update(entt::registry& world, LightingSystem& lightingSystem, class Camera* camera, uint32_t frameIndex, const AABB& sceneBounds = AABB());
+    // Given the scene BVH and the renderables it was built over, shadow casters are culled per
+    // shadow view in a single multi-view traversal instead of taking every mesh in the world.
+    // With cameraFrustum and cameraVisible, the camera rides along as one more view of that
+    // traversal and its visible primitives are written to cameraVisible.
+    void update(entt::registry& world, LightingSystem& lightingSystem, class Camera* camera, uint32_t frameIndex,
+                const AABB& sceneBounds = AABB(), const BVH* sceneBVH = nullptr,
+                const eastl::vector<Renderable>* sceneRenderables = nullptr, const Frustum* cameraFrustum = nullptr,
+                eastl::vector<uint32_t>* cameraVisible = nullptr);
     void uploadToGPU(uint32_t frameIndex);
 
     vk::DescriptorSet getDescriptorSet(uint32_t frameIndex) const;
@@ -66,17 +111,82 @@ public:
     const eastl::vector<ShadowData>& getShadowData() const { return cpuShadowData; }
     const ImageResource* getAtlasImage() const;  // Get from TextureManager
 
+    // Casters spanning fewer shadow map texels than this in a shadow view are not gathered for
+    // it (0 disables); the count is per caster and view, for the last update
+    void setMinCasterSize(float texels) { minCasterTexels = texels; }
+    float getMinCasterSize() const { return minCasterTexels; }
+    uint32_t getSmallCastersCulled() const { return smallCastersCulled; }
+
     // Get shadow renderables (culled for shadow frustum, not camera frustum)
     const eastl::vector<Renderable>& getShadowRenderables() const { return shadowRenderables; }
 
-    // Atlas management
-    ShadowAtlasAllocation allocateSpace(uint32_t resolution, uint32_t lightIndex);
-    void freeSpace(const ShadowAtlasAllocation& alloc);
-    void clearAllAllocations();
+    // Shadow views of the last update, grouped by shadow. Without per-view casters (no scene
+    // BVH was given) every shadow renderable is a caster of every view.
+    const eastl::vector<ShadowView>& getViews() const { return views; }
+    const ShadowView* findView(uint32_t shadowIndex, uint32_t slot) const;
+    bool hasViewCasters() const { return viewCastersValid; }
+    // Indices into getShadowRenderables(), one range per view. A range is grouped by mesh so
+    // ShadowPass binds each mesh once per view; groups and the casters within them run front
+    // to back from the light.
+    const eastl::vector<uint32_t>& getViewCasterIndices() const { return viewCasterIndices; }
+    const BVHCullStats& getCasterCullStats() const { return casterCullStats; }
+
+    // Static shadow cache: casters that have not moved for STATIC_CASTER_FRAMES updates are
+    // static; their depth is kept per directional light view in a separate cache atlas and
+    // copied into the shadow atlas each frame, so only dynamic casters are redrawn. A view is
+    // rebaked when its light changes, when static casters start or stop moving inside it, or
+    // when its cascade moves by more than a scroll can absorb.
+    void setStaticCaching(bool enabled) { staticCachingEnabled = enabled; }
+    // Any change drops all baked depth: casters may have been removed from the scene BVH
+    void setSceneGeneration(uint32_t generation) { sceneGeneration = generation; }
+    bool getStaticCaching() const { return staticCachingEnabled; }
+    const ShadowCacheStats& getCacheStats() const { return cacheStats; }
+    const ImageResource* getCacheImage() const;
+    uint32_t getCacheSize() const { return cacheSize; }
+
+    // Atlas management: each update every shadow map asks for a square of the atlas with an
+    // importance. Allocations persist from update to update while their request stays the same;
+    // when the atlas is full it grows up to the device limit, and past that the least important
+    // shadow maps are downgraded to smaller squares (they take their size back once it fits).
+    // The atlas shrinks again once its top-left quadrant holds everything for a while.
+    const ShadowAtlasStats& getAtlasStats() const { return atlasStats; }
+
+    // Shadow map resolutions come from a global texel budget. Every shadow map estimates the
+    // resolution giving about one texel per screen pixel (capped by the light's
+    // shadowResolution) and an importance: its screen coverage for local lights, a fixed rank
+    // above them for directional cascades, nearer first. While the total exceeds the budget the
+    // shadow map with the most texels per importance is halved. A change of estimate only takes
+    // effect once it is RESOLUTION_HYSTERESIS_MARGIN past the power-of-two boundary for
+    // RESOLUTION_HYSTERESIS_FRAMES updates in a row, so resolutions do not pop back and forth.
+    void setTexelBudget(uint64_t texels) { texelBudget = texels; }
+    uint64_t getTexelBudget() const { return texelBudget; }
+    // Height in pixels of the view the shadows are seen in (0 assumes 1080)
+    void setViewportHeight(uint32_t pixels) { viewportHeight = pixels; }
 
 private:
+    void collectAllCasters(entt::registry& world);
+    void addView(uint32_t shadowIndex, uint32_t slot, const glm::mat4& viewProj, uint32_t resolution,
+                 const ScreenSizeTest& sizeTest);
+    void trackCasterMotion(const BVH& sceneBVH, const eastl::vector<Renderable>& sceneRenderables);
+    bool isStaticCaster(entt::entity entity) const;
+    void updateStaticCache();
+    void resetStaticCache();
+    void requestAtlasSpace(uint64_t key, uint32_t resolution, float importance);
+    void addShadowCandidate(uint64_t key, uint32_t maxResolution, float neededResolution, float importance);
+    void assignShadowResolutions();
+    void gatherAtlasRequests(entt::registry& world, LightingSystem& lightingSystem, class Camera* camera,
+                             const AABB& sceneBounds);
+    void packAtlas();
+    bool placeAtlasRequest(uint32_t size, uint32_t& allocation);
+    uint32_t findAtlasAllocation(uint64_t key) const;
+    glm::vec4 getAtlasRect(uint32_t allocation) const;
+    void resizeAtlas();
+    void cullViewCasters(const BVH& sceneBVH, const eastl::vector<Renderable>& sceneRenderables,
+                         const Frustum* cameraFrustum, eastl::vector<uint32_t>* cameraVisible);
+    void sortViewCasters(const ShadowView& view);
     void ensureBufferCapacity(uint32_t shadowCount);
     void createAtlas();
+    void createCacheAtlas();
 
 private:
     VulkanContext* context = nullptr;
@@ -90,17 +200,112 @@ private:
 
     // Shadow renderables (all objects that can cast shadows)
     eastl::vector<Renderable> shadowRenderables;
+    eastl::vector<ShadowView> views;
+    eastl::vector<uint32_t> shadowFirstView;    // Per shadow, its first view
+    eastl::vector<uint32_t> viewCasterIndices;
+    eastl::vector<uint32_t> casterSlots;        // Per scene renderable, 1 + its shadowRenderables index, 0 if absent
+    eastl::vector<eastl::pair<uint32_t, uint32_t>> casterHits;  // Multi-view traversal output: (primitive, views)
+
+    // Draw order scratch, parallel to viewCasterIndices
+    struct CasterSortEntry {
+        uintptr_t mesh;
+        float     depth;
+        uint32_t  caster;
+        bool      isStatic;
+    };
+    struct MeshGroup {
+        float    depth;  // Nearest caster of the group
+        uint32_t first;
+        uint32_t count;
+    };
+    eastl::vector<CasterSortEntry> casterOrder;
+    eastl::vector<MeshGroup> meshGroups;
+    bool viewCastersValid = false;
+    BVHCullStats casterCullStats;
+    float minCasterTexels = 0.0f;
+    uint32_t smallCastersCulled = 0;
 
     // Shadow atlas - managed by TextureManager
     struct TextureHandle atlasTextureHandle;
     uint32_t atlasBindlessIndex = 0;
-    uint32_t atlasSize = 8192;  // Increased from 4096 for larger shadow coverage
-    eastl::vector<ShadowAtlasAllocation> allocations;
+    uint32_t atlasSize = 8192;  // Initial size; grows up to maxAtlasSize when shadows do not fit
+    uint32_t baseAtlasSize = 8192;
+    uint32_t maxAtlasSize = 16384;
+    uint32_t atlasShrinkFrames = 0;  // Consecutive updates the atlas could have shrunk
+
+    struct AtlasRequest {
+        uint64_t key;         // Light entity and cascade
+        uint32_t size;        // Rounded to the packer's power of two
+        float    importance;  // Higher keeps its size when space runs out
+    };
+    struct AtlasSlot {
+        uint32_t allocation = ShadowAtlasPacker::INVALID;
+        uint32_t requested  = 0;  // Size asked for; larger than the allocation when downgraded
+        bool     used       = false;
+    };
+    struct ShadowCandidate {
+        uint64_t key;
+        uint32_t maxResolution;  // Power of two
+        float    needed;         // Texels per side for about one texel per pixel
+        float    importance;
+    };
+    struct ResolutionState {
+        uint32_t resolution    = 0;
+        uint32_t pending       = 0;  // Resolution the estimate has been asking for
+        uint32_t pendingFrames = 0;
+        uint32_t lastSeen      = 0;
+    };
+    eastl::vector<ShadowCandidate> shadowCandidates;
+    eastl::hash_map<uint64_t, ResolutionState> resolutionStates;
+    eastl::vector<uint32_t> budgetSizes;  // Scratch, parallel to shadowCandidates
+    uint64_t texelBudget = 32ull << 20;   // Half of the initial atlas
+    uint32_t viewportHeight = 0;
+
+    ShadowAtlasPacker atlasPacker;
+    eastl::vector<AtlasRequest> atlasRequests;
+    eastl::hash_map<uint64_t, AtlasSlot> atlasSlots;
+    ShadowAtlasStats atlasStats;
+
+    // Static shadow cache
+    struct CasterMotion {
+        uint32_t lastMoved   = 0;  // Update count when the caster last moved, 0 if never seen
+        uint32_t staticSince = 0;  // Update count when staticBounds was gathered
+        AABB     staticBounds;     // Where the caster settled, as baked into the cache
+    };
+    struct StaticCacheEntry {
+        Frustum    frustum;        // Volume the static casters were gathered from
+        glm::mat4  viewProj{1.0f};
+        glm::uvec2 offset{0};
+        uint32_t   allocation = ShadowAtlasPacker::INVALID;  // In cachePacker
+        uint32_t   resolution = 0;
+        uint64_t   lightHash  = 0;
+        uint32_t   lastUsed   = 0;
+        bool       valid      = false;
+    };
+    eastl::vector<CasterMotion> casterMotion;       // Per entity index
+    eastl::vector<AABB> cacheInvalidations;         // Bounds of casters that started or stopped moving
+    eastl::hash_map<uint64_t, StaticCacheEntry> staticCache;
+    struct TextureHandle cacheTextureHandle;
+    uint32_t cacheSize = 4096;
+    ShadowAtlasPacker cachePacker;
+    uint32_t updateCount = 0;
+    uint32_t sceneGeneration = 0;
+    uint32_t cachedSceneGeneration = 0;
+    bool staticCachingEnabled = true;
+    ShadowCacheStats cacheStats;
 
     uint32_t bufferCapacity = 0;
 
     static constexpr uint32_t INITIAL_CAPACITY = 32;
     static constexpr uint32_t MAX_SHADOWS = 128;
+    static constexpr uint32_t MIN_SHADOW_RESOLUTION = 256;  // Smallest atlas square; downgrades stop here
+    static constexpr uint32_t ATLAS_SHRINK_FRAMES = 120;
+    static constexpr uint32_t FALLBACK_CASCADE_SLOT = 4;    // Atlas key slot of the scene-wide fallback cascade
+    static constexpr uint32_t RESOLUTION_HYSTERESIS_FRAMES = 15;
+    static constexpr float RESOLUTION_HYSTERESIS_MARGIN = 0.25f;
+    static constexpr uint32_t STATIC_CASTER_FRAMES = 30;   // Updates without motion before a caster is static
+    static constexpr uint32_t CACHE_EVICT_FRAMES = 120;    // Unused cache entries are freed after this
+    static constexpr uint32_t MAX_CACHE_SCROLL_DIVISOR = 4;  // Scrolls past resolution / this rebake
 };
 
 } // namespace violet
\ No newline at end of file
@@ -206,6 +206,13 @@ void VulkanContext::createLogicalDevice() {
     } else {
         violet::Log::warn("Renderer", "wideLines not supported on this device");
     }
+
+    if (availableFeatures.depthClamp) {
+        deviceFeatures.depthClamp = VK_TRUE;        // For shadow casters in front of a cascade's near plane
+        violet::Log::info("Renderer", "Enabled depthClamp feature");
+    } else {
+        violet::Log::warn("Renderer", "depthClamp not supported on this device");
+    }
     
     // Vulkan 1.3 core features
     vk::PhysicalDeviceVulkan13Features features13;
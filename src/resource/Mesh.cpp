@@ -74,6 +74,7 @@ void Mesh::cleanup() {
     vertexBuffer.cleanup();
     indexBuffer.cleanup();
     subMeshes.clear();
+    geometry.reset();
 }
 
 void Mesh::computeSubMeshBounds(const eastl::vector<Vertex>& vertices,
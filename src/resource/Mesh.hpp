@@ -2,8 +2,10 @@
 
 #include "resource/Vertex.hpp"
 #include "resource/gpu/IndexBuffer.hpp"
+#include "resource/MeshGeometry.hpp"
 #include "math/AABB.hpp"
 #include <EASTL/vector.h>
+#include <EASTL/shared_ptr.h>
 
 namespace violet {
 
@@ -49,6 +51,10 @@ public:
     const IndexBuffer& getIndexBuffer() const { return indexBuffer; }
     const eastl::vector<SubMesh>& getSubMeshes() const { return subMeshes; }
 
+    // CPU geometry for ray queries; null for meshes created without it
+    void setGeometry(eastl::shared_ptr<const MeshGeometry> meshGeometry) { geometry = eastl::move(meshGeometry); }
+    const MeshGeometry* getGeometry() const { return geometry.get(); }
+
     size_t getSubMeshCount() const { return subMeshes.size(); }
     const SubMesh& getSubMesh(size_t index) const { return subMeshes[index]; }
     AABB getLocalBounds() const {
@@ -63,6 +69,7 @@ private:
     VertexBuffer vertexBuffer;
     IndexBuffer indexBuffer;
     eastl::vector<SubMesh> subMeshes;
+    eastl::shared_ptr<const MeshGeometry> geometry;
 
     void computeSubMeshBounds(const eastl::vector<Vertex>& vertices,
                               const eastl::vector<uint32_t>& indices);
@@ -0,0 +1,78 @@
+#include "resource/MeshGeometry.hpp"
+
+#include <EASTL/algorithm.h>
+
+namespace violet {
+
+void MeshGeometry::addSubMesh(uint32_t firstIndex, uint32_t indexCount, const uint8_t* bvhCache,
+                              size_t bvhCacheSize) {
+    SubMeshBLAS& subMesh = subMeshes.emplace_back();
+    subMesh.firstIndex   = eastl::min<uint32_t>(firstIndex, static_cast<uint32_t>(indices.size()));
+    subMesh.indexCount   = eastl::min<uint32_t>(indexCount, static_cast<uint32_t>(indices.size()) - subMesh.firstIndex);
+
+    const eastl::vector<AABB> triangleBounds = computeTriangleBounds(subMesh);
+    if (bvhCache && !triangleBounds.empty() &&
+        subMesh.bvh.deserialize(bvhCache, bvhCacheSize, BVH::computeCacheKey(triangleBounds, BVHBuildMethod::SAH),
+                                triangleBounds, BVHBuildMethod::SAH)) {
+        return;
+    }
+    subMesh.bvh.build(triangleBounds, nullptr, BVHBuildMethod::SAH);
+}
+
+void MeshGeometry::serializeSubMesh(uint32_t subMeshIndex, eastl::vector<uint8_t>& out) const {
+    const SubMeshBLAS& subMesh = subMeshes[subMeshIndex];
+    subMesh.bvh.serialize(BVH::computeCacheKey(computeTriangleBounds(subMesh), BVHBuildMethod::SAH), out);
+}
+
+eastl::vector<AABB> MeshGeometry::computeTriangleBounds(const SubMeshBLAS& subMesh) const {
+    const uint32_t triangleCount = subMesh.indexCount / 3;
+    eastl::vector<AABB> triangleBounds;
+    triangleBounds.reserve(triangleCount);
+    for (uint32_t tri = 0; tri < triangleCount; ++tri) {
+        const uint32_t* triIndices = &indices[subMesh.firstIndex + tri * 3];
+
+        AABB bounds;
+        for (uint32_t k = 0; k < 3; ++k) {
+            // Out-of-range indices leave the triangle with empty bounds; intersect() skips it too
+            if (triIndices[k] >= positions.size()) {
+                bounds = AABB();
+                break;
+            }
+            bounds.expand(positions[triIndices[k]]);
+        }
+        triangleBounds.push_back(bounds);
+    }
+    return triangleBounds;
+}
+
+bool MeshGeometry::intersect(uint32_t subMeshIndex, Ray& ray, bool anyHit, uint32_t& triangleIndex,
+                             glm::vec2& barycentrics) const {
+    if (subMeshIndex >= subMeshes.size()) {
+        return false;
+    }
+
+    const SubMeshBLAS& subMesh = subMeshes[subMeshIndex];
+
+    auto intersectTriangle = [&](uint32_t tri, Ray& ray) {
+        const uint32_t* triIndices = &indices[subMesh.firstIndex + tri * 3];
+        if (triIndices[0] >= positions.size() || triIndices[1] >= positions.size() ||
+            triIndices[2] >= positions.size()) {
+            return false;
+        }
+
+        float t, u, v;
+        if (!ray.intersectTriangle(positions[triIndices[0]], positions[triIndices[1]], positions[triIndices[2]],
+                                   t, u, v)) {
+            return false;
+        }
+        ray.tMax      = t;
+        triangleIndex = tri;
+        barycentrics  = glm::vec2(u, v);
+        return true;
+    };
+
+    return anyHit ? subMesh.bvh.intersectAny(ray, intersectTriangle)
+                  : subMesh.bvh.intersectClosest(ray, intersectTriangle);
+}
+
+} // namespace violet
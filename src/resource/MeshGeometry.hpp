@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <EASTL/vector.h>
+
+#include "acceleration/BVH.hpp"
+#include "math/Ray.hpp"
+
+namespace violet {
+
+// CPU-side triangle data retained for ray queries (picking). Shared by every Mesh created
+// from the same asset mesh; indices match the GPU index buffer, so SubMesh::firstIndex and
+// SubMesh::indexCount address the same triangles.
+//
+// Each submesh owns a static object-space triangle BVH (the bottom level of the scene's
+// two-level structure). Instances only move in the scene BVH above it, so transform changes
+// never touch these trees.
+struct MeshGeometry {
+    struct SubMeshBLAS {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        BVH      bvh;  // Primitive i is triangle i of the submesh
+    };
+
+    eastl::vector<glm::vec3> positions;
+    eastl::vector<uint32_t> indices;
+    eastl::vector<SubMeshBLAS> subMeshes;  // Same order as the Mesh's SubMeshes
+
+    uint32_t getTriangleCount() const { return static_cast<uint32_t>(indices.size() / 3); }
+
+    // Append a submesh over [firstIndex, firstIndex + indexCount) and build its triangle BVH.
+    // Static content, so the SAH builder is used for the best query performance. A BVH cache
+    // blob from serializeSubMesh() is restored instead of building when it matches.
+    void addSubMesh(uint32_t firstIndex, uint32_t indexCount, const uint8_t* bvhCache = nullptr,
+                    size_t bvhCacheSize = 0);
+
+    // Append the submesh's BVH topology to out, as a cache blob for addSubMesh()
+    void serializeSubMesh(uint32_t subMeshIndex, eastl::vector<uint8_t>& out) const;
+
+    // Closest-hit (or any-hit) query against one submesh. The ray must be in object space;
+    // on a hit ray.tMax is shrunk to the hit distance and the triangle index (relative to the
+    // submesh) and barycentrics are written out.
+    bool intersect(uint32_t subMeshIndex, Ray& ray, bool anyHit, uint32_t& triangleIndex,
+                   glm::vec2& barycentrics) const;
+
+private:
+    eastl::vector<AABB> computeTriangleBounds(const SubMeshBLAS& subMesh) const;
+};
+
+} // namespace violet
@@ -18,6 +18,7 @@ ResourceManager::~ResourceManager() {
 
 void ResourceManager::init(VulkanContext* ctx, uint32_t maxFramesInFlight) {
     context = ctx;
+    sceneCacheDirectory = FileSystem::join(FileSystem::getExecutableDirectory(), "cache/scenes");
 
     // 1. Initialize DescriptorManager first (base infrastructure)
     descriptorManager.init(context, maxFramesInFlight);
@@ -8,6 +8,7 @@
 #include "core/ThreadPool.hpp"
 
 #include <EASTL/vector.h>
+#include <EASTL/string.h>
 #include <EASTL/functional.h>
 #include <EASTL/shared_ptr.h>
 #include <mutex>
@@ -63,9 +64,17 @@ public:
     void submitAsyncTask(eastl::shared_ptr<AsyncLoadTask> task);
     void processAsyncTasks();  // Call every frame to process completed CPU work
 
+    // Shared worker pool, also used for data-parallel CPU work (e.g. BVH builds)
+    ThreadPool* getThreadPool() { return &threadPool; }
+
+    // Where imported scenes leave binary snapshots for fast reloads; empty disables them
+    void setSceneCacheDirectory(const eastl::string& directory) { sceneCacheDirectory = directory; }
+    const eastl::string& getSceneCacheDirectory() const { return sceneCacheDirectory; }
+
 private:
     void loadAllShaders();  // Pre-load all shaders into ShaderLibrary
     VulkanContext* context = nullptr;
+    eastl::string sceneCacheDirectory;
 
     // Sub-managers (order matters: initialization dependency)
     DescriptorManager descriptorManager;                 // Base infrastructure (owned)
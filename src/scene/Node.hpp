@@ -1,37 +1,30 @@
 #pragma once
 
 #include <EASTL/string.h>
-#include <EASTL/vector.h>
-#include <EASTL/algorithm.h>
 #include <entt/entt.hpp>
 
 namespace violet {
 
 struct Node {
-    uint32_t id = 0;
+    uint32_t id = 0;                    // Assigned by Scene: slot index and generation, never 0
     eastl::string name;
     entt::entity entity = entt::null;   // Associated ECS entity
 
     uint32_t parentId = 0;              // 0 means root node (no parent)
-    eastl::vector<uint32_t> childrenIds;
+
+    // Intrusive child list in insertion order, maintained by Scene; 0 ends a list
+    uint32_t firstChildId  = 0;
+    uint32_t lastChildId   = 0;
+    uint32_t prevSiblingId = 0;
+    uint32_t nextSiblingId = 0;
+    uint32_t childCount    = 0;
 
     Node() = default;
-    Node(uint32_t nodeId, const eastl::string& nodeName)
-        : id(nodeId), name(nodeName) {}
+    explicit Node(const eastl::string& nodeName)
+        : name(nodeName) {}
 
     bool isRoot() const { return parentId == 0; }
-    bool hasChildren() const { return !childrenIds.empty(); }
-
-    void addChild(uint32_t childId) {
-        childrenIds.push_back(childId);
-    }
-
-    void removeChild(uint32_t childId) {
-        auto it = eastl::find(childrenIds.begin(), childrenIds.end(), childId);
-        if (it != childrenIds.end()) {
-            childrenIds.erase(it);
-        }
-    }
+    bool hasChildren() const { return firstChildId != 0; }
 };
 
-}
\ No newline at end of file
+}
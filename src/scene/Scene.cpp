@@ -10,10 +10,9 @@
 #include "resource/MaterialManager.hpp"
 #include "renderer/ForwardRenderer.hpp"
 #include "renderer/vulkan/VulkanContext.hpp"
+#include "core/ThreadPool.hpp"
 
 #include <algorithm>
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/matrix_decompose.hpp>
 
 namespace violet {
 
@@ -29,15 +28,22 @@ eastl::unique_ptr<Scene> Scene::loadFromGLTF(
     entt::registry& world,
     Texture* defaultTexture
 ) {
+    // A snapshot of an earlier import of this file skips parsing entirely
+    if (auto scene = loadCachedSnapshot(filePath, resourceMgr, renderer, world, defaultTexture)) {
+        return scene;
+    }
+
     // Parse glTF file synchronously
-    auto asset = AssetLoader::loadGLTF(filePath);
+    auto asset = AssetLoader::loadGLTF(filePath, resourceMgr.getThreadPool());
     if (!asset) {
         violet::Log::error("Scene", "Failed to load glTF asset: {}", filePath.c_str());
         return nullptr;
     }
 
     // Create scene from loaded asset
-    return createFromAsset(asset.get(), resourceMgr, renderer, world, filePath, defaultTexture);
+    // Shared, since the snapshot written from it may outlive this call
+    return createFromAsset(eastl::shared_ptr<const GLTFAsset>(eastl::move(asset)), resourceMgr, renderer, world,
+                           filePath, defaultTexture);
 }
 
 // Async loading - preferred method
@@ -49,6 +55,16 @@ void Scene::loadFromGLTFAsync(
     Texture* defaultTexture,
     eastl::function<void(eastl::unique_ptr<Scene>, eastl::string)> callback
 ) {
+    // Loading a snapshot is mostly GPU uploads, which belong on this thread anyway
+    try {
+        if (auto scene = loadCachedSnapshot(filePath, resourceMgr, renderer, world, defaultTexture)) {
+            callback(eastl::move(scene), "");
+            return;
+        }
+    } catch (const std::exception& e) {
+        violet::Log::warn("Scene", "Failed to load snapshot of {}: {}", filePath.c_str(), e.what());
+    }
+
     AssetLoader::loadGLTFAsync(filePath, &resourceMgr,
         [&resourceMgr, &renderer, &world, defaultTexture, filePath, callback]
         (eastl::unique_ptr<GLTFAsset> asset, eastl::string error) {
@@ -58,7 +74,8 @@ void Scene::loadFromGLTFAsync(
             }
 
             try {
-                auto scene = createFromAsset(asset.get(), resourceMgr, renderer, world, filePath, defaultTexture);
+                auto scene = createFromAsset(eastl::shared_ptr<const GLTFAsset>(eastl::move(asset)), resourceMgr,
+                                             renderer, world, filePath, defaultTexture);
                 callback(eastl::move(scene), "");
             } catch (const std::exception& e) {
                 callback(nullptr, eastl::string(e.what()));
@@ -69,189 +86,345 @@ void Scene::loadFromGLTFAsync(
 
 void Scene::cleanup() {
     nodes.clear();
-    rootNodeIds.clear();
-    nextNodeId = 1;
+    nodeSlots.clear();
+    freeSlots.clear();
+    entityNodes.clear();
+    firstRootId = 0;
+    lastRootId = 0;
+    rootCount = 0;
+    transformHierarchy.clear();
+    hierarchyEntities.clear();
+    pendingDirtyEntities.clear();
+    changedEntities.clear();
+    hierarchyDirty = true;
 }
 
 uint32_t Scene::addNode(const Node& node) {
-    Node newNode = node;
-    if (newNode.id == 0) {
-        newNode.id = nextNodeId++;
+    uint32_t slotIndex;
+    if (!freeSlots.empty()) {
+        slotIndex = freeSlots.back();
+        freeSlots.pop_back();
     } else {
-        nextNodeId = eastl::max(nextNodeId, newNode.id + 1);
+        slotIndex = static_cast<uint32_t>(nodeSlots.size());
+        if (slotIndex >= NODE_INDEX_MASK) {
+            violet::Log::error("Scene", "Node limit of {} reached", NODE_INDEX_MASK);
+            return 0;
+        }
+        nodeSlots.push_back({});
     }
 
-    nodes[newNode.id] = newNode;
+    NodeSlot& slot = nodeSlots[slotIndex];
+    slot.denseIndex = static_cast<uint32_t>(nodes.size());
 
-    if (newNode.isRoot()) {
-        rootNodeIds.push_back(newNode.id);
-    } else {
-        auto parentIt = nodes.find(newNode.parentId);
-        if (parentIt != nodes.end()) {
-            parentIt->second.addChild(newNode.id);
-        }
-    }
+    const uint32_t parentId = node.parentId;
+    nodes.push_back(node);
+    Node& newNode = nodes.back();
+    newNode.id = (slot.generation << NODE_INDEX_BITS) | (slotIndex + 1);
+    newNode.firstChildId = 0;
+    newNode.lastChildId = 0;
+    newNode.childCount = 0;
+    linkNode(newNode, parentId);
+    bindEntity(newNode.id, newNode.entity);
+    hierarchyDirty = true;
 
     return newNode.id;
 }
 
 uint32_t Scene::addNode(const eastl::string& name, uint32_t parentId) {
-    Node node(nextNodeId, name);
+    Node node(name);
     node.parentId = parentId;
     return addNode(node);
 }
 
+Scene::NodeSlot* Scene::findSlot(uint32_t nodeId) {
+    const uint32_t slotIndex = (nodeId & NODE_INDEX_MASK) - 1;  // Id 0 wraps past every slot
+    if (slotIndex >= nodeSlots.size()) {
+        return nullptr;
+    }
+    NodeSlot& slot = nodeSlots[slotIndex];
+    if (slot.denseIndex == INVALID_INDEX || slot.generation != nodeId >> NODE_INDEX_BITS) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+const Scene::NodeSlot* Scene::findSlot(uint32_t nodeId) const {
+    return const_cast<Scene*>(this)->findSlot(nodeId);
+}
+
 Node* Scene::getNode(uint32_t nodeId) {
-    auto it = nodes.find(nodeId);
-    return (it != nodes.end()) ? &it->second : nullptr;
+    NodeSlot* slot = findSlot(nodeId);
+    return slot ? &nodes[slot->denseIndex] : nullptr;
 }
 
 const Node* Scene::getNode(uint32_t nodeId) const {
-    auto it = nodes.find(nodeId);
-    return (it != nodes.end()) ? &it->second : nullptr;
+    const NodeSlot* slot = findSlot(nodeId);
+    return slot ? &nodes[slot->denseIndex] : nullptr;
 }
 
 bool Scene::removeNode(uint32_t nodeId) {
-    auto nodeIt = nodes.find(nodeId);
-    if (nodeIt == nodes.end()) {
+    NodeSlot* slot = findSlot(nodeId);
+    if (!slot) {
         return false;
     }
 
-    Node& node = nodeIt->second;
-
     // Reparent children
-    for (uint32_t childId : node.childrenIds) {
-        auto childIt = nodes.find(childId);
-        if (childIt != nodes.end()) {
-            childIt->second.parentId = node.parentId;
-            if (node.parentId != 0) {
-                auto parentIt = nodes.find(node.parentId);
-                if (parentIt != nodes.end()) {
-                    parentIt->second.addChild(childId);
-                }
-            } else {
-                rootNodeIds.push_back(childId);
-            }
-        }
+    Node* node = &nodes[slot->denseIndex];
+    const uint32_t parentId = node->parentId;
+    for (uint32_t childId = node->firstChildId; childId != 0;) {
+        Node* child = getNode(childId);
+        const uint32_t nextId = child->nextSiblingId;
+        unlinkNode(*child);
+        linkNode(*child, parentId);
+        childId = nextId;
     }
 
-    removeFromParent(nodeId);
-    nodes.erase(nodeIt);
+    unlinkNode(*node);
+    unbindEntity(nodeId, node->entity);
+
+    // Fill the hole with the last node to keep the storage dense
+    const uint32_t denseIndex = slot->denseIndex;
+    if (denseIndex + 1 != nodes.size()) {
+        nodes[denseIndex] = eastl::move(nodes.back());
+        nodeSlots[(nodes[denseIndex].id & NODE_INDEX_MASK) - 1].denseIndex = denseIndex;
+    }
+    nodes.pop_back();
+
+    slot->denseIndex = INVALID_INDEX;
+    slot->hierarchyIndex = INVALID_INDEX;
+    // A slot whose generation would wrap is retired instead, so old ids can never match again
+    if (slot->generation < MAX_NODE_GENERATION) {
+        ++slot->generation;
+        freeSlots.push_back((nodeId & NODE_INDEX_MASK) - 1);
+    }
+    hierarchyDirty = true;
 
     return true;
 }
 
+void Scene::setNodeEntity(uint32_t nodeId, entt::entity entity) {
+    if (Node* node = getNode(nodeId)) {
+        unbindEntity(nodeId, node->entity);
+        node->entity = entity;
+        bindEntity(nodeId, entity);
+        hierarchyDirty = true;
+    }
+}
+
 void Scene::setParent(uint32_t childId, uint32_t parentId) {
     Node* child = getNode(childId);
     if (!child) {
         return;
     }
 
-    removeFromParent(childId);
-
-    child->parentId = parentId;
-
-    if (parentId == 0) {
-        rootNodeIds.push_back(childId);
-    } else {
-        Node* parent = getNode(parentId);
-        if (parent) {
-            parent->addChild(childId);
-        }
-    }
+    unlinkNode(*child);
+    linkNode(*child, parentId);
+    hierarchyDirty = true;
 }
 
 void Scene::addChild(uint32_t parentId, uint32_t childId) {
     setParent(childId, parentId);
 }
 
-
-void Scene::traverseNodes(uint32_t nodeId, eastl::function<void(const Node&)> visitor) const {
-    const Node* node = getNode(nodeId);
-    if (!node) {
-        return;
+void Scene::linkNode(Node& node, uint32_t parentId) {
+    Node* parent = getNode(parentId);
+    uint32_t& first = parent ? parent->firstChildId : firstRootId;
+    uint32_t& last  = parent ? parent->lastChildId : lastRootId;
+    uint32_t& count = parent ? parent->childCount : rootCount;
+
+    node.parentId = parent ? parentId : 0;
+    node.prevSiblingId = last;
+    node.nextSiblingId = 0;
+    if (last != 0) {
+        getNode(last)->nextSiblingId = node.id;
+    } else {
+        first = node.id;
     }
+    last = node.id;
+    ++count;
+}
 
-    visitor(*node);
+void Scene::unlinkNode(Node& node) {
+    Node* parent = getNode(node.parentId);
+    uint32_t& first = parent ? parent->firstChildId : firstRootId;
+    uint32_t& last  = parent ? parent->lastChildId : lastRootId;
+    uint32_t& count = parent ? parent->childCount : rootCount;
 
-    for (uint32_t childId : node->childrenIds) {
-        traverseNodes(childId, visitor);
+    if (node.prevSiblingId != 0) {
+        getNode(node.prevSiblingId)->nextSiblingId = node.nextSiblingId;
+    } else {
+        first = node.nextSiblingId;
     }
+    if (node.nextSiblingId != 0) {
+        getNode(node.nextSiblingId)->prevSiblingId = node.prevSiblingId;
+    } else {
+        last = node.prevSiblingId;
+    }
+    --count;
+
+    node.parentId = 0;
+    node.prevSiblingId = 0;
+    node.nextSiblingId = 0;
 }
 
-void Scene::traverseAllNodes(eastl::function<void(const Node&)> visitor) const {
-    for (uint32_t rootId : rootNodeIds) {
-        traverseNodes(rootId, visitor);
+void Scene::bindEntity(uint32_t nodeId, entt::entity entity) {
+    if (entity != entt::null) {
+        entityNodes[entity] = nodeId;
     }
 }
 
-void Scene::updateWorldTransforms(entt::registry& world) {
-    for (uint32_t rootId : rootNodeIds) {
-        updateWorldTransformRecursive(rootId, glm::mat4(1.0f), world);
+void Scene::unbindEntity(uint32_t nodeId, entt::entity entity) {
+    auto it = entityNodes.find(entity);
+    if (it != entityNodes.end() && it->second == nodeId) {
+        entityNodes.erase(it);
     }
 }
 
-glm::mat4 Scene::getWorldTransform(uint32_t nodeId, entt::registry& world) const {
+void Scene::traverseNodes(uint32_t nodeId, const eastl::function<void(const Node&)>& visitor) const {
     const Node* node = getNode(nodeId);
-    if (!node || node->entity == entt::null) {
-        return glm::mat4(1.0f);
-    }
+    while (node) {
+        visitor(*node);
 
-    auto* transformComp = world.try_get<TransformComponent>(node->entity);
-    if (transformComp) {
-        return transformComp->world.getMatrix();
+        // Down to the first child, else on to the next sibling of the nearest ancestor that has one
+        if (node->firstChildId != 0) {
+            node = getNode(node->firstChildId);
+            continue;
+        }
+        while (node->id != nodeId && node->nextSiblingId == 0) {
+            node = getNode(node->parentId);
+        }
+        node = node->id != nodeId ? getNode(node->nextSiblingId) : nullptr;
     }
+}
 
-    return glm::mat4(1.0f);
+void Scene::traverseAllNodes(const eastl::function<void(const Node&)>& visitor) const {
+    for (const Node* root = getNode(firstRootId); root; root = getNode(root->nextSiblingId)) {
+        traverseNodes(root->id, visitor);
+    }
 }
 
-void Scene::clear() {
-    cleanup();
+void Scene::markTransformDirty(entt::registry& world, entt::entity entity) {
+    if (auto* transform = world.try_get<TransformComponent>(entity)) {
+        transform->dirty = true;
+    }
+    pendingDirtyEntities.push_back(entity);
 }
 
-void Scene::updateWorldTransformRecursive(uint32_t nodeId, const glm::mat4& parentTransform, entt::registry& world) {
-    const Node* node = getNode(nodeId);
-    if (!node || node->entity == entt::null) {
+void Scene::updateWorldTransforms(entt::registry& world, ThreadPool* threadPool) {
+    auto& transforms = world.storage<TransformComponent>();
+    const bool rebuilt = hierarchyDirty;
+    if (rebuilt) {
+        rebuildTransformHierarchy(world);  // Everything updates once
+    } else {
+        // Locals are read now rather than when marked, so edits made after marking count
+        for (entt::entity entity : pendingDirtyEntities) {
+            auto it = entityNodes.find(entity);
+            if (it != entityNodes.end() && transforms.contains(entity)) {
+                const Transform& local = transforms.get(entity).local;
+                transformHierarchy.setLocal(findSlot(it->second)->hierarchyIndex, local.position, local.rotation,
+                                            local.scale);
+            }
+        }
+    }
+    pendingDirtyEntities.clear();
+
+    transformHierarchy.update(threadPool);
+
+    // Only nodes whose own or inherited transform changed are rewritten; clean subtrees keep
+    // their world transform and cost nothing
+    auto& meshes = world.storage<MeshComponent>();
+    const auto& updatedNodes = transformHierarchy.getUpdatedNodes();
+    auto writeBack = [&](uint32_t index) {
+        TransformComponent& transform = transforms.get(hierarchyEntities[index]);
+        transform.worldMatrix    = transformHierarchy.getWorldMatrix(index);
+        transform.world.position = transformHierarchy.getWorldPosition(index);
+        transform.world.rotation = transformHierarchy.getWorldRotation(index);
+        transform.world.scale    = transformHierarchy.getWorldScale(index);
+        transform.dirty          = false;
+        if (meshes.contains(hierarchyEntities[index])) {
+            meshes.get(hierarchyEntities[index]).dirty = true;
+        }
+    };
+
+    // Each node writes only its own entity's components, so large batches split across the pool
+    if (!rebuilt && threadPool && updatedNodes.size() >= TransformHierarchy::PARALLEL_UPDATE_THRESHOLD) {
+        constexpr uint32_t chunkSize = 1024;
+        threadPool->parallelFor(static_cast<uint32_t>(updatedNodes.size()), chunkSize, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                if (transforms.contains(hierarchyEntities[updatedNodes[i]])) {
+                    writeBack(updatedNodes[i]);
+                }
+            }
+        });
+        for (uint32_t index : updatedNodes) {
+            if (transforms.contains(hierarchyEntities[index])) {
+                changedEntities.push_back(hierarchyEntities[index]);
+            }
+        }
         return;
     }
 
-    auto* transformComp = world.try_get<TransformComponent>(node->entity);
-    if (transformComp) {
-        glm::mat4 localMatrix = transformComp->local.getMatrix();
-        glm::mat4 worldMatrix = parentTransform * localMatrix;
-
-        // Decompose world matrix back to transform components
-        glm::vec3 scale, translation, skew;
-        glm::vec4 perspective;
-        glm::quat orientation;
-        glm::decompose(worldMatrix, scale, orientation, translation, skew, perspective);
-
-        transformComp->world.position = translation;
-        transformComp->world.rotation = orientation;
-        transformComp->world.scale = scale;
-        transformComp->dirty = false;
-
-        // Recursively update children
-        for (uint32_t childId : node->childrenIds) {
-            updateWorldTransformRecursive(childId, worldMatrix, world);
+    for (uint32_t index : updatedNodes) {
+        const entt::entity entity = hierarchyEntities[index];
+        if (!transforms.contains(entity)) {
+            continue;  // No transform of its own: passes the parent's through
         }
+        const TransformComponent& transform = transforms.get(entity);
+        if (rebuilt && !transform.dirty && transform.worldMatrix == transformHierarchy.getWorldMatrix(index)) {
+            continue;  // Only the structure changed around it
+        }
+        writeBack(index);
+        changedEntities.push_back(entity);
     }
 }
 
-void Scene::removeFromParent(uint32_t nodeId) {
-    Node* node = getNode(nodeId);
-    if (!node || node->parentId == 0) {
-        auto rootIt = eastl::find(rootNodeIds.begin(), rootNodeIds.end(), nodeId);
-        if (rootIt != rootNodeIds.end()) {
-            rootNodeIds.erase(rootIt);
+void Scene::rebuildTransformHierarchy(entt::registry& world) {
+    transformHierarchy.clear();
+    hierarchyEntities.clear();
+    transformHierarchy.reserve(static_cast<uint32_t>(nodes.size()));
+    hierarchyEntities.reserve(nodes.size());
+
+    // Breadth first, so parents precede their children
+    eastl::vector<eastl::pair<uint32_t, uint32_t>> queue;  // Node id, parent index
+    queue.reserve(nodes.size());
+    for (const Node* root = getNode(firstRootId); root; root = getNode(root->nextSiblingId)) {
+        queue.push_back({root->id, TransformHierarchy::NO_PARENT});
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const auto [nodeId, parentIndex] = queue[head];
+        NodeSlot* slot = findSlot(nodeId);
+        const Node& node = nodes[slot->denseIndex];
+
+        const uint32_t index = transformHierarchy.add(parentIndex);
+        slot->hierarchyIndex = index;
+        hierarchyEntities.push_back(node.entity);
+        if (const auto* transform = world.try_get<TransformComponent>(node.entity)) {
+            transformHierarchy.setLocal(index, transform->local.position, transform->local.rotation,
+                                        transform->local.scale);
         }
-        return;
+        for (const Node* child = getNode(node.firstChildId); child; child = getNode(child->nextSiblingId)) {
+            queue.push_back({child->id, index});
+        }
+    }
+    hierarchyDirty = false;
+}
+
+glm::mat4 Scene::getWorldTransform(uint32_t nodeId, entt::registry& world) const {
+    const Node* node = getNode(nodeId);
+    if (!node || node->entity == entt::null) {
+        return glm::mat4(1.0f);
     }
 
-    Node* parent = getNode(node->parentId);
-    if (parent) {
-        parent->removeChild(nodeId);
+    auto* transformComp = world.try_get<TransformComponent>(node->entity);
+    if (transformComp) {
+        return transformComp->worldMatrix;
     }
+
+    return glm::mat4(1.0f);
+}
+
+void Scene::clear() {
+    cleanup();
 }
 
 void Scene::mergeScene(const Scene* sourceScene) {
@@ -260,10 +433,9 @@ void Scene::mergeScene(const Scene* sourceScene) {
     }
 
     eastl::hash_map<uint32_t, uint32_t> nodeIdMapping;
-    const auto& sourceRootNodes = sourceScene->getRootNodes();
-
-    for (uint32_t sourceRootId : sourceRootNodes) {
-        mergeNodeHierarchy(sourceScene, sourceRootId, 0, nodeIdMapping);
+    for (const Node* root = sourceScene->getNode(sourceScene->getFirstRootNode()); root;
+         root = sourceScene->getNode(root->nextSiblingId)) {
+        mergeNodeHierarchy(sourceScene, root->id, 0, nodeIdMapping);
     }
 }
 
@@ -273,16 +445,15 @@ void Scene::mergeNodeHierarchy(const Scene* sourceScene, uint32_t sourceNodeId,
     if (!sourceNode) return;
 
     Node newNode = *sourceNode;
-    newNode.id = 0;
     newNode.parentId = targetParentId;
-    newNode.childrenIds.clear();
 
     uint32_t newNodeId = addNode(newNode);
     nodeIdMapping[sourceNodeId] = newNodeId;
 
     //  merge all children
-    for (uint32_t childSourceId : sourceNode->childrenIds) {
-        mergeNodeHierarchy(sourceScene, childSourceId, newNodeId, nodeIdMapping);
+    for (const Node* child = sourceScene->getNode(sourceNode->firstChildId); child;
+         child = sourceScene->getNode(child->nextSiblingId)) {
+        mergeNodeHierarchy(sourceScene, child->id, newNodeId, nodeIdMapping);
     }
 }
 
@@ -305,17 +476,13 @@ glm::mat4 Scene::convertWorldToLocal(uint32_t nodeId, const glm::mat4& worldMatr
 }
 
 uint32_t Scene::findNodeIdForEntity(entt::entity entity) const {
-    for (const auto& [nodeId, node] : nodes) {
-        if (node.entity == entity) {
-            return nodeId;
-        }
-    }
-    return 0; // Return 0 if not found (invalid node ID)
+    auto it = entityNodes.find(entity);
+    return it != entityNodes.end() ? it->second : 0; // Return 0 if not found (invalid node ID)
 }
 
 // Create scene from pre-loaded GLTFAsset
 eastl::unique_ptr<Scene> Scene::createFromAsset(
-    const GLTFAsset* asset,
+    eastl::shared_ptr<const GLTFAsset> asset,
     ResourceManager& resourceMgr,
     ForwardRenderer& renderer,
     entt::registry& world,
@@ -333,20 +500,78 @@ eastl::unique_ptr<Scene> Scene::createFromAsset(
         asset->textures.size()
     );
 
-    VulkanContext* context = renderer.getContext();
-    MaterialManager* materialManager = renderer.getMaterialManager();
-
     // Step 1: Create GPU textures from asset data
-    // 根据glTF 2.0规范，需要判断纹理用途来决定是否使用sRGB：
-    // - baseColorTexture, emissiveTexture → sRGB (颜色数据)
-    // - normalTexture, metallicRoughnessTexture, occlusionTexture → Linear (数值数据)
+    const eastl::vector<bool> isSRGB = findSRGBTextures(asset->materials, asset->textures.size());
     eastl::vector<Texture*> textures(asset->textures.size());
+    for (size_t i = 0; i < asset->textures.size(); i++) {
+        const auto& texData = asset->textures[i];
+        textures[i] = createTexture(renderer, texData.pixels.data(), texData.pixels.size(), texData.width,
+                                    texData.height, texData.channels, texData.uri, isSRGB[i]);
+    }
+
+    // Step 2: Create materials
+    if (!renderer.getPBRBindlessMaterial()) {
+        violet::Log::error("Scene", "PBR bindless material not initialized");
+        return scene;
+    }
+    const eastl::vector<uint32_t> materialIds =
+        createMaterials(asset->materials, textures, renderer, filePath, defaultTexture);
+
+    // Step 3: Create scene nodes with optional parent grouping
+    size_t lastSlash = filePath.find_last_of("/\\");
+    size_t lastDot = filePath.find_last_of(".");
+    eastl::string modelName = filePath.substr(
+        lastSlash != eastl::string::npos ? lastSlash + 1 : 0,
+        lastDot != eastl::string::npos ? lastDot - (lastSlash != eastl::string::npos ? lastSlash + 1 : 0) : eastl::string::npos
+    );
+
+    uint32_t parentNodeId = 0;
+    if (asset->rootNodes.size() > 1 || !modelName.empty()) {
+        Node parentNode;
+        parentNode.name = modelName.empty() ? "Imported Model" : modelName;
+        parentNode.parentId = 0;
+
+        // Create entity with transform for parent node (scale = 1.0)
+        auto parentEntity = world.create();
+        TransformComponent parentTransform;
+        parentTransform.local.position = glm::vec3(0.0f);
+        parentTransform.local.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        parentTransform.local.scale = glm::vec3(1.0f);
+        parentTransform.setWorld(parentTransform.local);
+        parentTransform.dirty = false;
+        world.emplace<TransformComponent>(parentEntity, parentTransform);
+
+        parentNode.entity = parentEntity;
+        parentNodeId = scene->addNode(parentNode);
+        violet::Log::info("Scene", "Created parent node '{}' for imported model", parentNode.name.c_str());
+    }
+
+    // Step 4: Create nodes and meshes
+    for (uint32_t rootNodeIdx : asset->rootNodes) {
+        createNodesFromAsset(scene.get(), asset.get(), resourceMgr, renderer, world, rootNodeIdx, parentNodeId, materialIds);
+    }
+
+    violet::Log::info("Scene", "Scene created successfully: {} nodes", scene->getNodeCount());
+
+    // Step 5: Snapshot the import for the next load of this file
+    scene->saveCachedSnapshot(asset, materialIds, world, filePath, resourceMgr);
+
+    // Step 6: Build the BVH on the next frame, once the caller has computed world transforms
+    renderer.markSceneLoaded();
+
+    return scene;
+}
 
+// 根据glTF 2.0规范，需要判断纹理用途来决定是否使用sRGB：
+// - baseColorTexture, emissiveTexture → sRGB (颜色数据)
+// - normalTexture, metallicRoughnessTexture, occlusionTexture → Linear (数值数据)
+eastl::vector<bool> Scene::findSRGBTextures(const eastl::vector<GLTFAsset::MaterialData>& materials,
+                                            size_t textureCount) {
     // 建立texture index到sRGB标志的映射
-    eastl::vector<bool> isSRGB(asset->textures.size(), false);
+    eastl::vector<bool> isSRGB(textureCount, false);
 
     // 扫描所有材质，标记哪些纹理应该用sRGB
-    for (const auto& matData : asset->materials) {
+    for (const auto& matData : materials) {
         // baseColorTexture → sRGB
         if (matData.baseColorTexIndex >= 0 && matData.baseColorTexIndex < (int)isSRGB.size()) {
             isSRGB[matData.baseColorTexIndex] = true;
@@ -357,43 +582,34 @@ eastl::unique_ptr<Scene> Scene::createFromAsset(
         }
         // normalTexture, metallicRoughnessTexture, occlusionTexture → Linear (默认false)
     }
+    return isSRGB;
+}
 
-    // 根据映射加载纹理
-    for (size_t i = 0; i < asset->textures.size(); i++) {
-        const auto& texData = asset->textures[i];
-        auto texture = eastl::make_unique<Texture>();
-
-        if (!texData.pixels.empty()) {
-            // Load from embedded data，根据用途使用正确的色彩空间
-            texture->loadFromMemory(
-                context,
-                texData.pixels.data(),
-                texData.pixels.size(),
-                texData.width,
-                texData.height,
-                texData.channels,
-                isSRGB[i]  // ✅ 根据纹理用途决定sRGB
-            );
-        } else if (!texData.uri.empty()) {
-            // Load from external file，根据纹理用途决定sRGB
-            texture->loadFromFile(context, texData.uri, isSRGB[i]);
-        }
+Texture* Scene::createTexture(ForwardRenderer& renderer, const uint8_t* pixels, size_t pixelSize, uint32_t width,
+                              uint32_t height, int channels, const eastl::string& uri, bool srgb) {
+    auto texture = eastl::make_unique<Texture>();
 
-        texture->setSampler(renderer.getDescriptorManager().getSampler(SamplerType::Default));
-        Texture* texturePtr = materialManager->addTexture(eastl::move(texture));
-        textures[i] = texturePtr;
+    if (pixelSize > 0) {
+        // Load from embedded data，根据用途使用正确的色彩空间
+        texture->loadFromMemory(renderer.getContext(), pixels, pixelSize, width, height, channels, srgb);
+    } else if (!uri.empty()) {
+        // Load from external file，根据纹理用途决定sRGB
+        texture->loadFromFile(renderer.getContext(), uri, srgb);
     }
 
-    // Step 2: Create materials
+    texture->setSampler(renderer.getDescriptorManager().getSampler(SamplerType::Default));
+    return renderer.getMaterialManager()->addTexture(eastl::move(texture));
+}
+
+eastl::vector<uint32_t> Scene::createMaterials(const eastl::vector<GLTFAsset::MaterialData>& materials,
+                                               const eastl::vector<Texture*>& textures, ForwardRenderer& renderer,
+                                               const eastl::string& filePath, Texture* defaultTexture) {
+    MaterialManager* materialManager = renderer.getMaterialManager();
     Material* pbrMaterial = renderer.getPBRBindlessMaterial();
-    if (!pbrMaterial) {
-        violet::Log::error("Scene", "PBR bindless material not initialized");
-        return scene;
-    }
 
-    eastl::vector<uint32_t> materialIds(asset->materials.size());
-    for (size_t i = 0; i < asset->materials.size(); i++) {
-        const auto& matData = asset->materials[i];
+    eastl::vector<uint32_t> materialIds(materials.size());
+    for (size_t i = 0; i < materials.size(); i++) {
+        const auto& matData = materials[i];
 
         // Create material instance
         MaterialInstanceDesc instanceDesc{
@@ -475,47 +691,7 @@ eastl::unique_ptr<Scene> Scene::createFromAsset(
         materialIds[i] = materialId;
     }
 
-    // Step 3: Create scene nodes with optional parent grouping
-    size_t lastSlash = filePath.find_last_of("/\\");
-    size_t lastDot = filePath.find_last_of(".");
-    eastl::string modelName = filePath.substr(
-        lastSlash != eastl::string::npos ? lastSlash + 1 : 0,
-        lastDot != eastl::string::npos ? lastDot - (lastSlash != eastl::string::npos ? lastSlash + 1 : 0) : eastl::string::npos
-    );
-
-    uint32_t parentNodeId = 0;
-    if (asset->rootNodes.size() > 1 || !modelName.empty()) {
-        Node parentNode;
-        parentNode.name = modelName.empty() ? "Imported Model" : modelName;
-        parentNode.parentId = 0;
-
-        // Create entity with transform for parent node (scale = 1.0)
-        auto parentEntity = world.create();
-        TransformComponent parentTransform;
-        parentTransform.local.position = glm::vec3(0.0f);
-        parentTransform.local.rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-        parentTransform.local.scale = glm::vec3(1.0f);
-        parentTransform.world = parentTransform.local;
-        parentTransform.dirty = false;
-        world.emplace<TransformComponent>(parentEntity, parentTransform);
-
-        parentNode.entity = parentEntity;
-        parentNodeId = scene->addNode(parentNode);
-        violet::Log::info("Scene", "Created parent node '{}' for imported model", parentNode.name.c_str());
-    }
-
-    // Step 4: Create nodes and meshes
-    for (uint32_t rootNodeIdx : asset->rootNodes) {
-        createNodesFromAsset(scene.get(), asset, resourceMgr, renderer, world, rootNodeIdx, parentNodeId, materialIds);
-    }
-
-    violet::Log::info("Scene", "Scene created successfully: {} nodes", scene->getNodeCount());
-
-    // Step 5: Build BVH
-    renderer.collectRenderables(world);
-    renderer.buildSceneBVH(world);
-
-    return scene;
+    return materialIds;
 }
 
 // Helper for creating nodes from asset data
@@ -540,11 +716,10 @@ void Scene::createNodesFromAsset(
     node.name = nodeData.name;
     node.parentId = parentId;
     uint32_t nodeId = scene->addNode(node);
-    Node* sceneNode = scene->getNode(nodeId);
 
     // Create ECS entity
     entt::entity entity = world.create();
-    sceneNode->entity = entity;
+    scene->setNodeEntity(nodeId, entity);
 
     // Add transform component
     TransformComponent transformComp;
@@ -561,6 +736,7 @@ void Scene::createNodesFromAsset(
             // Create GPU mesh
             auto meshPtr = eastl::make_unique<Mesh>();
             meshPtr->create(context, meshData.vertices, meshData.indices, meshData.submeshes);
+            meshPtr->setGeometry(meshData.geometry);
             world.emplace<MeshComponent>(entity, eastl::move(meshPtr));
 
             // Create material component
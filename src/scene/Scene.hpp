@@ -4,21 +4,23 @@
 
 #include <EASTL/functional.h>
 #include <EASTL/string.h>
-#include <EASTL/unordered_map.h>
 #include <EASTL/hash_map.h>
 #include <EASTL/vector.h>
 #include <EASTL/unique_ptr.h>
+#include <EASTL/shared_ptr.h>
 
 #include <entt/entt.hpp>
 
 #include "Node.hpp"
+#include "TransformHierarchy.hpp"
+#include "asset/GLTFAsset.hpp"
 
 namespace violet {
 
 class ResourceManager;
+class ThreadPool;
 class ForwardRenderer;
 class Texture;
-struct GLTFAsset;
 
 class Scene {
 public:
@@ -44,26 +46,71 @@ public:
         eastl::function<void(eastl::unique_ptr<Scene>, eastl::string)> callback
     );
 
+    // Binary snapshots (layout in SceneSnapshot.cpp): the node tree with its entities' transforms,
+    // mesh refs, material IDs and lights, plus the imported asset's meshes, triangle BVHs,
+    // materials and decoded textures. loadFromGLTF writes one after an import and loads it
+    // instead of the glTF while the source file is unchanged: the file is mapped, entities are
+    // created and their components inserted in bulk, with no JSON parsing or image decoding.
+    static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+    // Source path, size and modification time (0 if the file is missing). Files the glTF
+    // references (buffers, images) are not covered: touch the .gltf after editing them.
+    static uint64_t computeSnapshotKey(const eastl::string& sourcePath);
+    // asset and materialIds are what this scene was created from; meshes are referenced by the
+    // asset mesh their CPU geometry came from. False if a texture's pixels do not cover its size.
+    bool writeSnapshot(const GLTFAsset* asset, const eastl::vector<uint32_t>& materialIds,
+                       const entt::registry& world, uint64_t key, eastl::vector<uint8_t>& out) const;
+    // Returns null if the data is not a valid snapshot for key
+    static eastl::unique_ptr<Scene> loadSnapshot(
+        const uint8_t* data,
+        size_t size,
+        uint64_t key,
+        const eastl::string& filePath,
+        ResourceManager& resourceMgr,
+        ForwardRenderer& renderer,
+        entt::registry& world,
+        Texture* defaultTexture
+    );
+
     void cleanup();
 
+    // Nodes live in a generational slot map: ids stay valid until the node is removed, a removed
+    // id never aliases a later node (a slot is retired after 256 reuses rather than wrapping its
+    // generation), and lookups are O(1). The node's id and links are assigned
+    // here; its parentId picks the parent (0 or a missing parent makes it a root).
     uint32_t addNode(const Node& node);
     uint32_t addNode(const eastl::string& name, uint32_t parentId = 0);
 
+    // Pointers stay valid until the next addNode() or removeNode()
     Node* getNode(uint32_t nodeId);
     const Node* getNode(uint32_t nodeId) const;
 
     bool removeNode(uint32_t nodeId);
+    // Node entities must change through here so the transform hierarchy and entity lookup follow
+    void setNodeEntity(uint32_t nodeId, entt::entity entity);
 
     void setParent(uint32_t childId, uint32_t parentId);
     void addChild(uint32_t parentId, uint32_t childId);
 
-    const eastl::vector<uint32_t>& getRootNodes() const { return rootNodeIds; }
+    // Roots form a sibling list like children do: follow nextSiblingId from the first root
+    uint32_t getFirstRootNode() const { return firstRootId; }
+    uint32_t getRootNodeCount() const { return rootCount; }
     size_t getNodeCount() const { return nodes.size(); }
 
-    void traverseNodes(uint32_t nodeId, eastl::function<void(const Node&)> visitor) const;
-    void traverseAllNodes(eastl::function<void(const Node&)> visitor) const;
-
-    void updateWorldTransforms(entt::registry& world);
+    // Depth first, parents before children, without recursion
+    void traverseNodes(uint32_t nodeId, const eastl::function<void(const Node&)>& visitor) const;
+    void traverseAllNodes(const eastl::function<void(const Node&)>& visitor) const;
+
+    // Queues a node entity whose local transform changed (and sets its dirty flag); only queued
+    // entities and everything below them update, so a static scene updates in no time
+    void markTransformDirty(entt::registry& world, entt::entity entity);
+    // Pulls the queued local transforms into the flat hierarchy, updates the dirty subtrees and
+    // writes the world transforms of the nodes that changed back to their TransformComponents.
+    // With a thread pool, large updates run level by level on its workers.
+    void updateWorldTransforms(entt::registry& world, ThreadPool* threadPool = nullptr);
+    // Entities whose world transform changed, accumulated over updates until cleared by the consumer
+    const eastl::vector<entt::entity>& getChangedEntities() const { return changedEntities; }
+    void clearChangedEntities() { changedEntities.clear(); }
     glm::mat4 getWorldTransform(uint32_t nodeId, entt::registry& world) const;
 
     // Coordinate space transformation methods
@@ -81,16 +128,77 @@ public:
                            uint32_t targetParentId, eastl::hash_map<uint32_t, uint32_t>& nodeIdMapping);
 
 private:
-    eastl::unordered_map<uint32_t, Node> nodes;
-    eastl::vector<uint32_t> rootNodeIds;
-    uint32_t nextNodeId = 1;
-
-    void removeFromParent(uint32_t nodeId);
-    void updateWorldTransformRecursive(uint32_t nodeId, const glm::mat4& parentTransform, entt::registry& world);
+    // Node ids pack the slot index + 1 (so 0 stays invalid) below the slot's generation
+    static constexpr uint32_t NODE_INDEX_BITS = 24;
+    static constexpr uint32_t NODE_INDEX_MASK = (1u << NODE_INDEX_BITS) - 1;
+    static constexpr uint32_t MAX_NODE_GENERATION = ~0u >> NODE_INDEX_BITS;
+    static constexpr uint32_t INVALID_INDEX   = ~0u;
+
+    struct NodeSlot {
+        uint32_t denseIndex     = INVALID_INDEX;  // Into nodes; INVALID_INDEX while free
+        uint32_t generation     = 0;              // Bumped on removal, so stale ids miss; retired at the max
+        uint32_t hierarchyIndex = INVALID_INDEX;  // Into transformHierarchy, set on rebuild
+    };
+
+    eastl::vector<Node> nodes;  // Dense; removal moves the last node into the hole
+    eastl::vector<NodeSlot> nodeSlots;
+    eastl::vector<uint32_t> freeSlots;
+    eastl::hash_map<entt::entity, uint32_t> entityNodes;  // Entity to node id
+    uint32_t firstRootId = 0;
+    uint32_t lastRootId = 0;
+    uint32_t rootCount = 0;
+
+    // Flat transform hierarchy, rebuilt breadth first from the nodes when the structure changes
+    TransformHierarchy transformHierarchy;
+    eastl::vector<entt::entity> hierarchyEntities;  // Parallel to transformHierarchy
+    eastl::vector<entt::entity> pendingDirtyEntities;
+    eastl::vector<entt::entity> changedEntities;
+    bool hierarchyDirty = true;
+
+    NodeSlot* findSlot(uint32_t nodeId);
+    const NodeSlot* findSlot(uint32_t nodeId) const;
+    // Appends the node to its parent's child list, or the root list for parentId 0
+    void linkNode(Node& node, uint32_t parentId);
+    void unlinkNode(Node& node);
+    void bindEntity(uint32_t nodeId, entt::entity entity);
+    void unbindEntity(uint32_t nodeId, entt::entity entity);
+    void rebuildTransformHierarchy(entt::registry& world);
+
+    static eastl::string getSnapshotPath(const ResourceManager& resourceMgr, const eastl::string& sourcePath);
+    // Loads the snapshot of filePath if the cache holds a current one
+    static eastl::unique_ptr<Scene> loadCachedSnapshot(
+        const eastl::string& filePath,
+        ResourceManager& resourceMgr,
+        ForwardRenderer& renderer,
+        entt::registry& world,
+        Texture* defaultTexture
+    );
+    // Reads the registry here and leaves serialization and the file write to the thread pool,
+    // which keeps asset alive until the snapshot is written
+    void saveCachedSnapshot(eastl::shared_ptr<const GLTFAsset> asset, const eastl::vector<uint32_t>& materialIds,
+                            const entt::registry& world, const eastl::string& filePath,
+                            ResourceManager& resourceMgr) const;
+    // writeSnapshot in two halves: the first reads the scene and registry, so it runs where the
+    // world is owned; the second reads only the asset and may run on a worker
+    struct SnapshotTables;
+    void collectSnapshotTables(const GLTFAsset* asset, const eastl::vector<uint32_t>& materialIds,
+                               const entt::registry& world, SnapshotTables& tables) const;
+    static bool writeAssetSnapshot(const GLTFAsset* asset, SnapshotTables& tables, uint64_t key,
+                                   eastl::vector<uint8_t>& out);
+
+    // GPU textures and materials, shared by glTF import and snapshot loading
+    static eastl::vector<bool> findSRGBTextures(const eastl::vector<GLTFAsset::MaterialData>& materials,
+                                                size_t textureCount);
+    static Texture* createTexture(ForwardRenderer& renderer, const uint8_t* pixels, size_t pixelSize, uint32_t width,
+                                  uint32_t height, int channels, const eastl::string& uri, bool srgb);
+    static eastl::vector<uint32_t> createMaterials(const eastl::vector<GLTFAsset::MaterialData>& materials,
+                                                   const eastl::vector<Texture*>& textures,
+                                                   ForwardRenderer& renderer, const eastl::string& filePath,
+                                                   Texture* defaultTexture);
 
     // Helper for creating scene from pre-loaded GLTFAsset
     static eastl::unique_ptr<Scene> createFromAsset(
-        const GLTFAsset* asset,
+        eastl::shared_ptr<const GLTFAsset> asset,
         ResourceManager& resourceMgr,
         ForwardRenderer& renderer,
         entt::registry& world,
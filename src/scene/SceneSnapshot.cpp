@@ -0,0 +1,794 @@
+#include "Scene.hpp"
+#include "ecs/Components.hpp"
+#include "core/Log.hpp"
+#include "core/FileSystem.hpp"
+#include "core/ThreadPool.hpp"
+#include "resource/ResourceManager.hpp"
+#include "resource/Mesh.hpp"
+#include "resource/MeshGeometry.hpp"
+#include "renderer/ForwardRenderer.hpp"
+
+#include <EASTL/hash_map.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+
+namespace violet {
+
+namespace {
+
+// Snapshot layout: SnapshotHeader; the node, material ref, light, mesh, submesh, material and
+// texture tables, in that order; the string bytes; then the payload (vertices, indices, BVH
+// blobs and pixels), which starts 16-byte aligned and is addressed by offsets from its start.
+// Native endianness and raw Vertex and LightComponent records: like the BVH cache, snapshots
+// are a local cache, and the record sizes in the header reject files from another layout.
+constexpr uint32_t SNAPSHOT_MAGIC = 0x4E435356;  // "VSCN"
+constexpr uint32_t NONE           = ~0u;
+constexpr size_t   PAYLOAD_ALIGN  = 16;
+
+constexpr uint32_t NODE_HAS_ENTITY    = 1u << 0;
+constexpr uint32_t NODE_HAS_TRANSFORM = 1u << 1;
+
+static_assert(std::is_trivially_copyable_v<Vertex>);
+static_assert(std::is_trivially_copyable_v<LightComponent>);
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t vertexSize;
+    uint32_t lightSize;
+    uint32_t nodeCount;
+    uint32_t materialRefCount;
+    uint32_t lightCount;
+    uint32_t meshCount;
+    uint32_t subMeshCount;
+    uint32_t materialCount;
+    uint32_t textureCount;
+    uint32_t reserved;
+    uint64_t stringSize;
+    uint64_t payloadSize;
+};
+static_assert(sizeof(SnapshotHeader) == 72);
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotNode {
+    uint32_t       parent;  // Index of an earlier node, NONE for roots
+    uint32_t       flags;
+    SnapshotString name;
+    uint32_t       mesh;    // Mesh table index, NONE without a mesh
+    uint32_t       light;   // Light table index, NONE without a light
+    uint32_t       firstMaterialRef;
+    uint32_t       materialRefCount;
+    float          position[3];
+    float          rotation[4];  // x, y, z, w
+    float          scale[3];
+};
+static_assert(sizeof(SnapshotNode) == 72);
+
+struct SnapshotMaterialRef {
+    uint32_t subMeshMaterialIndex;
+    uint32_t material;  // Material table index, or a material ID from outside the asset
+    uint32_t global;    // Whether material is such an ID, kept as is on load
+};
+static_assert(sizeof(SnapshotMaterialRef) == 12);
+
+struct SnapshotMesh {
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t firstSubMesh;
+    uint32_t subMeshCount;
+};
+static_assert(sizeof(SnapshotMesh) == 32);
+
+struct SnapshotSubMesh {
+    uint64_t bvhOffset;
+    uint32_t bvhSize;  // 0 when the mesh has no CPU geometry
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t materialIndex;
+};
+static_assert(sizeof(SnapshotSubMesh) == 24);
+
+struct SnapshotMaterial {
+    float          baseColorFactor[4];
+    float          emissiveFactor[3];
+    float          metallicFactor;
+    float          roughnessFactor;
+    float          normalScale;
+    float          occlusionStrength;
+    float          alphaCutoff;
+    int32_t        textures[5];  // Base color, normal, metallic-roughness, occlusion, emissive
+    uint32_t       doubleSided;
+    SnapshotString name;
+    SnapshotString alphaMode;
+};
+static_assert(sizeof(SnapshotMaterial) == 88);
+
+struct SnapshotTexture {
+    uint64_t       pixelOffset;
+    uint64_t       pixelSize;  // 0 for textures loaded from uri
+    uint32_t       width;
+    uint32_t       height;
+    int32_t        channels;
+    uint32_t       srgb;
+    SnapshotString uri;
+};
+static_assert(sizeof(SnapshotTexture) == 40);
+
+template <typename T>
+void appendTable(eastl::vector<uint8_t>& out, const eastl::vector<T>& table) {
+    const size_t base = out.size();
+    out.resize(base + table.size() * sizeof(T));
+    if (!table.empty()) {
+        std::memcpy(out.data() + base, table.data(), table.size() * sizeof(T));
+    }
+}
+
+// Bounds-checked sequential reads over a mapped snapshot
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    template <typename T>
+    bool readTable(uint32_t count, eastl::vector<T>& table) {
+        const size_t bytes = static_cast<size_t>(count) * sizeof(T);
+        if (bytes > size - offset) {
+            return false;
+        }
+        table.resize(count);
+        if (count > 0) {
+            std::memcpy(table.data(), data + offset, bytes);
+        }
+        offset += bytes;
+        return true;
+    }
+
+    const uint8_t* take(uint64_t bytes) {
+        if (bytes > size - offset) {
+            return nullptr;
+        }
+        const uint8_t* start = data + offset;
+        offset += static_cast<size_t>(bytes);
+        return start;
+    }
+
+    bool align(size_t alignment) {
+        const size_t padding = (alignment - offset % alignment) % alignment;
+        return take(padding) != nullptr;
+    }
+
+    size_t remaining() const { return size - offset; }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+};
+
+SnapshotString addString(eastl::vector<uint8_t>& strings, const eastl::string& value) {
+    const SnapshotString result{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size())};
+    strings.insert(strings.end(), value.begin(), value.end());
+    return result;
+}
+
+bool inRange(uint64_t offset, uint64_t bytes, uint64_t size) {
+    return offset <= size && bytes <= size - offset;
+}
+
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+uint64_t hashString(uint64_t hash, const eastl::string& value) {
+    for (char c : value) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Bytes Texture::loadFromMemory reads for an 8-bit image, or 0 for dimensions it cannot upload.
+// The dimension limit keeps its int pixel arithmetic from overflowing.
+uint64_t getPixelSize(uint32_t width, uint32_t height, int32_t channels) {
+    constexpr uint32_t MAX_DIMENSION = 16384;
+    if (width == 0 || height == 0 || width > MAX_DIMENSION || height > MAX_DIMENSION || channels < 1 || channels > 4) {
+        return 0;
+    }
+    return uint64_t(width) * height * static_cast<uint32_t>(channels);
+}
+
+} // anonymous namespace
+
+uint64_t Scene::computeSnapshotKey(const eastl::string& sourcePath) {
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    const uintmax_t fileSize  = fs::file_size(sourcePath.c_str(), error);
+    if (error) {
+        return 0;
+    }
+    const auto      writeTime = fs::last_write_time(sourcePath.c_str(), error);
+    if (error) {
+        return 0;
+    }
+
+    uint64_t hash = hashString(FNV_OFFSET_BASIS, sourcePath);
+    auto mix = [&hash](uint64_t value) {
+        hash = (hash ^ value) * 1099511628211ull;
+    };
+    mix(SNAPSHOT_VERSION);
+    mix(static_cast<uint64_t>(fileSize));
+    mix(static_cast<uint64_t>(writeTime.time_since_epoch().count()));
+    return hash != 0 ? hash : 1;
+}
+
+eastl::string Scene::getSnapshotPath(const ResourceManager& resourceMgr, const eastl::string& sourcePath) {
+    // Named by source path alone, so a new import overwrites the snapshot it invalidated
+    eastl::string fileName;
+    fileName.sprintf("%016llx.vscene", static_cast<unsigned long long>(hashString(FNV_OFFSET_BASIS, sourcePath)));
+    return FileSystem::join(resourceMgr.getSceneCacheDirectory(), fileName);
+}
+
+// Everything that comes from the scene and the registry; writeAssetSnapshot adds the rest
+struct Scene::SnapshotTables {
+    eastl::vector<SnapshotNode>        nodes;
+    eastl::vector<SnapshotMaterialRef> materialRefs;
+    eastl::vector<LightComponent>      lights;
+    eastl::vector<uint8_t>             strings;
+};
+
+bool Scene::writeSnapshot(const GLTFAsset* asset, const eastl::vector<uint32_t>& materialIds,
+                          const entt::registry& world, uint64_t key, eastl::vector<uint8_t>& out) const {
+    SnapshotTables tables;
+    collectSnapshotTables(asset, materialIds, world, tables);
+    return writeAssetSnapshot(asset, tables, key, out);
+}
+
+void Scene::collectSnapshotTables(const GLTFAsset* asset, const eastl::vector<uint32_t>& materialIds,
+                                  const entt::registry& world, SnapshotTables& tables) const {
+    // Meshes are referenced by their shared CPU geometry, materials by their ID
+    eastl::hash_map<const MeshGeometry*, uint32_t> meshIndices;
+    for (uint32_t i = 0; i < asset->meshes.size(); ++i) {
+        if (asset->meshes[i].geometry) {
+            meshIndices[asset->meshes[i].geometry.get()] = i;
+        }
+    }
+    eastl::hash_map<uint32_t, uint32_t> materialIndices;
+    for (uint32_t i = 0; i < asset->materials.size() && i < materialIds.size(); ++i) {
+        materialIndices[materialIds[i]] = i;
+    }
+
+    // Nodes breadth first, so every parent precedes its children
+    eastl::vector<eastl::pair<uint32_t, uint32_t>> queue;  // Node id, parent index
+    queue.reserve(nodes.size());
+    for (const Node* root = getNode(firstRootId); root; root = getNode(root->nextSiblingId)) {
+        queue.push_back({root->id, NONE});
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const Node& node = *getNode(queue[head].first);
+
+        SnapshotNode& record     = tables.nodes.push_back();
+        record.parent            = queue[head].second;
+        record.flags             = 0;
+        record.name              = addString(tables.strings, node.name);
+        record.mesh              = NONE;
+        record.light             = NONE;
+        record.firstMaterialRef  = static_cast<uint32_t>(tables.materialRefs.size());
+        record.materialRefCount  = 0;
+
+        const Transform identity;
+        const Transform* local = &identity;
+        if (node.entity != entt::null && world.valid(node.entity)) {
+            record.flags |= NODE_HAS_ENTITY;
+
+            if (const auto* transform = world.try_get<TransformComponent>(node.entity)) {
+                record.flags |= NODE_HAS_TRANSFORM;
+                local = &transform->local;
+            }
+            if (const auto* meshComp = world.try_get<MeshComponent>(node.entity); meshComp && meshComp->mesh) {
+                auto it = meshIndices.find(meshComp->mesh->getGeometry());
+                if (it != meshIndices.end()) {
+                    record.mesh = it->second;
+                } else {
+                    violet::Log::warn("Scene", "Snapshot skips mesh of node '{}': not from the imported asset",
+                                      node.name.c_str());
+                }
+            }
+            if (const auto* materialComp = world.try_get<MaterialComponent>(node.entity)) {
+                for (const auto& entry : materialComp->materialIndexToId) {
+                    auto it = materialIndices.find(entry.second);
+                    tables.materialRefs.push_back(it != materialIndices.end()
+                                                   ? SnapshotMaterialRef{entry.first, it->second, 0u}
+                                                   : SnapshotMaterialRef{entry.first, entry.second, 1u});
+                }
+                record.materialRefCount = static_cast<uint32_t>(tables.materialRefs.size()) - record.firstMaterialRef;
+            }
+            if (const auto* light = world.try_get<LightComponent>(node.entity)) {
+                record.light = static_cast<uint32_t>(tables.lights.size());
+                tables.lights.push_back(*light);
+            }
+        }
+        std::memcpy(record.position, &local->position[0], sizeof(record.position));
+        const float rotation[4] = {local->rotation.x, local->rotation.y, local->rotation.z, local->rotation.w};
+        std::memcpy(record.rotation, rotation, sizeof(record.rotation));
+        std::memcpy(record.scale, &local->scale[0], sizeof(record.scale));
+
+        const uint32_t index = static_cast<uint32_t>(tables.nodes.size()) - 1;
+        for (const Node* child = getNode(node.firstChildId); child; child = getNode(child->nextSiblingId)) {
+            queue.push_back({child->id, index});
+        }
+    }
+}
+
+bool Scene::writeAssetSnapshot(const GLTFAsset* asset, SnapshotTables& tables, uint64_t key,
+                               eastl::vector<uint8_t>& out) {
+    // Snapshots store exactly the bytes a texture upload reads, which these images do not have
+    for (const GLTFAsset::TextureData& texData : asset->textures) {
+        const uint64_t pixelSize = getPixelSize(texData.width, texData.height, texData.channels);
+        if (!texData.pixels.empty() && (pixelSize == 0 || texData.pixels.size() < pixelSize)) {
+            return false;
+        }
+    }
+
+    eastl::vector<SnapshotMesh>     meshTable;
+    eastl::vector<SnapshotSubMesh>  subMeshTable;
+    eastl::vector<SnapshotMaterial> materialTable;
+    eastl::vector<SnapshotTexture>  textureTable;
+    eastl::vector<uint8_t>          payload;
+
+    auto addPayload = [&payload](const void* data, size_t size) {
+        const uint64_t offset = (payload.size() + PAYLOAD_ALIGN - 1) & ~uint64_t(PAYLOAD_ALIGN - 1);
+        payload.resize(offset + size);
+        if (size > 0) {
+            std::memcpy(payload.data() + offset, data, size);
+        }
+        return offset;
+    };
+
+    eastl::vector<uint8_t> bvhBlob;
+    for (const GLTFAsset::MeshData& meshData : asset->meshes) {
+        SnapshotMesh& mesh = meshTable.push_back();
+        mesh.vertexOffset  = addPayload(meshData.vertices.data(), meshData.vertices.size() * sizeof(Vertex));
+        mesh.indexOffset   = addPayload(meshData.indices.data(), meshData.indices.size() * sizeof(uint32_t));
+        mesh.vertexCount   = static_cast<uint32_t>(meshData.vertices.size());
+        mesh.indexCount    = static_cast<uint32_t>(meshData.indices.size());
+        mesh.firstSubMesh  = static_cast<uint32_t>(subMeshTable.size());
+        mesh.subMeshCount  = static_cast<uint32_t>(meshData.submeshes.size());
+
+        for (uint32_t s = 0; s < meshData.submeshes.size(); ++s) {
+            const SubMesh& subMeshData = meshData.submeshes[s];
+            SnapshotSubMesh& subMesh   = subMeshTable.push_back();
+            subMesh.firstIndex         = subMeshData.firstIndex;
+            subMesh.indexCount         = subMeshData.indexCount;
+            subMesh.materialIndex      = subMeshData.materialIndex;
+            subMesh.bvhOffset          = 0;
+            subMesh.bvhSize            = 0;
+            if (meshData.geometry && s < meshData.geometry->subMeshes.size()) {
+                bvhBlob.clear();
+                meshData.geometry->serializeSubMesh(s, bvhBlob);
+                subMesh.bvhOffset = addPayload(bvhBlob.data(), bvhBlob.size());
+                subMesh.bvhSize   = static_cast<uint32_t>(bvhBlob.size());
+            }
+        }
+    }
+
+    for (const GLTFAsset::MaterialData& matData : asset->materials) {
+        SnapshotMaterial& material = materialTable.push_back();
+        std::memcpy(material.baseColorFactor, &matData.baseColorFactor[0], sizeof(material.baseColorFactor));
+        std::memcpy(material.emissiveFactor, &matData.emissiveFactor[0], sizeof(material.emissiveFactor));
+        material.metallicFactor    = matData.metallicFactor;
+        material.roughnessFactor   = matData.roughnessFactor;
+        material.normalScale       = matData.normalScale;
+        material.occlusionStrength = matData.occlusionStrength;
+        material.alphaCutoff       = matData.alphaCutoff;
+        material.textures[0]       = matData.baseColorTexIndex;
+        material.textures[1]       = matData.normalTexIndex;
+        material.textures[2]       = matData.metallicRoughnessTexIndex;
+        material.textures[3]       = matData.occlusionTexIndex;
+        material.textures[4]       = matData.emissiveTexIndex;
+        material.doubleSided       = matData.doubleSided ? 1u : 0u;
+        material.name              = addString(tables.strings, matData.name);
+        material.alphaMode         = addString(tables.strings, matData.alphaMode);
+    }
+
+    // Decoded pixels, so loading uploads them without touching the image files
+    const eastl::vector<bool> isSRGB = findSRGBTextures(asset->materials, asset->textures.size());
+    for (uint32_t i = 0; i < asset->textures.size(); ++i) {
+        const GLTFAsset::TextureData& texData = asset->textures[i];
+        // 16-bit images hold more, but their upload reads no further than this either
+        const uint64_t pixelSize = texData.pixels.empty() ? 0 : getPixelSize(texData.width, texData.height, texData.channels);
+        SnapshotTexture& texture = textureTable.push_back();
+        texture.pixelOffset      = addPayload(texData.pixels.data(), pixelSize);
+        texture.pixelSize        = pixelSize;
+        texture.width            = texData.width;
+        texture.height           = texData.height;
+        texture.channels         = texData.channels;
+        texture.srgb             = isSRGB[i] ? 1u : 0u;
+        texture.uri              = addString(tables.strings, texData.pixels.empty() ? texData.uri : eastl::string());
+    }
+
+    SnapshotHeader header{};
+    header.magic            = SNAPSHOT_MAGIC;
+    header.version          = SNAPSHOT_VERSION;
+    header.key              = key;
+    header.vertexSize       = sizeof(Vertex);
+    header.lightSize        = sizeof(LightComponent);
+    header.nodeCount        = static_cast<uint32_t>(tables.nodes.size());
+    header.materialRefCount = static_cast<uint32_t>(tables.materialRefs.size());
+    header.lightCount       = static_cast<uint32_t>(tables.lights.size());
+    header.meshCount        = static_cast<uint32_t>(meshTable.size());
+    header.subMeshCount     = static_cast<uint32_t>(subMeshTable.size());
+    header.materialCount    = static_cast<uint32_t>(materialTable.size());
+    header.textureCount     = static_cast<uint32_t>(textureTable.size());
+    header.stringSize       = tables.strings.size();
+    header.payloadSize      = payload.size();
+
+    const size_t base = out.size();
+    out.resize(base + sizeof(header));
+    std::memcpy(out.data() + base, &header, sizeof(header));
+    appendTable(out, tables.nodes);
+    appendTable(out, tables.materialRefs);
+    appendTable(out, tables.lights);
+    appendTable(out, meshTable);
+    appendTable(out, subMeshTable);
+    appendTable(out, materialTable);
+    appendTable(out, textureTable);
+    appendTable(out, tables.strings);
+    out.resize(base + ((out.size() - base + PAYLOAD_ALIGN - 1) & ~(PAYLOAD_ALIGN - 1)), 0);
+    appendTable(out, payload);
+    return true;
+}
+
+eastl::unique_ptr<Scene> Scene::loadSnapshot(
+    const uint8_t* data,
+    size_t size,
+    uint64_t key,
+    const eastl::string& filePath,
+    ResourceManager& resourceMgr,
+    ForwardRenderer& renderer,
+    entt::registry& world,
+    Texture* defaultTexture
+) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Validate everything before creating anything, so a bad file costs nothing but the check
+    SnapshotHeader header;
+    if (!data || size < sizeof(header)) {
+        return nullptr;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.key != key ||
+        header.vertexSize != sizeof(Vertex) || header.lightSize != sizeof(LightComponent)) {
+        return nullptr;
+    }
+
+    SnapshotReader reader(data, size);
+    reader.take(sizeof(header));
+
+    eastl::vector<SnapshotNode>        nodeTable;
+    eastl::vector<SnapshotMaterialRef> materialRefTable;
+    eastl::vector<LightComponent>      lightTable;
+    eastl::vector<SnapshotMesh>        meshTable;
+    eastl::vector<SnapshotSubMesh>     subMeshTable;
+    eastl::vector<SnapshotMaterial>    materialTable;
+    eastl::vector<SnapshotTexture>     textureTable;
+    if (!reader.readTable(header.nodeCount, nodeTable) || !reader.readTable(header.materialRefCount, materialRefTable) ||
+        !reader.readTable(header.lightCount, lightTable) || !reader.readTable(header.meshCount, meshTable) ||
+        !reader.readTable(header.subMeshCount, subMeshTable) || !reader.readTable(header.materialCount, materialTable) ||
+        !reader.readTable(header.textureCount, textureTable)) {
+        return nullptr;
+    }
+    const char* strings = reinterpret_cast<const char*>(reader.take(header.stringSize));
+    if (!strings || !reader.align(PAYLOAD_ALIGN)) {
+        return nullptr;
+    }
+    const uint8_t* payload = reader.take(header.payloadSize);
+    if (!payload || reader.remaining() != 0) {
+        return nullptr;
+    }
+
+    auto validString = [&](const SnapshotString& string) {
+        return inRange(string.offset, string.length, header.stringSize);
+    };
+    auto getString = [&](const SnapshotString& string) {
+        return eastl::string(strings + string.offset, string.length);
+    };
+
+    for (uint32_t i = 0; i < header.nodeCount; ++i) {
+        const SnapshotNode& node = nodeTable[i];
+        if ((node.parent != NONE && node.parent >= i) || !validString(node.name) ||
+            (node.mesh != NONE && node.mesh >= header.meshCount) ||
+            (node.light != NONE && node.light >= header.lightCount) ||
+            !inRange(node.firstMaterialRef, node.materialRefCount, header.materialRefCount) ||
+            ((node.mesh != NONE || node.light != NONE || node.materialRefCount > 0 ||
+              (node.flags & NODE_HAS_TRANSFORM)) && !(node.flags & NODE_HAS_ENTITY))) {
+            return nullptr;
+        }
+    }
+    for (const SnapshotMaterialRef& ref : materialRefTable) {
+        if (!ref.global && ref.material >= header.materialCount) {
+            return nullptr;
+        }
+    }
+    for (const SnapshotMesh& mesh : meshTable) {
+        if (!inRange(mesh.vertexOffset, uint64_t(mesh.vertexCount) * sizeof(Vertex), header.payloadSize) ||
+            !inRange(mesh.indexOffset, uint64_t(mesh.indexCount) * sizeof(uint32_t), header.payloadSize) ||
+            !inRange(mesh.firstSubMesh, mesh.subMeshCount, header.subMeshCount)) {
+            return nullptr;
+        }
+        for (uint32_t s = mesh.firstSubMesh; s < mesh.firstSubMesh + mesh.subMeshCount; ++s) {
+            const SnapshotSubMesh& subMesh = subMeshTable[s];
+            if (!inRange(subMesh.firstIndex, subMesh.indexCount, mesh.indexCount) ||
+                !inRange(subMesh.bvhOffset, subMesh.bvhSize, header.payloadSize)) {
+                return nullptr;
+            }
+        }
+    }
+    for (const SnapshotMaterial& material : materialTable) {
+        if (!validString(material.name) || !validString(material.alphaMode)) {
+            return nullptr;
+        }
+    }
+    for (const SnapshotTexture& texture : textureTable) {
+        if (!inRange(texture.pixelOffset, texture.pixelSize, header.payloadSize) || !validString(texture.uri) ||
+            (texture.pixelSize != 0 && texture.pixelSize != getPixelSize(texture.width, texture.height, texture.channels))) {
+            return nullptr;
+        }
+    }
+
+    // CPU side of every mesh in parallel: copies out of the mapping, index checks, and the
+    // triangle BVHs restored from their cached topology
+    struct MeshSource {
+        eastl::vector<Vertex>             vertices;
+        eastl::vector<uint32_t>           indices;
+        eastl::vector<SubMesh>            subMeshes;
+        eastl::shared_ptr<MeshGeometry>   geometry;
+    };
+    eastl::vector<MeshSource> meshSources(header.meshCount);
+    std::atomic<bool> meshesValid{true};
+    auto prepareMeshes = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t m = begin; m < end; ++m) {
+            const SnapshotMesh& mesh = meshTable[m];
+            MeshSource& source = meshSources[m];
+
+            source.vertices.resize(mesh.vertexCount);
+            if (mesh.vertexCount > 0) {
+                std::memcpy(source.vertices.data(), payload + mesh.vertexOffset, mesh.vertexCount * sizeof(Vertex));
+            }
+            source.indices.resize(mesh.indexCount);
+            if (mesh.indexCount > 0) {
+                std::memcpy(source.indices.data(), payload + mesh.indexOffset, mesh.indexCount * sizeof(uint32_t));
+            }
+            for (uint32_t index : source.indices) {
+                if (index >= mesh.vertexCount) {
+                    meshesValid = false;
+                    return;
+                }
+            }
+
+            auto geometry = eastl::make_shared<MeshGeometry>();
+            geometry->positions.reserve(mesh.vertexCount);
+            for (const Vertex& vertex : source.vertices) {
+                geometry->positions.push_back(vertex.pos);
+            }
+            geometry->indices = source.indices;
+
+            source.subMeshes.reserve(mesh.subMeshCount);
+            geometry->subMeshes.reserve(mesh.subMeshCount);
+            for (uint32_t s = mesh.firstSubMesh; s < mesh.firstSubMesh + mesh.subMeshCount; ++s) {
+                const SnapshotSubMesh& subMesh = subMeshTable[s];
+                source.subMeshes.push_back(SubMesh(subMesh.firstIndex, subMesh.indexCount, subMesh.materialIndex));
+                geometry->addSubMesh(subMesh.firstIndex, subMesh.indexCount,
+                                     subMesh.bvhSize > 0 ? payload + subMesh.bvhOffset : nullptr, subMesh.bvhSize);
+            }
+            source.geometry = eastl::move(geometry);
+        }
+    };
+    ThreadPool* threadPool = resourceMgr.getThreadPool();
+    if (threadPool && threadPool->getThreadCount() > 0) {
+        threadPool->parallelFor(header.meshCount, 1, prepareMeshes);
+    } else {
+        prepareMeshes(0, header.meshCount);
+    }
+    if (!meshesValid) {
+        return nullptr;
+    }
+
+    if (!renderer.getPBRBindlessMaterial()) {
+        violet::Log::error("Scene", "PBR bindless material not initialized");
+        return nullptr;
+    }
+
+    // Textures straight from the mapping, then materials through the same path as an import
+    eastl::vector<Texture*> textures(header.textureCount);
+    for (uint32_t i = 0; i < header.textureCount; ++i) {
+        const SnapshotTexture& texture = textureTable[i];
+        textures[i] = createTexture(renderer, payload + texture.pixelOffset, texture.pixelSize, texture.width,
+                                    texture.height, texture.channels, getString(texture.uri), texture.srgb != 0);
+    }
+
+    eastl::vector<GLTFAsset::MaterialData> materials(header.materialCount);
+    for (uint32_t i = 0; i < header.materialCount; ++i) {
+        const SnapshotMaterial& material   = materialTable[i];
+        GLTFAsset::MaterialData& matData   = materials[i];
+        std::memcpy(&matData.baseColorFactor[0], material.baseColorFactor, sizeof(material.baseColorFactor));
+        std::memcpy(&matData.emissiveFactor[0], material.emissiveFactor, sizeof(material.emissiveFactor));
+        matData.metallicFactor            = material.metallicFactor;
+        matData.roughnessFactor           = material.roughnessFactor;
+        matData.normalScale               = material.normalScale;
+        matData.occlusionStrength         = material.occlusionStrength;
+        matData.alphaCutoff               = material.alphaCutoff;
+        matData.baseColorTexIndex         = material.textures[0];
+        matData.normalTexIndex            = material.textures[1];
+        matData.metallicRoughnessTexIndex = material.textures[2];
+        matData.occlusionTexIndex         = material.textures[3];
+        matData.emissiveTexIndex          = material.textures[4];
+        matData.doubleSided               = material.doubleSided != 0;
+        matData.name                      = getString(material.name);
+        matData.alphaMode                 = getString(material.alphaMode);
+    }
+    const eastl::vector<uint32_t> materialIds = createMaterials(materials, textures, renderer, filePath, defaultTexture);
+
+    // Entities in one batch, then plain-data components inserted per type
+    eastl::vector<entt::entity> nodeEntities(header.nodeCount, entt::null);
+    eastl::vector<entt::entity> entities;
+    for (const SnapshotNode& node : nodeTable) {
+        if (node.flags & NODE_HAS_ENTITY) {
+            entities.push_back(entt::null);
+        }
+    }
+    world.create(entities.begin(), entities.end());
+
+    eastl::vector<entt::entity>       transformEntities;
+    eastl::vector<TransformComponent> transforms;
+    eastl::vector<entt::entity>       lightEntities;
+    eastl::vector<LightComponent>     lights;
+    transformEntities.reserve(entities.size());
+    transforms.reserve(entities.size());
+    for (uint32_t i = 0, next = 0; i < header.nodeCount; ++i) {
+        const SnapshotNode& node = nodeTable[i];
+        if (!(node.flags & NODE_HAS_ENTITY)) {
+            continue;
+        }
+        nodeEntities[i] = entities[next++];
+
+        if (node.flags & NODE_HAS_TRANSFORM) {
+            TransformComponent& transform = transforms.push_back();
+            std::memcpy(&transform.local.position[0], node.position, sizeof(node.position));
+            transform.local.rotation = glm::quat(node.rotation[3], node.rotation[0], node.rotation[1], node.rotation[2]);
+            std::memcpy(&transform.local.scale[0], node.scale, sizeof(node.scale));
+            transformEntities.push_back(nodeEntities[i]);
+        }
+        if (node.light != NONE) {
+            lights.push_back(lightTable[node.light]);
+            lightEntities.push_back(nodeEntities[i]);
+        }
+    }
+    world.insert<TransformComponent>(transformEntities.begin(), transformEntities.end(), transforms.begin());
+    world.insert<LightComponent>(lightEntities.begin(), lightEntities.end(), lights.begin());
+
+    // Each node gets its own GPU mesh, as on import, sharing the CPU geometry
+    VulkanContext* context = renderer.getContext();
+    for (uint32_t i = 0; i < header.nodeCount; ++i) {
+        const SnapshotNode& node = nodeTable[i];
+        if (node.mesh != NONE) {
+            const MeshSource& source = meshSources[node.mesh];
+            if (!source.vertices.empty()) {
+                auto meshPtr = eastl::make_unique<Mesh>();
+                meshPtr->create(context, source.vertices, source.indices, source.subMeshes);
+                meshPtr->setGeometry(source.geometry);
+                world.emplace<MeshComponent>(nodeEntities[i], eastl::move(meshPtr));
+            }
+        }
+        if (node.materialRefCount > 0) {
+            MaterialComponent matComp;
+            for (uint32_t r = node.firstMaterialRef; r < node.firstMaterialRef + node.materialRefCount; ++r) {
+                const SnapshotMaterialRef& ref = materialRefTable[r];
+                matComp.materialIndexToId[ref.subMeshMaterialIndex] = ref.global ? ref.material : materialIds[ref.material];
+            }
+            world.emplace<MaterialComponent>(nodeEntities[i], eastl::move(matComp));
+        }
+    }
+
+    // Node tree, parents first
+    auto scene = eastl::make_unique<Scene>();
+    scene->nodes.reserve(header.nodeCount);
+    scene->nodeSlots.reserve(header.nodeCount);
+    eastl::vector<uint32_t> nodeIds(header.nodeCount);
+    for (uint32_t i = 0; i < header.nodeCount; ++i) {
+        const SnapshotNode& record = nodeTable[i];
+        Node node(getString(record.name));
+        node.parentId = record.parent != NONE ? nodeIds[record.parent] : 0;
+        node.entity   = nodeEntities[i];
+        nodeIds[i]   = scene->addNode(node);
+    }
+
+    renderer.markSceneLoaded();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    violet::Log::info("Scene", "Loaded snapshot of {} in {:.1f} ms: {} nodes, {} meshes, {} materials, {} textures",
+                      filePath.c_str(), std::chrono::duration<float, std::milli>(endTime - startTime).count(),
+                      header.nodeCount, header.meshCount, header.materialCount, header.textureCount);
+    return scene;
+}
+
+eastl::unique_ptr<Scene> Scene::loadCachedSnapshot(
+    const eastl::string& filePath,
+    ResourceManager& resourceMgr,
+    ForwardRenderer& renderer,
+    entt::registry& world,
+    Texture* defaultTexture
+) {
+    if (resourceMgr.getSceneCacheDirectory().empty()) {
+        return nullptr;
+    }
+    const uint64_t key = computeSnapshotKey(filePath);
+    if (key == 0) {
+        return nullptr;
+    }
+
+    MappedFile snapshotFile(getSnapshotPath(resourceMgr, filePath));
+    if (!snapshotFile.isValid()) {
+        return nullptr;
+    }
+    // An older version of the source: the import that follows replaces it
+    SnapshotHeader header;
+    if (snapshotFile.size() >= sizeof(header)) {
+        std::memcpy(&header, snapshotFile.data(), sizeof(header));
+        if (header.magic == SNAPSHOT_MAGIC && header.key != key) {
+            violet::Log::info("Scene", "Snapshot of {} is out of date", filePath.c_str());
+            return nullptr;
+        }
+    }
+    auto scene = loadSnapshot(snapshotFile.data(), snapshotFile.size(), key, filePath, resourceMgr, renderer, world,
+                              defaultTexture);
+    if (!scene) {
+        violet::Log::warn("Scene", "Ignoring invalid snapshot of {}", filePath.c_str());
+    }
+    return scene;
+}
+
+void Scene::saveCachedSnapshot(eastl::shared_ptr<const GLTFAsset> asset, const eastl::vector<uint32_t>& materialIds,
+                               const entt::registry& world, const eastl::string& filePath,
+                               ResourceManager& resourceMgr) const {
+    const eastl::string directory = resourceMgr.getSceneCacheDirectory();
+    const uint64_t key = directory.empty() ? 0 : computeSnapshotKey(filePath);
+    if (key == 0) {
+        return;
+    }
+
+    // Only the registry reads happen here; vertices, BVHs and pixels are copied on a worker
+    auto tables = eastl::make_shared<SnapshotTables>();
+    collectSnapshotTables(asset.get(), materialIds, world, *tables);
+
+    const eastl::string snapshotPath = getSnapshotPath(resourceMgr, filePath);
+    resourceMgr.submitAsyncTask(eastl::make_shared<AsyncLoadTask>(
+        [asset, tables, key, directory, snapshotPath, filePath]() {
+            eastl::vector<uint8_t> blob;
+            if (!writeAssetSnapshot(asset.get(), *tables, key, blob)) {
+                violet::Log::warn("Scene", "Not snapshotting {}: texture data does not match its dimensions",
+                                  filePath.c_str());
+                FileSystem::remove(snapshotPath);  // Whatever an earlier version of the file left
+                return;
+            }
+
+            if (!FileSystem::createDirectories(directory) ||
+                !FileSystem::writeBinary(snapshotPath, blob.data(), blob.size())) {
+                violet::Log::warn("Scene", "Failed to write scene snapshot {}", snapshotPath.c_str());
+                FileSystem::remove(snapshotPath);
+                return;
+            }
+            violet::Log::info("Scene", "Wrote scene snapshot {} ({:.1f} MB)", snapshotPath.c_str(),
+                              blob.size() / (1024.0 * 1024.0));
+        },
+        nullptr
+    ));
+}
+
+} // namespace violet
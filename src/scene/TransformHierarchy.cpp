@@ -0,0 +1,248 @@
+#include "TransformHierarchy.hpp"
+#include "core/ThreadPool.hpp"
+#include <EASTL/sort.h>
+#include <atomic>
+#include <cassert>
+
+namespace violet {
+
+namespace {
+
+// Granularity of the parallel passes; large enough to amortize task dispatch
+constexpr uint32_t MIN_CHUNK_SIZE = 1024;
+
+} // anonymous namespace
+
+void TransformHierarchy::clear() {
+    parents.clear();
+    firstChildren.clear();
+    childCounts.clear();
+    levels.clear();
+    levelOffsets.clear();
+    subtreeSizesValid = false;
+    localPositions.clear();
+    localRotations.clear();
+    localScales.clear();
+    worldMatrices.clear();
+    worldRotations.clear();
+    worldScales.clear();
+    dirty.clear();
+    updateStamps.clear();
+    dirtyNodes.clear();
+    updatedNodes.clear();
+}
+
+void TransformHierarchy::reserve(uint32_t count) {
+    parents.reserve(count);
+    firstChildren.reserve(count);
+    childCounts.reserve(count);
+    levels.reserve(count);
+    localPositions.reserve(count);
+    localRotations.reserve(count);
+    localScales.reserve(count);
+    worldMatrices.reserve(count);
+    worldRotations.reserve(count);
+    worldScales.reserve(count);
+    dirty.reserve(count);
+    updateStamps.reserve(count);
+    dirtyNodes.reserve(count);
+}
+
+uint32_t TransformHierarchy::add(uint32_t parent) {
+    const uint32_t index = size();
+    uint32_t level = 0;
+    if (parent < index) {
+        assert((childCounts[parent] == 0 || firstChildren[parent] + childCounts[parent] == index) &&
+               "Children must be added in a row");
+        if (childCounts[parent]++ == 0) {
+            firstChildren[parent] = index;
+        }
+        level = levels[parent] + 1;
+    } else {
+        parent = NO_PARENT;
+    }
+    assert((levels.empty() || level >= levels.back()) && "Nodes must be added breadth first");
+    if (level >= levelOffsets.size()) {
+        levelOffsets.push_back(index);
+    }
+    parents.push_back(parent);
+    firstChildren.push_back(0);
+    childCounts.push_back(0);
+    levels.push_back(level);
+    subtreeSizesValid = false;
+    localPositions.push_back(glm::vec3(0.0f));
+    localRotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    localScales.push_back(glm::vec3(1.0f));
+    worldMatrices.push_back(glm::mat4(1.0f));
+    worldRotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    worldScales.push_back(glm::vec3(1.0f));
+    dirty.push_back(1);  // New nodes always compute once
+    updateStamps.push_back(0);
+    dirtyNodes.push_back(index);
+    return index;
+}
+
+void TransformHierarchy::setLocal(uint32_t index, const glm::vec3& position, const glm::quat& rotation,
+                                  const glm::vec3& scale) {
+    localPositions[index] = position;
+    localRotations[index] = rotation;
+    localScales[index]    = scale;
+    if (!dirty[index]) {
+        dirty[index] = 1;
+        dirtyNodes.push_back(index);
+    }
+}
+
+void TransformHierarchy::update(ThreadPool* threadPool) {
+    updatedNodes.clear();
+    ++updateStamp;
+    if (dirtyNodes.empty()) {
+        return;
+    }
+
+    // Ancestors have lower indices, so in index order a dirty node below another dirty node is
+    // reached after its ancestor's subtree already rewrote it, and is skipped
+    eastl::sort(dirtyNodes.begin(), dirtyNodes.end());
+
+    bool leavesOnly = false;
+    if (threadPool && threadPool->getThreadCount() > 0 && estimateWork(leavesOnly) >= PARALLEL_UPDATE_THRESHOLD) {
+        if (leavesOnly) {
+            updateIndependent(threadPool);
+        } else {
+            updateLevels(threadPool);
+        }
+    } else {
+        for (uint32_t node : dirtyNodes) {
+            if (updateStamps[node] != updateStamp) {
+                updateSubtree(node);
+            }
+        }
+    }
+    dirtyNodes.clear();
+}
+
+uint64_t TransformHierarchy::estimateWork(bool& leavesOnly) {
+    leavesOnly = true;
+    for (uint32_t node : dirtyNodes) {
+        if (childCounts[node] != 0) {
+            leavesOnly = false;
+            break;
+        }
+    }
+    if (leavesOnly) {
+        return dirtyNodes.size();
+    }
+
+    // Children follow their parents, so one backwards pass sums every subtree
+    if (!subtreeSizesValid) {
+        subtreeSizes.assign(size(), 1u);
+        for (uint32_t i = size(); i-- > 0;) {
+            if (parents[i] != NO_PARENT) {
+                subtreeSizes[parents[i]] += subtreeSizes[i];
+            }
+        }
+        subtreeSizesValid = true;
+    }
+    // Nested dirty nodes count twice; an estimate is all this needs
+    uint64_t work = 0;
+    for (uint32_t node : dirtyNodes) {
+        work += subtreeSizes[node];
+    }
+    return work;
+}
+
+void TransformHierarchy::updateIndependent(ThreadPool* threadPool) {
+    // No dirty node is another's ancestor and no parent changes, so any order works
+    const uint32_t stamp = updateStamp;
+    threadPool->parallelFor(static_cast<uint32_t>(dirtyNodes.size()), MIN_CHUNK_SIZE, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            updateNode(dirtyNodes[i]);
+            updateStamps[dirtyNodes[i]] = stamp;
+        }
+    });
+    updatedNodes.assign(dirtyNodes.begin(), dirtyNodes.end());
+}
+
+void TransformHierarchy::updateLevels(ThreadPool* threadPool) {
+    // Level by level from the shallowest dirty node: a node updates when it is dirty or its
+    // parent, one level up and finished before this level started, was updated in this pass
+    const uint32_t stamp          = updateStamp;
+    const uint32_t firstLevel     = levels[dirtyNodes.front()];
+    const uint32_t lastDirtyLevel = levels[dirtyNodes.back()];
+
+    uint32_t level = firstLevel;
+    for (; level < getLevelCount(); ++level) {
+        const uint32_t begin = levelOffsets[level];
+        const uint32_t end   = getLevelEnd(level);
+
+        std::atomic<uint32_t> levelUpdates{0};
+        threadPool->parallelFor(end - begin, MIN_CHUNK_SIZE, [&](uint32_t chunkBegin, uint32_t chunkEnd) {
+            uint32_t count = 0;
+            for (uint32_t i = begin + chunkBegin; i < begin + chunkEnd; ++i) {
+                const uint32_t parent = parents[i];
+                if (dirty[i] || (parent != NO_PARENT && updateStamps[parent] == stamp)) {
+                    updateNode(i);
+                    updateStamps[i] = stamp;
+                    ++count;
+                }
+            }
+            levelUpdates.fetch_add(count, std::memory_order_relaxed);
+        });
+
+        // Below the deepest dirty node, a level without updates ends the propagation
+        if (level >= lastDirtyLevel && levelUpdates.load() == 0) {
+            break;
+        }
+    }
+
+    // In index order, so the list does not depend on how chunks were scheduled
+    const uint32_t scanEnd = level < getLevelCount() ? getLevelEnd(level) : size();
+    for (uint32_t i = levelOffsets[firstLevel]; i < scanEnd; ++i) {
+        if (updateStamps[i] == stamp) {
+            updatedNodes.push_back(i);
+        }
+    }
+}
+
+uint32_t TransformHierarchy::getLevelEnd(uint32_t level) const {
+    return level + 1 < getLevelCount() ? levelOffsets[level + 1] : size();
+}
+
+void TransformHierarchy::updateSubtree(uint32_t root) {
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+
+        updateNode(index);
+        updateStamps[index] = updateStamp;
+        updatedNodes.push_back(index);
+
+        const uint32_t first = firstChildren[index];
+        for (uint32_t child = first; child < first + childCounts[index]; ++child) {
+            stack.push_back(child);
+        }
+    }
+}
+
+void TransformHierarchy::updateNode(uint32_t index) {
+    // T * R * S, written out
+    const glm::mat3 rotation = glm::mat3_cast(localRotations[index]);
+    const glm::vec3& scale   = localScales[index];
+    const glm::mat4 local(glm::vec4(rotation[0] * scale.x, 0.0f), glm::vec4(rotation[1] * scale.y, 0.0f),
+                          glm::vec4(rotation[2] * scale.z, 0.0f), glm::vec4(localPositions[index], 1.0f));
+
+    const uint32_t parent = parents[index];
+    if (parent == NO_PARENT) {
+        worldMatrices[index]  = local;
+        worldRotations[index] = localRotations[index];
+        worldScales[index]    = localScales[index];
+    } else {
+        worldMatrices[index]  = worldMatrices[parent] * local;
+        worldRotations[index] = worldRotations[parent] * localRotations[index];
+        worldScales[index]    = worldScales[parent] * localScales[index];
+    }
+    dirty[index] = 0;
+}
+
+} // namespace violet
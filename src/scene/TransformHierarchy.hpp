@@ -0,0 +1,86 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <EASTL/vector.h>
+#include <cstdint>
+
+namespace violet {
+
+class ThreadPool;
+
+// Flat, depth-ordered transform hierarchy. Nodes are stored breadth first, so every parent comes
+// before its children and each node's children are contiguous. Local TRS and world matrices live
+// in parallel arrays; world rotation and scale are composed alongside (exact without non-uniform
+// scale under rotation, the matrix is always exact). No recursion, lookups or decomposition.
+//
+// Updates are incremental: setLocal() marks a node dirty, and update() recomputes only the
+// subtrees below dirty nodes, listing every node it rewrote. A static hierarchy costs nothing.
+// Large updates run on a thread pool one depth level at a time, each level split into chunks
+// with the level before it finished; when every dirty node is a leaf (rigid props, foliage
+// instances under one root) the dirty nodes are independent and update in one parallel pass.
+// Each node is computed by the same arithmetic either way, so results match the serial path bit
+// for bit.
+class TransformHierarchy {
+public:
+    static constexpr uint32_t NO_PARENT = ~0u;
+    static constexpr uint32_t PARALLEL_UPDATE_THRESHOLD = 16384;  // Nodes to update before going parallel
+
+    void clear();
+    void reserve(uint32_t count);
+
+    // Appends a node below parent (NO_PARENT for a root). Nodes are added breadth first: the
+    // parent already added and all children of a parent in a row. New nodes start dirty.
+    uint32_t add(uint32_t parent);
+
+    // Marks the node dirty; its world transform and those below it update on the next update()
+    void setLocal(uint32_t index, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+    // Recomputes the world transforms of the dirty subtrees, on the pool when there is enough work
+    void update(ThreadPool* threadPool = nullptr);
+    // Nodes the last update() rewrote, each once
+    const eastl::vector<uint32_t>& getUpdatedNodes() const { return updatedNodes; }
+
+    uint32_t size() const { return static_cast<uint32_t>(parents.size()); }
+    uint32_t getParent(uint32_t index) const { return parents[index]; }
+    uint32_t getFirstChild(uint32_t index) const { return firstChildren[index]; }
+    uint32_t getChildCount(uint32_t index) const { return childCounts[index]; }
+    uint32_t getLevel(uint32_t index) const { return levels[index]; }
+    uint32_t getLevelCount() const { return static_cast<uint32_t>(levelOffsets.size()); }
+
+    const glm::mat4& getWorldMatrix(uint32_t index) const { return worldMatrices[index]; }
+    const glm::quat& getWorldRotation(uint32_t index) const { return worldRotations[index]; }
+    const glm::vec3& getWorldScale(uint32_t index) const { return worldScales[index]; }
+    glm::vec3        getWorldPosition(uint32_t index) const { return glm::vec3(worldMatrices[index][3]); }
+
+private:
+    void     updateNode(uint32_t index);
+    void     updateSubtree(uint32_t root);
+    void     updateIndependent(ThreadPool* threadPool);
+    void     updateLevels(ThreadPool* threadPool);
+    uint64_t estimateWork(bool& leavesOnly);
+    uint32_t getLevelEnd(uint32_t level) const;
+
+    eastl::vector<uint32_t>  parents;
+    eastl::vector<uint32_t>  firstChildren;
+    eastl::vector<uint32_t>  childCounts;
+    eastl::vector<uint32_t>  levels;         // Depth, non-decreasing with the index
+    eastl::vector<uint32_t>  subtreeSizes;   // Computed when needed, for the work estimate
+    eastl::vector<glm::vec3> localPositions;
+    eastl::vector<glm::quat> localRotations;
+    eastl::vector<glm::vec3> localScales;
+    eastl::vector<glm::mat4> worldMatrices;
+    eastl::vector<glm::quat> worldRotations;
+    eastl::vector<glm::vec3> worldScales;
+    eastl::vector<uint8_t>   dirty;
+    eastl::vector<uint32_t>  updateStamps;  // Pass that last rewrote the node
+
+    eastl::vector<uint32_t> dirtyNodes;
+    eastl::vector<uint32_t> updatedNodes;
+    eastl::vector<uint32_t> stack;
+    eastl::vector<uint32_t> levelOffsets;    // First index of each depth level
+    uint32_t updateStamp = 0;
+    bool     subtreeSizesValid = false;
+};
+
+} // namespace violet
@@ -224,6 +224,79 @@ void SceneDebugLayer::onImGuiRender() {
                 float cullingRate = (1.0f - (float)stats.visibleRenderables / (float)stats.totalRenderables) * 100.0f;
                 ImGui::Text("Culling Rate: %.1f%%", cullingRate);
             }
+            int cullingMode = static_cast<int>(renderer->getCullingMode());
+            if (ImGui::Combo("Culling", &cullingMode, "Auto\0BVH\0Brute Force\0")) {
+                renderer->setCullingMode(static_cast<CullingMode>(cullingMode));
+            }
+            float minScreenSize = renderer->getMinScreenSize();
+            if (ImGui::SliderFloat("Min Screen Size (px)", &minScreenSize, 0.0f, 16.0f, "%.1f")) {
+                renderer->setMinScreenSize(minScreenSize);
+            }
+            float minShadowSize = renderer->getMinShadowSize();
+            if (ImGui::SliderFloat("Min Shadow Size (texels)", &minShadowSize, 0.0f, 16.0f, "%.1f")) {
+                renderer->setMinShadowSize(minShadowSize);
+            }
+            if (minScreenSize > 0.0f || minShadowSize > 0.0f) {
+                ImGui::Text("Too Small: %u, Shadow: %u", stats.screenSizeCulled, stats.shadowSizeCulled);
+            }
+            if (stats.shadowViews > 0) {
+                ImGui::Text("Shadow Views: %u, Casters: %u", stats.shadowViews, stats.shadowCasters);
+                ImGui::Text("Shadow Draws: %u, Mesh Binds: %u", stats.shadowDrawCalls, stats.shadowMeshBinds);
+                ImGui::Text("Shadow Atlas: %u, Used: %.0f%%, Fragmentation: %.2f, Downgraded: %u",
+                            stats.shadowAtlasSize, stats.shadowAtlasUsage * 100.0f, stats.shadowAtlasFragmentation,
+                            stats.shadowAtlasDowngraded);
+            }
+            float shadowBudget = renderer->getShadowTexelBudget();
+            if (ImGui::SliderFloat("Shadow Budget (Mtexels)", &shadowBudget, 1.0f, 256.0f, "%.0f")) {
+                renderer->setShadowTexelBudget(shadowBudget);
+            }
+            if (stats.shadowViews > 0) {
+                ImGui::Text("Shadow Texels: %.1fM / %.0fM, Budget Cuts: %u", stats.shadowRequestedTexelsM,
+                            shadowBudget, stats.shadowBudgetCut);
+            }
+            bool staticShadowCache = renderer->getStaticShadowCache();
+            if (ImGui::Checkbox("Static Shadow Cache", &staticShadowCache)) {
+                renderer->setStaticShadowCache(staticShadowCache);
+            }
+            if (staticShadowCache && stats.shadowViews > 0) {
+                ImGui::Text("Cache Reused: %u, Scrolled: %u, Rebaked: %u (%u draws)", stats.shadowCacheReused,
+                            stats.shadowCacheScrolled, stats.shadowCacheRebaked, stats.shadowCacheDraws);
+            }
+            bool temporalCulling = renderer->getTemporalCulling();
+            if (ImGui::Checkbox("Temporal Culling", &temporalCulling)) {
+                renderer->setTemporalCulling(temporalCulling);
+            }
+            if (temporalCulling) {
+                const auto& coherence = renderer->getCoherenceStats();
+                ImGui::Text("Plane Tests: %u (saved %u)%s", coherence.planeTests, coherence.planeTestsSaved,
+                            coherence.reused ? ", reused" : (coherence.fullTraversal ? ", full" : ""));
+                ImGui::Text("Cut Nodes: %u, Newly Visible: %u", coherence.cutNodes, coherence.newlyVisible);
+            }
+            bool occlusionCulling = renderer->getOcclusionCulling();
+            if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling)) {
+                renderer->setOcclusionCulling(occlusionCulling);
+            }
+            if (occlusionCulling) {
+                const auto& occlusion = renderer->getOcclusionCuller().getStats();
+                ImGui::Text("Occluded: %u", stats.occlusionCulled);
+                ImGui::Text("Occluder Triangles: %u (%u rejected)", occlusion.occluderTriangles,
+                            occlusion.rejectedTriangles);
+                ImGui::Text("Raster Time: %.3f ms", occlusion.rasterTimeMs);
+            }
+
+            ImGui::Separator();
+            ImGui::Text("Scene BVH:");
+            int buildMethod = renderer->getBVHBuildMethod() == BVHBuildMethod::SAH ? 1 : 0;
+            if (ImGui::Combo("Builder", &buildMethod, "LBVH\0SAH\0")) {
+                renderer->setBVHBuildMethod(buildMethod == 1 ? BVHBuildMethod::SAH : BVHBuildMethod::LBVH);
+            }
+            const auto& bvhBuild   = renderer->getSceneBVH().getBuildStats();
+            const auto& bvhQuality = renderer->getSceneBVH().getQualityStats();
+            ImGui::Text("Build Time: %.2f ms", bvhBuild.buildTimeMs);
+            ImGui::Text("Nodes: %u", bvhBuild.nodeCount);
+            ImGui::Text("SAH Cost: %.2f", bvhQuality.sahCost);
+            ImGui::Text("Avg Leaf Size: %.2f", bvhQuality.avgLeafSize);
+            ImGui::Text("Max Depth: %u", bvhQuality.maxDepth);
         }
     }
 
@@ -247,20 +320,25 @@ void SceneDebugLayer::onImGuiRender() {
 
                     // Update hierarchy
                     if (scene) {
+                        scene->markTransformDirty(world->getRegistry(), selectedEntity);
                         scene->updateWorldTransforms(world->getRegistry());
                         // Update world bounds
                         auto meshView = world->view<TransformComponent, MeshComponent>();
                         for (auto&& [entity, transformComp, meshComp] : meshView.each()) {
                             if (transformComp.dirty) {
-                                meshComp.updateWorldBounds(transformComp.world.getMatrix());
+                                meshComp.updateWorldBounds(transformComp.worldMatrix);
                                 transformComp.dirty = false;
                             }
                         }
                     } else {
-                        transform->world = transform->local;
+                        transform->setWorld(transform->local);
                         transform->dirty = false;
                         if (auto* meshComp = registry.try_get<MeshComponent>(selectedEntity)) {
-                            meshComp->updateWorldBounds(transform->world.getMatrix());
+                            meshComp->updateWorldBounds(transform->worldMatrix);
+                            meshComp->dirty = true;
+                        }
+                        if (renderer) {
+                            renderer->markTransformChanged(selectedEntity);
                         }
                     }
                 }
@@ -273,19 +351,24 @@ void SceneDebugLayer::onImGuiRender() {
 
                     // Update hierarchy
                     if (scene) {
+                        scene->markTransformDirty(world->getRegistry(), selectedEntity);
                         scene->updateWorldTransforms(world->getRegistry());
                         auto meshView = world->view<TransformComponent, MeshComponent>();
                         for (auto&& [entity, transformComp, meshComp] : meshView.each()) {
                             if (transformComp.dirty) {
-                                meshComp.updateWorldBounds(transformComp.world.getMatrix());
+                                meshComp.updateWorldBounds(transformComp.worldMatrix);
                                 transformComp.dirty = false;
                             }
                         }
                     } else {
-                        transform->world = transform->local;
+                        transform->setWorld(transform->local);
                         transform->dirty = false;
                         if (auto* meshComp = registry.try_get<MeshComponent>(selectedEntity)) {
-                            meshComp->updateWorldBounds(transform->world.getMatrix());
+                            meshComp->updateWorldBounds(transform->worldMatrix);
+                            meshComp->dirty = true;
+                        }
+                        if (renderer) {
+                            renderer->markTransformChanged(selectedEntity);
                         }
                     }
                 }
@@ -298,19 +381,24 @@ void SceneDebugLayer::onImGuiRender() {
 
                     // Update hierarchy
                     if (scene) {
+                        scene->markTransformDirty(world->getRegistry(), selectedEntity);
                         scene->updateWorldTransforms(world->getRegistry());
                         auto meshView = world->view<TransformComponent, MeshComponent>();
                         for (auto&& [entity, transformComp, meshComp] : meshView.each()) {
                             if (transformComp.dirty) {
-                                meshComp.updateWorldBounds(transformComp.world.getMatrix());
+                                meshComp.updateWorldBounds(transformComp.worldMatrix);
                                 transformComp.dirty = false;
                             }
                         }
                     } else {
-                        transform->world = transform->local;
+                        transform->setWorld(transform->local);
                         transform->dirty = false;
                         if (auto* meshComp = registry.try_get<MeshComponent>(selectedEntity)) {
-                            meshComp->updateWorldBounds(transform->world.getMatrix());
+                            meshComp->updateWorldBounds(transform->worldMatrix);
+                            meshComp->dirty = true;
+                        }
+                        if (renderer) {
+                            renderer->markTransformChanged(selectedEntity);
                         }
                     }
                 }
@@ -517,43 +605,13 @@ entt::entity SceneDebugLayer::pickObject(float mouseX, float mouseY) {
 
     Ray ray(rayOrigin, rayDirection);
 
-    // Find closest intersected entity
-    float closestDistance = FLT_MAX;
-    entt::entity closestEntity = entt::null;
-    int entitiesChecked = 0;
-    int intersectionsFound = 0;
-
-    auto& registry = world->getRegistry();
-    auto entityView = registry.view<TransformComponent, MeshComponent>();
-    for (auto entity : entityView) {
-        auto& meshComp = entityView.get<MeshComponent>(entity);
-        entitiesChecked++;
-
-        if (meshComp.mesh) {
-            // Test intersection with each submesh AABB
-            size_t subMeshCount = meshComp.getSubMeshCount();
-
-            for (size_t i = 0; i < subMeshCount; ++i) {
-                const AABB& bounds = meshComp.getSubMeshWorldBounds(i);
-
-                if (ray.intersectAABB(bounds)) {
-                    intersectionsFound++;
-                    // Calculate distance to AABB center
-                    glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
-                    float distance = glm::length(rayOrigin - center);
-
-
-                    if (distance < closestDistance) {
-                        closestDistance = distance;
-                        closestEntity = entity;
-                    }
-                }
-            }
-        }
+    // Closest triangle hit through the scene BVH
+    RayHit hit;
+    if (!renderer->raycast(ray, hit)) {
+        return entt::null;
     }
 
-
-    return closestEntity;
+    return hit.entity;
 }
 
 void SceneDebugLayer::renderGizmo() {
@@ -629,7 +687,7 @@ void SceneDebugLayer::renderGizmo() {
     glm::mat4 gizmoProj = proj;
     gizmoProj[1][1] *= -1.0f;  // Undo the Vulkan Y-axis flip
 
-    glm::mat4 matrix = transform->world.getMatrix();
+    glm::mat4 matrix = transform->worldMatrix;
 
     // Prepare snap values if snapping is enabled
     float* snap = nullptr;
@@ -717,32 +775,33 @@ void SceneDebugLayer::renderGizmo() {
 
         // Update world transforms through hierarchy if scene is available
         if (scene) {
+            scene->markTransformDirty(world->getRegistry(), selectedEntity);
             scene->updateWorldTransforms(world->getRegistry());
 
             // Update world bounds for all affected entities
             auto meshView = world->view<TransformComponent, MeshComponent>();
             for (auto&& [entity, transformComp, meshComp] : meshView.each()) {
                 if (transformComp.dirty) {
-                    meshComp.updateWorldBounds(transformComp.world.getMatrix());
+                    meshComp.updateWorldBounds(transformComp.worldMatrix);
                     transformComp.dirty = false;
                 }
             }
         } else {
             // Fallback to simple local == world if no scene hierarchy
-            transform->world = transform->local;
+            transform->setWorld(transform->local);
             transform->dirty = false;
 
             // Update bounds for this entity only
             if (auto* meshComp = world->getRegistry().try_get<MeshComponent>(selectedEntity)) {
-                meshComp->updateWorldBounds(transform->world.getMatrix());
+                meshComp->updateWorldBounds(transform->worldMatrix);
+                meshComp->dirty = true;
+            }
+            if (renderer) {
+                renderer->markTransformChanged(selectedEntity);
             }
         }
 
-        // Trigger BVH rebuild for spatial acceleration structures
-        // Mark the scene as dirty so the renderer rebuilds the BVH
-        if (renderer) {
-            renderer->markSceneDirty();
-        }
+        // No rebuild needed: the dirty MeshComponent makes the renderer refit the BVH
     }
 
     // Close the transparent overlay window
@@ -837,42 +896,13 @@ void SceneDebugLayer::addRayFromMouseClick(float mouseX, float mouseY) {
     // Ray direction is from near to far plane (through the mouse click point)
     glm::vec3 rayDirection = glm::normalize(farPoint - nearPoint);
 
-    // Calculate ray length based on scene intersections
-    Ray ray(rayOrigin, rayDirection);
+    // Calculate ray length from the closest scene surface
+    Ray ray(rayOrigin, rayDirection, 0.001f);
     float calculatedRayLength = 1000.0f;  // Default long distance
 
-    // Find closest intersection with scene geometry
-    float closestDistance = FLT_MAX;
-    int intersectionCount = 0;
-    auto& registry = world->getRegistry();
-    auto entityView = registry.view<TransformComponent, MeshComponent>();
-
-    for (auto entity : entityView) {
-        auto& meshComp = entityView.get<MeshComponent>(entity);
-        if (meshComp.mesh) {
-            size_t subMeshCount = meshComp.getSubMeshCount();
-            for (size_t i = 0; i < subMeshCount; ++i) {
-                const AABB& bounds = meshComp.getSubMeshWorldBounds(i);
-
-                float tNear, tFar;
-                if (ray.intersectAABB(bounds, tNear, tFar)) {
-                    // Use the entry point (tNear) if it's in front of the camera
-                    // Otherwise use the exit point (tFar) if the ray starts inside
-                    float hitDistance = (tNear > 0.001f) ? tNear : tFar;
-
-                    if (hitDistance > 0.001f && hitDistance < closestDistance) {
-                        closestDistance = hitDistance;
-                        intersectionCount++;
-                    }
-                }
-            }
-        }
-    }
-
-
-    // Use intersection distance if found, otherwise use default
-    if (closestDistance < FLT_MAX) {
-        calculatedRayLength = closestDistance;
+    RayHit hit;
+    if (renderer->raycast(ray, hit)) {
+        calculatedRayLength = hit.t;
     }
 
     // Validate ray data before storing
@@ -945,40 +975,15 @@ glm::vec3 SceneDebugLayer::calculatePlacementPosition(float mouseX, float mouseY
     glm::vec3 targetPoint(rayNear_world);  // Use near plane point as target
     glm::vec3 rayDirection = glm::normalize(targetPoint - rayOrigin);
 
-    Ray ray(rayOrigin, rayDirection);
-    float closestDistance = FLT_MAX;
-    bool foundIntersection = false;
-
-    auto& registry = world->getRegistry();
-    auto entityView = registry.view<TransformComponent, MeshComponent>();
-
-    for (auto entity : entityView) {
-        auto& meshComp = entityView.get<MeshComponent>(entity);
-        if (!meshComp.mesh) continue;
-
-        // Test intersection with each submesh AABB like pickObject
-        size_t subMeshCount = meshComp.getSubMeshCount();
-        for (size_t i = 0; i < subMeshCount; ++i) {
-            const AABB& bounds = meshComp.getSubMeshWorldBounds(i);
-
-            float tNear, tFar;
-            if (ray.intersectAABB(bounds, tNear, tFar)) {
-                float hitDistance = (tNear > 0.001f) ? tNear : tFar;
-                if (hitDistance > 0.001f && hitDistance < closestDistance) {
-                    closestDistance = hitDistance;
-                    foundIntersection = true;
-                }
-            }
-        }
+    Ray ray(rayOrigin, rayDirection, 0.001f);
+    RayHit hit;
+    if (renderer->raycast(ray, hit)) {
+        // Place on the surface under the cursor
+        return hit.position;
     }
 
-    if (foundIntersection) {
-        // Place at intersection point
-        return rayOrigin + rayDirection * closestDistance;
-    } else {
-        // No intersection found, place at origin
-        return glm::vec3(0.0f, 0.0f, 0.0f);
-    }
+    // No intersection found, place at origin
+    return glm::vec3(0.0f, 0.0f, 0.0f);
 }
 
 void SceneDebugLayer::handleAssetDragDrop() {
@@ -1141,7 +1146,7 @@ Camera* SceneDebugLayer::findActiveCamera() {
 TransformComponent SceneDebugLayer::createInitializedTransform(const glm::vec3& position) {
     TransformComponent transform;
     transform.local.position = position;
-    transform.world = transform.local;
+    transform.setWorld(transform.local);
     transform.dirty = false;
     return transform;
 }
@@ -1436,8 +1441,10 @@ void SceneDebugLayer::renderSceneHierarchy() {
     ImGui::Separator();
 
     // Render root nodes
-    for (uint32_t rootId : scene->getRootNodes()) {
+    for (uint32_t rootId = scene->getFirstRootNode(); rootId != 0;) {
+        const uint32_t nextId = scene->getNode(rootId)->nextSiblingId;  // Before a drop can move it
         renderSceneNode(rootId);
+        rootId = nextId;
     }
 }
 
@@ -1481,8 +1488,10 @@ void SceneDebugLayer::renderSceneNode(uint32_t nodeId) {
     }
 
     if (nodeOpen) {
-        for (uint32_t childId : node->childrenIds) {
+        for (uint32_t childId = node->firstChildId; childId != 0;) {
+            const uint32_t nextId = scene->getNode(childId)->nextSiblingId;
             renderSceneNode(childId);
+            childId = nextId;
         }
         ImGui::TreePop();
     }
@@ -1601,7 +1610,7 @@ void SceneDebugLayer::preserveWorldPosition(uint32_t nodeId, uint32_t newParentI
     glm::mat4 invParentMatrix = glm::inverse(newParentWorldMatrix);
 
     // Calculate new local transform that will preserve world position
-    glm::mat4 currentWorldMatrix = transformComp->world.getMatrix();
+    glm::mat4 currentWorldMatrix = transformComp->worldMatrix;
     glm::mat4 newLocalMatrix = invParentMatrix * currentWorldMatrix;
 
     // Decompose the new local matrix back to transform components
@@ -1614,7 +1623,7 @@ void SceneDebugLayer::preserveWorldPosition(uint32_t nodeId, uint32_t newParentI
     transformComp->local.position = translation;
     transformComp->local.rotation = orientation;
     transformComp->local.scale = scale;
-    transformComp->dirty = true;
+    scene->markTransformDirty(world->getRegistry(), node->entity);
 }
 
 void SceneDebugLayer::renderEnvironmentPanel() {
@@ -0,0 +1,1446 @@
+// BVH Test
+// Validates the LBVH and SAH builders, refitting and ray queries against each other, the serial path and a brute-force reference
+
+#include "acceleration/BVH.hpp"
+#include "acceleration/FrustumCuller.hpp"
+#include "acceleration/OcclusionCuller.hpp"
+#include "core/FileSystem.hpp"
+#include "core/ThreadPool.hpp"
+#include "math/Frustum.hpp"
+#include "math/ScreenSize.hpp"
+#include "resource/MeshGeometry.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <fmt/core.h>
+#include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+using namespace violet;
+
+// EASTL allocators
+void* operator new[](size_t size, const char*, int, unsigned, const char*, int) {
+    return malloc(size);
+}
+
+void* operator new[](size_t size, size_t alignment, size_t, const char*, int, unsigned, const char*, int) {
+    return aligned_alloc(alignment, size);
+}
+
+static int failures = 0;
+
+#define CHECK(cond, msg)                                   \
+    do {                                                   \
+        if (!(cond)) {                                     \
+            fmt::print("  FAILED: {}\n", msg);             \
+            ++failures;                                    \
+        }                                                  \
+    } while (0)
+
+static bool overlaps(const AABB& a, const AABB& b) {
+    return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+           a.min.y <= b.max.y && a.max.y >= b.min.y &&
+           a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+static eastl::vector<AABB> makeBoxes(uint32_t count, uint32_t seed, bool clustered) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> ext(0.1f, 5.0f);
+
+    eastl::vector<AABB> boxes;
+    boxes.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        glm::vec3 c(pos(rng), pos(rng), pos(rng));
+        if (clustered) {
+            // Many primitives sharing a Morton cell exercise the duplicate-key path
+            c = glm::vec3(static_cast<float>(i % 7), 0.0f, static_cast<float>(i % 3));
+        }
+        glm::vec3 e(ext(rng), ext(rng), ext(rng));
+        boxes.push_back(AABB(c - e, c + e));
+    }
+    return boxes;
+}
+
+static eastl::vector<uint32_t> collectAll(const BVH& bvh) {
+    eastl::vector<uint32_t> result;
+    bvh.traverse([](const AABB&) { return true; }, [&](uint32_t index) { result.push_back(index); });
+    return result;
+}
+
+// Every primitive must be reachable exactly once
+void testCompleteness(ThreadPool& pool, uint32_t count, bool clustered) {
+    fmt::print("\n=== Completeness: {} primitives{} ===\n", count, clustered ? " (clustered)" : "");
+
+    auto boxes = makeBoxes(count, 1234u + count, clustered);
+    BVH  bvh;
+    bvh.build(boxes, &pool);
+
+    auto visited = collectAll(bvh);
+    CHECK(visited.size() == count, "visited count mismatch");
+
+    eastl::vector<uint32_t> hits(count, 0);
+    for (uint32_t index : visited) {
+        if (index < count) {
+            ++hits[index];
+        }
+    }
+    bool allOnce = true;
+    for (uint32_t h : hits) {
+        allOnce &= h == 1;
+    }
+    CHECK(allOnce, "primitive visited zero or multiple times");
+
+    const auto& stats = bvh.getBuildStats();
+    CHECK(stats.nodeCount == 2 * count - 1, "unexpected node count");
+    fmt::print("  nodes={} parallel={} time={:.3f}ms\n", stats.nodeCount, stats.parallel, stats.buildTimeMs);
+}
+
+// Serial and parallel builds must produce identical hierarchies
+void testDeterminism(ThreadPool& pool) {
+    fmt::print("\n=== Determinism: serial vs parallel ===\n");
+
+    auto boxes = makeBoxes(50000, 42u, false);
+
+    BVH serial;
+    serial.build(boxes, nullptr);
+    BVH parallel;
+    parallel.build(boxes, &pool);
+
+    CHECK(!serial.getBuildStats().parallel, "serial build used the pool");
+    CHECK(parallel.getBuildStats().parallel, "parallel build did not use the pool");
+    CHECK(collectAll(serial) == collectAll(parallel), "traversal order differs");
+
+    fmt::print("  serial={:.3f}ms parallel={:.3f}ms\n", serial.getBuildStats().buildTimeMs,
+               parallel.getBuildStats().buildTimeMs);
+}
+
+// Region queries must match a brute-force overlap test
+void testQueries(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Queries vs brute force ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(20000, 7u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool, method);
+
+    CHECK(bvh.getSceneBounds().isValid(), "scene bounds invalid");
+
+    auto queries = makeBoxes(64, 99u, false);
+    for (auto& q : queries) {
+        q.min -= glm::vec3(40.0f);
+        q.max += glm::vec3(40.0f);
+
+        eastl::vector<uint32_t> expected(boxes.size(), 0);
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            expected[i] = overlaps(q, boxes[i]) ? 1 : 0;
+        }
+
+        eastl::vector<uint32_t> actual(boxes.size(), 0);
+        bvh.traverse([&](const AABB& b) { return overlaps(q, b); }, [&](uint32_t index) {
+            if (overlaps(q, boxes[index])) {
+                actual[index] = 1;
+            }
+        });
+
+        if (expected != actual) {
+            CHECK(false, "query result differs from brute force");
+            break;
+        }
+    }
+}
+
+// SAH trees hold every primitive once and should not be worse than LBVH by the SAH metric
+void testSAHQuality(ThreadPool& pool) {
+    fmt::print("\n=== SAH vs LBVH quality ===\n");
+
+    auto boxes = makeBoxes(20000, 2024u, false);
+    // Add a dense cluster, the case where Morton splits produce loose trees
+    auto cluster = makeBoxes(5000, 77u, true);
+    boxes.insert(boxes.end(), cluster.begin(), cluster.end());
+
+    BVH lbvh;
+    lbvh.build(boxes, &pool, BVHBuildMethod::LBVH);
+    BVH sah;
+    sah.build(boxes, &pool, BVHBuildMethod::SAH);
+
+    auto visited = collectAll(sah);
+    CHECK(visited.size() == boxes.size(), "SAH visited count mismatch");
+    eastl::vector<uint32_t> hits(boxes.size(), 0);
+    for (uint32_t index : visited) {
+        ++hits[index];
+    }
+    bool allOnce = true;
+    for (uint32_t h : hits) {
+        allOnce &= h == 1;
+    }
+    CHECK(allOnce, "SAH primitive visited zero or multiple times");
+
+    const auto& lq = lbvh.getQualityStats();
+    const auto& sq = sah.getQualityStats();
+    CHECK(sah.getBuildStats().method == BVHBuildMethod::SAH, "build method not recorded");
+    CHECK(sq.avgLeafSize >= 1.0f && sq.avgLeafSize <= static_cast<float>(BVH::SAH_MAX_LEAF_SIZE), "SAH leaf size out of range");
+    CHECK(sq.sahCost <= lq.sahCost, "SAH tree has a higher SAH cost than LBVH");
+
+    fmt::print("  LBVH: cost={:.2f} leaves={} avgLeaf={:.2f} depth={} time={:.3f}ms\n", lq.sahCost, lq.leafCount,
+               lq.avgLeafSize, lq.maxDepth, lbvh.getBuildStats().buildTimeMs);
+    fmt::print("  SAH:  cost={:.2f} leaves={} avgLeaf={:.2f} depth={} time={:.3f}ms\n", sq.sahCost, sq.leafCount,
+               sq.avgLeafSize, sq.maxDepth, sah.getBuildStats().buildTimeMs);
+}
+
+// Refitted trees must answer queries exactly like a fresh build and report degradation
+void testRefit(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Refit ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(10000, 314u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool, method);
+    CHECK(bvh.getRefitDegradation() == 1.0f, "fresh build should not be degraded");
+
+    // Unchanged bounds must not touch the tree
+    bvh.refit(5, boxes[5]);
+    CHECK(bvh.getRefitDegradation() == 1.0f, "no-op refit changed the tree");
+
+    // Move a handful of primitives far away
+    std::mt19937 rng(5u);
+    std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(boxes.size()) - 1);
+    for (int i = 0; i < 50; ++i) {
+        uint32_t index = pick(rng);
+        glm::vec3 offset(900.0f, -700.0f, 400.0f);
+        boxes[index] = AABB(boxes[index].min + offset, boxes[index].max + offset);
+        bvh.refit(index, boxes[index]);
+    }
+
+    CHECK(bvh.getRefitDegradation() > 1.0f, "moving primitives should degrade the tree");
+    CHECK(bvh.getSceneBounds().max.x >= 1000.0f, "scene bounds not refitted");
+
+    auto queries = makeBoxes(32, 11u, false);
+    queries.push_back(AABB(glm::vec3(1300.0f, -1300.0f, 800.0f), glm::vec3(1500.0f, -1100.0f, 1000.0f)));
+    for (auto& q : queries) {
+        q.min -= glm::vec3(60.0f);
+        q.max += glm::vec3(60.0f);
+
+        uint32_t expected = 0;
+        for (const auto& b : boxes) {
+            expected += overlaps(q, b) ? 1 : 0;
+        }
+        uint32_t actual = 0;
+        bvh.traverse([&](const AABB& b) { return overlaps(q, b); },
+                     [&](uint32_t index) { actual += overlaps(q, boxes[index]) ? 1 : 0; });
+        if (expected != actual) {
+            CHECK(false, "refitted query differs from brute force");
+            break;
+        }
+    }
+
+    fmt::print("  degradation after refit={:.3f} needsRebuild={}\n", bvh.getRefitDegradation(), bvh.needsRebuild());
+
+    bvh.build(boxes, &pool, method);
+    CHECK(bvh.getRefitDegradation() == 1.0f, "rebuild should reset degradation");
+}
+
+static Frustum makeFrustum(const glm::vec3& eye, const glm::vec3& target) {
+    Frustum frustum;
+    frustum.extract(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2000.0f) *
+                    glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)));
+    return frustum;
+}
+
+// SIMD lane tests must agree with the scalar box tests
+void testLaneKernels() {
+    fmt::print("\n=== AABB4 lane kernels ===\n");
+
+    auto boxes   = makeBoxes(4096, 555u, false);
+    auto frustum = makeFrustum(glm::vec3(0.0f, 50.0f, -600.0f), glm::vec3(0.0f));
+    Ray  ray(glm::vec3(-600.0f, 3.0f, 2.0f), glm::normalize(glm::vec3(1.0f, 0.002f, 0.001f)));
+
+    bool frustumMatch = true;
+    bool rayMatch     = true;
+    for (uint32_t i = 0; i + 4 <= boxes.size(); i += 4) {
+        AABB4 lanes;
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            lanes.setLane(lane, boxes[i + lane]);
+        }
+
+        uint32_t frustumMask = frustum.testAABB4(lanes);
+        float    tNear[4];
+        uint32_t rayMask = ray.intersectAABB4(lanes, tNear);
+
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            frustumMatch &= ((frustumMask >> lane) & 1u) == (frustum.testAABB(boxes[i + lane]) ? 1u : 0u);
+            rayMatch &= ((rayMask >> lane) & 1u) == (ray.intersectAABB(boxes[i + lane]) ? 1u : 0u);
+        }
+    }
+    CHECK(frustumMatch, "Frustum::testAABB4 differs from testAABB");
+    CHECK(rayMatch, "Ray::intersectAABB4 differs from intersectAABB");
+
+    AABB4 empty;
+    empty.clear();
+    CHECK(frustum.testAABB4(empty) == 0, "empty lanes must fail the frustum test");
+}
+
+// The collapsed 4-wide tree must report exactly the binary tree's primitives
+void testWideTraversal(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Wide traversal ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(30000, 808u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool, method);
+
+    auto compare = [&](const Frustum& frustum) {
+        eastl::vector<uint32_t> binary;
+        eastl::vector<uint32_t> wide;
+        uint32_t binaryVisits = 0;
+        uint32_t wideVisits   = 0;
+        bvh.traverse([&](const AABB& b) { ++binaryVisits; return frustum.testAABB(b); },
+                     [&](uint32_t index) { binary.push_back(index); });
+        bvh.traverseWide([&](const AABB4& b) { ++wideVisits; return frustum.testAABB4(b); },
+                         [&](uint32_t index) { wide.push_back(index); });
+        eastl::sort(binary.begin(), binary.end());
+        eastl::sort(wide.begin(), wide.end());
+        fmt::print("  visible={} binary node tests={} wide node tests={}\n", wide.size(), binaryVisits, wideVisits);
+        return binary == wide;
+    };
+
+    auto frustum = makeFrustum(glm::vec3(0.0f, 100.0f, -800.0f), glm::vec3(100.0f, 0.0f, 0.0f));
+    CHECK(compare(frustum), "wide traversal differs from binary traversal");
+    CHECK(bvh.getWideNodeCount() * 2 <= bvh.getBuildStats().nodeCount, "wide tree not collapsed");
+
+    // Lanes must follow refits
+    for (uint32_t i = 0; i < boxes.size(); i += 97) {
+        glm::vec3 offset(0.0f, 0.0f, -300.0f);
+        boxes[i] = AABB(boxes[i].min + offset, boxes[i].max + offset);
+        bvh.refit(i, boxes[i]);
+    }
+    CHECK(compare(frustum), "wide traversal differs after refit");
+}
+
+// Plane-masked culling must match plain wide culling while doing fewer plane tests
+void testCoherentCulling(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Coherent culling ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(50000, 909u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool, method);
+    eastl::vector<uint8_t> planeHints;
+
+    auto compare = [&](const Frustum& frustum, const char* label) {
+        eastl::vector<uint32_t> reference;
+        uint32_t referencePlaneTests = 0;
+        bvh.traverseWide(
+            [&](const AABB4& b) {
+                uint32_t lanes = 0;
+                for (uint32_t lane = 0; lane < 4; ++lane) {
+                    lanes += b.getLane(lane).isValid() ? 1 : 0;
+                }
+                referencePlaneTests += lanes * Frustum::CULL_PLANE_COUNT;
+                return frustum.testAABB4(b);
+            },
+            [&](uint32_t index) { reference.push_back(index); });
+
+        BVHCullStats firstStats;
+        BVHCullStats secondStats;
+        eastl::vector<uint32_t> culled;
+        bvh.cullFrustum(frustum, planeHints, [&](uint32_t index) { culled.push_back(index); }, &firstStats);
+        culled.clear();
+        bvh.cullFrustum(frustum, planeHints, [&](uint32_t index) { culled.push_back(index); }, &secondStats);
+
+        eastl::sort(reference.begin(), reference.end());
+        eastl::sort(culled.begin(), culled.end());
+        fmt::print("  {}: visible={} plane tests unmasked={} masked={} with hints={} subtrees accepted={}\n", label,
+                   culled.size(), referencePlaneTests, firstStats.planeTests, secondStats.planeTests,
+                   secondStats.subtreesAccepted);
+        CHECK(culled == reference, "masked culling differs from wide culling");
+        return eastl::make_pair(referencePlaneTests, secondStats.planeTests);
+    };
+
+    // Most of the scene in view: the masked path should skip the bulk of the plane tests
+    auto wide = compare(makeFrustum(glm::vec3(0.0f, 200.0f, -1500.0f), glm::vec3(0.0f)), "wide view");
+    CHECK(wide.second * 2 < wide.first, "plane masking saved less than half of the plane tests");
+
+    compare(makeFrustum(glm::vec3(0.0f, 100.0f, -800.0f), glm::vec3(100.0f, 0.0f, 0.0f)), "partial view");
+    compare(makeFrustum(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.3f)), "inside view");
+
+    // Masks and subtree ranges hold after refits
+    for (uint32_t i = 0; i < boxes.size(); i += 41) {
+        glm::vec3 offset(40.0f, -30.0f, 0.0f);
+        boxes[i] = AABB(boxes[i].min + offset, boxes[i].max + offset);
+        bvh.refit(i, boxes[i]);
+    }
+    compare(makeFrustum(glm::vec3(0.0f, 200.0f, -1500.0f), glm::vec3(0.0f)), "wide view after refit");
+}
+
+// Contribution culling: the size estimate, its SIMD lane form, and subtrees dropped by it
+// during BVH culling never hiding a primitive that passes on its own
+void testScreenSize(ThreadPool& pool) {
+    fmt::print("\n=== Screen size culling ===\n");
+
+    const glm::vec3 eye(0.0f, 20.0f, 300.0f);
+    const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+    const glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    ScreenSizeTest sizeTest = ScreenSizeTest::fromProjection(proj, eye, 1920.0f, 1080.0f, 12.0f);
+
+    // A unit-radius sphere 100 units away spans about 2 / 100 / tan(30deg) * 540 pixels
+    AABB unit(glm::vec3(-1.0f / std::sqrt(3.0f)), glm::vec3(1.0f / std::sqrt(3.0f)));
+    AABB far100(unit.min + eye - glm::vec3(0.0f, 0.0f, 101.0f), unit.max + eye - glm::vec3(0.0f, 0.0f, 101.0f));
+    float expected = 2.0f / 100.0f / std::tan(glm::radians(30.0f)) * 540.0f;
+    CHECK(std::abs(sizeTest.projectedSize(far100) - expected) < 1e-3f * expected, "projected size estimate is off");
+    CHECK(std::isinf(sizeTest.projectedSize(AABB(eye - 1.0f, eye + 1.0f))), "box around the eye has finite size");
+    CHECK(!ScreenSizeTest().isEnabled() && ScreenSizeTest().test(far100), "default size test culls");
+
+    ScreenSizeTest ortho = ScreenSizeTest::fromProjection(glm::ortho(-50.0f, 50.0f, -50.0f, 50.0f, 0.1f, 500.0f), eye,
+                                                          1024.0f, 1024.0f, 4.0f);
+    CHECK(ortho.orthographic && std::abs(ortho.projectedSize(far100) - 2.0f * 1024.0f / 100.0f) < 1e-3f,
+          "orthographic size estimate is off");
+
+    // Lane test against the scalar one, away from ties
+    auto boxes = makeBoxes(20000, 31337u, false);
+    uint32_t laneMismatches = 0;
+    for (uint32_t i = 0; i + 4 <= boxes.size(); i += 4) {
+        AABB4 lanes;
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            lanes.setLane(lane, boxes[i + lane]);
+        }
+        uint32_t mask = sizeTest.testAABB4(lanes, 0xF);
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            float size = sizeTest.projectedSize(boxes[i + lane]);
+            if (std::abs(size - sizeTest.minPixels) > 1e-3f * sizeTest.minPixels &&
+                ((mask >> lane) & 1u) != (sizeTest.test(boxes[i + lane]) ? 1u : 0u)) {
+                ++laneMismatches;
+            }
+        }
+    }
+    CHECK(laneMismatches == 0, "SIMD size test disagrees with the scalar test");
+
+    Frustum frustum;
+    frustum.extract(proj * view);
+    BVH bvh;
+    bvh.build(boxes, &pool, BVHBuildMethod::SAH);
+
+    eastl::vector<uint8_t> hints;
+    eastl::vector<uint8_t> plain(boxes.size(), 0), sized(boxes.size(), 0);
+    bvh.cullFrustum(frustum, hints, [&](uint32_t i) { plain[i] = 1; });
+    uint32_t subtreesDropped = 0;
+    bvh.cullFrustumFiltered(frustum, hints,
+        [&](const AABB4& lanes, uint32_t mask) {
+            uint32_t kept = sizeTest.testAABB4(lanes, mask);
+            subtreesDropped += std::popcount(mask & ~kept);
+            return kept;
+        },
+        [&](uint32_t i) { sized[i] = 1; });
+
+    uint32_t plainCount = 0, sizedCount = 0, missing = 0, extra = 0, bigEnough = 0;
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        plainCount += plain[i];
+        sizedCount += sized[i];
+        bool passes = plain[i] && sizeTest.projectedSize(boxes[i]) > sizeTest.minPixels * 1.001f;
+        bigEnough += passes ? 1 : 0;
+        missing += passes && !sized[i] ? 1 : 0;
+        extra += sized[i] && !plain[i] ? 1 : 0;
+    }
+    fmt::print("  {} in frustum, {} at least {}px ({} emitted, {} subtrees dropped)\n", plainCount, bigEnough,
+               sizeTest.minPixels, sizedCount, subtreesDropped);
+    CHECK(missing == 0, "size culling dropped a primitive that is large enough");
+    CHECK(extra == 0, "size culling emitted a primitive outside the frustum cull");
+    CHECK(sizedCount < plainCount, "size culling dropped nothing");
+}
+
+// Temporal coherence: the same set as cullFrustum along a camera path, no tests for a
+// static view, and the cached result invalidated by refits and rebuilds
+void testTemporalCulling(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Temporal culling ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(50000, 1337u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool, method);
+
+    BVHCullCoherence coherence;
+    coherence.revalidateInterval = 30;
+    eastl::vector<uint8_t> planeHints;
+
+    auto matches = [&](const Frustum& frustum, BVHCoherenceStats& stats) {
+        eastl::vector<uint32_t> reference;
+        BVHCullStats referenceStats;
+        bvh.cullFrustum(frustum, planeHints, [&](uint32_t index) { reference.push_back(index); }, &referenceStats);
+        eastl::vector<uint32_t> coherent = bvh.cullFrustumCoherent(frustum, coherence, &stats);
+        eastl::sort(reference.begin(), reference.end());
+        eastl::sort(coherent.begin(), coherent.end());
+        return eastl::make_pair(coherent == reference, referenceStats.planeTests);
+    };
+
+    // An editor-speed orbit, a cut, then a fast orbit
+    uint64_t fullTests[2] = {}, coherentTests[2] = {};
+    uint32_t revalidations = 0, newlyVisible = 0;
+    bool allMatch = true;
+    float angle = 0.0f;
+    for (uint32_t frame = 0; frame < 240; ++frame) {
+        uint32_t phase = frame < 120 ? 0 : 1;
+        angle += frame == 120 ? 2.0f : (phase == 0 ? 0.002f : 0.01f);
+        glm::vec3 eye(std::sin(angle) * 600.0f, 40.0f + frame * 0.1f, std::cos(angle) * 600.0f);
+        BVHCoherenceStats stats;
+        auto [match, referenceTests] = matches(makeFrustum(eye, glm::vec3(0.0f, 0.0f, 100.0f)), stats);
+        allMatch              = allMatch && match;
+        fullTests[phase]     += referenceTests;
+        coherentTests[phase] += stats.planeTests;
+        revalidations        += stats.fullTraversal ? 1 : 0;
+        newlyVisible         += stats.newlyVisible;
+    }
+    CHECK(allMatch, "coherent culling differs from cullFrustum along the path");
+    CHECK(revalidations >= 120 / coherence.revalidateInterval, "coherent culling never revalidated");
+    CHECK(newlyVisible > 0, "moving view found nothing newly visible");
+    CHECK(coherentTests[0] < fullTests[0], "coherent culling saved nothing on a slow view");
+    fmt::print("  plane tests full/coherent: slow {}/{} ({:.0f}%), fast {}/{} ({:.0f}%), {} full traversals\n",
+               fullTests[0], coherentTests[0], 100.0 * coherentTests[0] / fullTests[0], fullTests[1],
+               coherentTests[1], 100.0 * coherentTests[1] / fullTests[1], revalidations);
+
+    // Static view: the second call does no work at all
+    Frustum still = makeFrustum(glm::vec3(100.0f, 80.0f, -500.0f), glm::vec3(0.0f));
+    BVHCoherenceStats first, second;
+    bool stillMatch = matches(still, first).first;
+    stillMatch = stillMatch && matches(still, second).first;
+    CHECK(stillMatch, "coherent culling differs for a static view");
+    CHECK(second.reused && second.planeTests == 0 && second.nodesVisited == 0, "static view was culled again");
+    CHECK(second.planeTestsSaved > 0, "static view reports no savings");
+
+    // Moving a box into view must be noticed without a frustum change
+    BVHCoherenceStats afterRefit;
+    bvh.refit(0, AABB(glm::vec3(95.0f, 75.0f, -450.0f), glm::vec3(105.0f, 85.0f, -440.0f)));
+    bool refitMatch = matches(still, afterRefit).first;
+    CHECK(refitMatch && !afterRefit.reused, "refit did not invalidate the cached result");
+    const auto& visible = coherence.visible;
+    CHECK(eastl::find(visible.begin(), visible.end(), 0u) != visible.end(), "box moved into view not visible");
+
+    // A rebuilt tree starts over from the root
+    BVHCoherenceStats afterBuild;
+    bvh.build(makeBoxes(20000, 4242u, true), &pool, method);
+    planeHints.clear();
+    bool buildMatch = matches(still, afterBuild).first;
+    CHECK(buildMatch && afterBuild.fullTraversal, "rebuild did not restart coherent culling");
+}
+
+// One multi-view traversal must give every view what cullFrustum gives it alone
+void testMultiViewCulling(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Multi-view culling ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(50000, 777u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool, method);
+
+    // A camera, four cascades of a directional light and the six faces of a point light
+    eastl::vector<Frustum> frusta;
+    frusta.push_back(makeFrustum(glm::vec3(0.0f, 60.0f, -600.0f), glm::vec3(0.0f, 0.0f, 0.0f)));
+    glm::mat4 lightView = glm::lookAt(glm::vec3(-300.0f, 600.0f, -300.0f), glm::vec3(0.0f), glm::vec3(0, 1, 0));
+    for (float extent : {60.0f, 150.0f, 350.0f, 800.0f}) {
+        frusta.emplace_back();
+        frusta.back().extract(glm::ortho(-extent, extent, -extent, extent, 0.0f, 1500.0f) * lightView);
+    }
+    const glm::vec3 lightPos(120.0f, 20.0f, 80.0f);
+    const glm::vec3 directions[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    const glm::vec3 ups[6] = {{0, -1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}, {0, -1, 0}, {0, -1, 0}};
+    for (uint32_t face = 0; face < 6; ++face) {
+        frusta.emplace_back();
+        frusta.back().extract(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 200.0f) *
+                              glm::lookAt(lightPos, lightPos + directions[face], ups[face]));
+    }
+    const uint32_t viewCount = static_cast<uint32_t>(frusta.size());
+
+    eastl::vector<eastl::vector<uint32_t>> multi(viewCount);
+    BVHCullStats multiStats;
+    uint32_t emitted = 0;
+    bvh.cullFrusta(frusta.data(), viewCount, [&](uint32_t index, uint32_t viewMask) {
+        ++emitted;
+        for (uint32_t view = 0; view < viewCount; ++view) {
+            if (viewMask & (1u << view)) {
+                multi[view].push_back(index);
+            }
+        }
+    }, &multiStats);
+
+    bool allMatch = true, emptyMask = false;
+    BVHCullStats singleStats;
+    uint32_t listed = 0;
+    for (uint32_t view = 0; view < viewCount; ++view) {
+        eastl::vector<uint8_t> planeHints;
+        eastl::vector<uint32_t> reference;
+        bvh.cullFrustum(frusta[view], planeHints, [&](uint32_t index) { reference.push_back(index); }, &singleStats);
+        eastl::sort(reference.begin(), reference.end());
+        eastl::sort(multi[view].begin(), multi[view].end());
+        allMatch = allMatch && multi[view] == reference;
+        listed  += static_cast<uint32_t>(reference.size());
+    }
+    bvh.cullFrusta(frusta.data(), viewCount, [&](uint32_t, uint32_t viewMask) { emptyMask |= viewMask == 0; });
+    CHECK(allMatch, "multi-view culling differs from per-view cullFrustum");
+    CHECK(!emptyMask, "multi-view culling emitted a primitive no view sees");
+    CHECK(emitted <= listed, "multi-view culling emitted a primitive twice");
+    CHECK(multiStats.nodesVisited < singleStats.nodesVisited, "multi-view culling visited as many nodes as separate passes");
+    fmt::print("  {} views: nodes visited {} vs {} separately, {} primitives emitted for {} view entries\n", viewCount,
+               multiStats.nodesVisited, singleStats.nodesVisited, emitted, listed);
+
+    // A full batch uses every bit of the view mask
+    eastl::vector<Frustum> full;
+    for (uint32_t view = 0; view < BVH::MAX_CULL_VIEWS; ++view) {
+        float angle = view * 0.19635f;
+        full.push_back(makeFrustum(glm::vec3(std::sin(angle) * 700.0f, 50.0f, std::cos(angle) * 700.0f),
+                                   glm::vec3(0.0f)));
+    }
+    uint32_t seen = 0;
+    uint32_t lastViewCount = 0;
+    bvh.cullFrusta(full.data(), BVH::MAX_CULL_VIEWS, [&](uint32_t, uint32_t viewMask) {
+        seen |= viewMask;
+        lastViewCount += viewMask >> (BVH::MAX_CULL_VIEWS - 1);
+    });
+    eastl::vector<uint8_t> planeHints;
+    uint32_t lastReference = 0;
+    bvh.cullFrustum(full.back(), planeHints, [&](uint32_t) { ++lastReference; });
+    CHECK(seen == ~0u, "a view of a full batch saw nothing");
+    CHECK(lastViewCount == lastReference, "last view of a full batch differs from cullFrustum");
+}
+
+// Brute-force SoA kernels must agree with Frustum::testAABB exactly
+void testCullKernels() {
+    fmt::print("\n=== Brute-force culling kernels (best: {}) ===\n",
+               FrustumCuller::getBestKernel() == CullKernel::AVX2 ? "AVX2"
+               : FrustumCuller::getBestKernel() == CullKernel::SSE2 ? "SSE2" : "scalar");
+
+    auto frustum = makeFrustum(glm::vec3(0.0f, 100.0f, -800.0f), glm::vec3(100.0f, 0.0f, 0.0f));
+    for (uint32_t count : {0u, 5u, 13u, 1003u, 20000u}) {
+        auto boxes = makeBoxes(count, 1000u + count, false);
+        AABBSoA soa;
+        soa.assign(boxes);
+
+        eastl::vector<uint32_t> reference;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (frustum.testAABB(boxes[i])) {
+                reference.push_back(i);
+            }
+        }
+
+        for (CullKernel kernel : {CullKernel::Scalar, CullKernel::SSE2, CullKernel::AVX2}) {
+            eastl::vector<uint32_t> visible = {~0u};  // Results are appended after existing entries
+            uint32_t written = FrustumCuller::cull(frustum, soa, visible, kernel);
+            bool match = written == reference.size() && visible.size() == reference.size() + 1 && visible[0] == ~0u &&
+                         eastl::equal(reference.begin(), reference.end(), visible.begin() + 1);
+            CHECK(match, "culling kernel differs from Frustum::testAABB");
+        }
+    }
+}
+
+// Brute force vs hierarchical culling across scene sizes, to pick the renderer's crossover
+void benchmarkCulling(ThreadPool& pool) {
+    fmt::print("\n=== Culling benchmark (us per cull: brute force / BVH traverse / BVH masked) ===\n");
+
+    // Most of the scene in view, and a view from inside seeing a small part of it
+    const Frustum views[] = {makeFrustum(glm::vec3(0.0f, 100.0f, -800.0f), glm::vec3(100.0f, 0.0f, 0.0f)),
+                             makeFrustum(glm::vec3(0.0f), glm::vec3(1.0f, 0.2f, 0.3f))};
+    for (const Frustum& frustum : views) {
+        for (uint32_t count : {64u, 256u, 1024u, 4096u, 16384u, 65536u}) {
+            auto boxes = makeBoxes(count, 77u + count, false);
+            AABBSoA soa;
+            soa.assign(boxes);
+            BVH bvh;
+            bvh.build(boxes, &pool);
+            eastl::vector<uint8_t> planeHints;
+            eastl::vector<uint32_t> visible;
+            visible.reserve(count);
+
+            const uint32_t iterations = eastl::max(4u, 1000000u / count);
+            auto time = [&](auto&& cull) {
+                auto start = std::chrono::high_resolution_clock::now();
+                for (uint32_t it = 0; it < iterations; ++it) {
+                    visible.clear();
+                    cull();
+                }
+                return std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() /
+                       iterations;
+            };
+
+            double bruteUs = time([&] { FrustumCuller::cull(frustum, soa, visible); });
+            size_t bruteVisible = visible.size();
+            double traverseUs = time([&] {
+                bvh.traverse([&](const AABB& b) { return frustum.testAABB(b); },
+                             [&](uint32_t index) { visible.push_back(index); });
+            });
+            double maskedUs = time([&] {
+                bvh.cullFrustum(frustum, planeHints, [&](uint32_t index) { visible.push_back(index); });
+            });
+            fmt::print("  {:6} boxes ({:5} visible): {:9.2f} / {:9.2f} / {:9.2f}\n", count, bruteVisible, bruteUs,
+                       traverseUs, maskedUs);
+            CHECK(bruteVisible == visible.size(), "brute force and BVH culling disagree");
+        }
+    }
+}
+
+// Early exit, pull-style queries and the heap fallback for very deep trees
+void testTraversalApi(ThreadPool& pool) {
+    fmt::print("\n=== Traversal API ===\n");
+
+    auto boxes = makeBoxes(20000, 99u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool);
+
+    // Returning false from the leaf handler stops the traversal
+    uint32_t visited = 0;
+    bvh.traverse([](const AABB&) { return true; }, [&](uint32_t) { return ++visited < 10; });
+    CHECK(visited == 10, "binary early exit");
+    visited = 0;
+    bvh.traverseWide([](const AABB4&) { return 0xFu; }, [&](uint32_t) { return ++visited < 10; });
+    CHECK(visited == 10, "wide early exit");
+
+    // Query yields the same primitives in the same order as traverse
+    AABB region(glm::vec3(-200.0f), glm::vec3(150.0f));
+    auto test = [&](const AABB& b) { return overlaps(region, b); };
+    eastl::vector<uint32_t> pushed;
+    bvh.traverse(test, [&](uint32_t index) { pushed.push_back(index); });
+    eastl::vector<uint32_t> pulled;
+    auto query = bvh.query(test);
+    for (uint32_t index; query.next(index);) {
+        pulled.push_back(index);
+    }
+    CHECK(!pulled.empty() && pulled == pushed, "query differs from traverse");
+
+    // Stacks deeper than the inline capacity spill to the heap
+    BVHTraversalStack deepStack(BVHTraversalStack::INLINE_CAPACITY * 4);
+    for (uint32_t i = 0; i < BVHTraversalStack::INLINE_CAPACITY * 4; ++i) {
+        deepStack.push(i);
+    }
+    bool lifo = true;
+    for (uint32_t i = BVHTraversalStack::INLINE_CAPACITY * 4; i-- > 0;) {
+        lifo &= deepStack.pop() == i;
+    }
+    CHECK(lifo && deepStack.empty(), "heap-backed traversal stack");
+}
+
+// Closest-hit and any-hit ray queries against a brute-force reference
+void testRayQueries(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Ray queries ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(50000, 4242u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool, method);
+
+    auto boxIntersector = [&](uint32_t& calls) {
+        return [&](uint32_t index, Ray& ray) {
+            ++calls;
+            float tNear, tFar;
+            if (!ray.intersectAABB(boxes[index], tNear, tFar)) {
+                return false;
+            }
+            ray.tMax = glm::max(tNear, ray.tMin);
+            return true;
+        };
+    };
+
+    std::mt19937 rng(17u);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    uint32_t mismatches = 0;
+    uint32_t anyMismatches = 0;
+    uint32_t hits = 0;
+    uint32_t totalCalls = 0;
+    for (uint32_t r = 0; r < 200; ++r) {
+        glm::vec3 origin(unit(rng) * 600.0f, unit(rng) * 600.0f, unit(rng) * 600.0f);
+        glm::vec3 direction = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + 1e-3f);
+
+        Ray reference(origin, direction);
+        bool referenceHit = false;
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            float tNear, tFar;
+            if (reference.intersectAABB(boxes[i], tNear, tFar)) {
+                reference.tMax = glm::max(tNear, reference.tMin);
+                referenceHit   = true;
+            }
+        }
+
+        uint32_t calls = 0;
+        Ray ray(origin, direction);
+        bool hit = bvh.intersectClosest(ray, boxIntersector(calls));
+        totalCalls += calls;
+        hits += hit ? 1 : 0;
+        if (hit != referenceHit || (hit && ray.tMax != reference.tMax)) {
+            ++mismatches;
+        }
+
+        uint32_t anyCalls = 0;
+        Ray shadowRay(origin, direction);
+        if (bvh.intersectAny(shadowRay, boxIntersector(anyCalls)) != referenceHit) {
+            ++anyMismatches;
+        }
+    }
+    fmt::print("  {} / 200 rays hit, {:.1f} primitive tests per ray (of {})\n", hits, totalCalls / 200.0f, boxes.size());
+    CHECK(hits > 0, "no ray hit anything");
+    CHECK(mismatches == 0, "closest hit differs from brute force");
+    CHECK(anyMismatches == 0, "any hit differs from brute force");
+}
+
+// Triangle intersection and triangle-accurate picking over a 1M triangle soup
+void testTrianglePicking(ThreadPool& pool) {
+    fmt::print("\n=== Triangle picking ===\n");
+
+    // Barycentrics and t for a known hit, both windings, and the t range
+    Ray down(glm::vec3(0.25f, 0.25f, 5.0f), glm::vec3(0.0f, 0.0f, -2.0f));
+    glm::vec3 v0(0.0f, 0.0f, 1.0f), v1(1.0f, 0.0f, 1.0f), v2(0.0f, 1.0f, 1.0f);
+    float t, u, v;
+    CHECK(down.intersectTriangle(v0, v1, v2, t, u, v) && glm::abs(t - 2.0f) < 1e-5f &&
+              glm::abs(u - 0.25f) < 1e-5f && glm::abs(v - 0.25f) < 1e-5f,
+          "triangle hit distance / barycentrics");
+    CHECK(down.intersectTriangle(v0, v2, v1, t, u, v), "back-facing triangle missed");
+    CHECK(!down.intersectTriangle(v0 + glm::vec3(2.0f, 0.0f, 0.0f), v1 + glm::vec3(2.0f, 0.0f, 0.0f),
+                                  v2 + glm::vec3(2.0f, 0.0f, 0.0f), t, u, v),
+          "triangle outside edges hit");
+    Ray shortRay(down.origin, down.direction, 0.0f, 1.5f);
+    CHECK(!shortRay.intersectTriangle(v0, v1, v2, t, u, v), "triangle beyond tMax hit");
+
+    constexpr uint32_t TRIANGLE_COUNT = 1000000;
+    std::mt19937 rng(2024u);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+    eastl::vector<glm::vec3> positions;
+    eastl::vector<AABB> bounds;
+    positions.reserve(TRIANGLE_COUNT * 3);
+    bounds.reserve(TRIANGLE_COUNT);
+    for (uint32_t i = 0; i < TRIANGLE_COUNT; ++i) {
+        glm::vec3 c(pos(rng), pos(rng), pos(rng));
+        AABB box;
+        for (uint32_t k = 0; k < 3; ++k) {
+            glm::vec3 p = c + glm::vec3(offset(rng), offset(rng), offset(rng));
+            positions.push_back(p);
+            box.expand(p);
+        }
+        bounds.push_back(box);
+    }
+
+    BVH bvh;
+    bvh.build(bounds, &pool);
+
+    auto triangleIntersector = [&](uint32_t index, Ray& ray) {
+        float t, u, v;
+        if (!ray.intersectTriangle(positions[index * 3], positions[index * 3 + 1], positions[index * 3 + 2], t, u, v)) {
+            return false;
+        }
+        ray.tMax = t;
+        return true;
+    };
+
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    uint32_t mismatches = 0;
+    uint32_t hits = 0;
+    double queryMs = 0.0;
+    constexpr uint32_t RAY_COUNT = 16;
+    for (uint32_t r = 0; r < RAY_COUNT; ++r) {
+        // Rays from outside the soup aimed at a point inside it, like a camera pick
+        glm::vec3 target(unit(rng) * 300.0f, unit(rng) * 300.0f, unit(rng) * 300.0f);
+        glm::vec3 origin(unit(rng) * 200.0f, unit(rng) * 200.0f, -900.0f);
+        glm::vec3 direction = glm::normalize(target - origin);
+
+        Ray reference(origin, direction);
+        int32_t referenceIndex = -1;
+        for (uint32_t i = 0; i < TRIANGLE_COUNT; ++i) {
+            if (triangleIntersector(i, reference)) {
+                referenceIndex = static_cast<int32_t>(i);
+            }
+        }
+
+        Ray ray(origin, direction);
+        int32_t hitIndex = -1;
+        auto start = std::chrono::high_resolution_clock::now();
+        bvh.intersectClosest(ray, [&](uint32_t index, Ray& ray) {
+            if (!triangleIntersector(index, ray)) {
+                return false;
+            }
+            hitIndex = static_cast<int32_t>(index);
+            return true;
+        });
+        queryMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        hits += hitIndex >= 0 ? 1 : 0;
+        if (hitIndex != referenceIndex) {
+            ++mismatches;
+        }
+    }
+    fmt::print("  {} / {} rays hit, {:.4f}ms per closest-hit query over {} triangles\n", hits, RAY_COUNT,
+               queryMs / RAY_COUNT, TRIANGLE_COUNT);
+    CHECK(hits > 0, "no ray hit a triangle");
+    CHECK(mismatches == 0, "closest triangle differs from brute force");
+}
+
+// Two-level queries: static per-submesh triangle BVHs under a refittable instance BVH
+void testTwoLevel(ThreadPool& pool) {
+    fmt::print("\n=== Two-level (BLAS + TLAS) ===\n");
+
+    // A bumpy grid split into two submeshes, shared by every instance
+    constexpr uint32_t GRID = 64;
+    MeshGeometry geometry;
+    for (uint32_t z = 0; z <= GRID; ++z) {
+        for (uint32_t x = 0; x <= GRID; ++x) {
+            float fx = static_cast<float>(x) / GRID - 0.5f;
+            float fz = static_cast<float>(z) / GRID - 0.5f;
+            geometry.positions.push_back(glm::vec3(fx, 0.05f * glm::sin(fx * 40.0f) * glm::cos(fz * 30.0f), fz));
+        }
+    }
+    for (uint32_t z = 0; z < GRID; ++z) {
+        for (uint32_t x = 0; x < GRID; ++x) {
+            uint32_t i = z * (GRID + 1) + x;
+            geometry.indices.insert(geometry.indices.end(), {i, i + 1, i + GRID + 1, i + 1, i + GRID + 2, i + GRID + 1});
+        }
+    }
+    uint32_t half = static_cast<uint32_t>(geometry.indices.size()) / 2;
+    geometry.addSubMesh(0, half);
+    geometry.addSubMesh(half, half);
+
+    struct Instance {
+        glm::mat4 transform;
+        uint32_t  subMesh;
+    };
+    std::mt19937 rng(31u);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    eastl::vector<Instance> instances;
+    for (uint32_t i = 0; i < 400; ++i) {
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(unit(rng), unit(rng), unit(rng)) * 100.0f);
+        transform = glm::rotate(transform, unit(rng) * 3.0f, glm::normalize(glm::vec3(unit(rng), 1.0f, unit(rng))));
+        transform = glm::scale(transform, glm::vec3(10.0f + 5.0f * unit(rng)));
+        instances.push_back({transform, i % 2});
+    }
+
+    auto instanceBounds = [&](const Instance& instance) {
+        AABB local;
+        const auto& subMesh = geometry.subMeshes[instance.subMesh];
+        for (uint32_t i = 0; i < subMesh.indexCount; ++i) {
+            local.expand(geometry.positions[geometry.indices[subMesh.firstIndex + i]]);
+        }
+        return local.transform(instance.transform);
+    };
+    eastl::vector<AABB> bounds;
+    for (const auto& instance : instances) {
+        bounds.push_back(instanceBounds(instance));
+    }
+    BVH tlas;
+    tlas.build(bounds, &pool);
+
+    auto trace = [&](const glm::vec3& origin, const glm::vec3& direction) {
+        Ray ray(origin, direction);
+        bool hit = tlas.intersectClosest(ray, [&](uint32_t index, Ray& ray) {
+            glm::mat4 inverse = glm::inverse(instances[index].transform);
+            Ray local(glm::vec3(inverse * glm::vec4(ray.origin, 1.0f)), glm::vec3(inverse * glm::vec4(ray.direction, 0.0f)),
+                      ray.tMin, ray.tMax);
+            uint32_t  triangle;
+            glm::vec2 barycentrics;
+            if (!geometry.intersect(instances[index].subMesh, local, false, triangle, barycentrics)) {
+                return false;
+            }
+            ray.tMax = local.tMax;
+            return true;
+        });
+        return hit ? ray.tMax : -1.0f;
+    };
+
+    // Every triangle of every instance, in the same object space the two-level query uses
+    auto bruteForce = [&](const glm::vec3& origin, const glm::vec3& direction) {
+        float closest = -1.0f;
+        for (const auto& instance : instances) {
+            glm::mat4 inverse = glm::inverse(instance.transform);
+            Ray local(glm::vec3(inverse * glm::vec4(origin, 1.0f)), glm::vec3(inverse * glm::vec4(direction, 0.0f)));
+            const auto& subMesh = geometry.subMeshes[instance.subMesh];
+            for (uint32_t i = 0; i < subMesh.indexCount; i += 3) {
+                const uint32_t* tri = &geometry.indices[subMesh.firstIndex + i];
+                float t, u, v;
+                if (local.intersectTriangle(geometry.positions[tri[0]], geometry.positions[tri[1]],
+                                            geometry.positions[tri[2]], t, u, v) &&
+                    (closest < 0.0f || t < closest)) {
+                    closest = t;
+                }
+            }
+        }
+        return closest;
+    };
+
+    auto compare = [&]() {
+        uint32_t mismatches = 0;
+        uint32_t hits = 0;
+        for (uint32_t r = 0; r < 64; ++r) {
+            const Instance& target = instances[r * 5 % instances.size()];
+            glm::vec3 origin(unit(rng) * 50.0f, 300.0f, unit(rng) * 50.0f);
+            // Aim inside a triangle rather than at a shared grid vertex
+            glm::vec3 aim(target.transform * glm::vec4(0.0123f, 0.0f, 0.0271f, 1.0f));
+            glm::vec3 direction = glm::normalize(aim - origin);
+            float t = trace(origin, direction);
+            float reference = bruteForce(origin, direction);
+            hits += t >= 0.0f ? 1 : 0;
+            if (t != reference) {
+                ++mismatches;
+            }
+        }
+        fmt::print("  {} / 64 rays hit\n", hits);
+        return hits > 0 && mismatches == 0;
+    };
+    CHECK(compare(), "two-level hit differs from brute force");
+
+    // Moving instances only refits the top level; the triangle BVHs stay untouched
+    uint32_t blasNodes = geometry.subMeshes[0].bvh.getBuildStats().nodeCount;
+    for (uint32_t i = 0; i < instances.size(); i += 3) {
+        instances[i].transform = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 20.0f, 0.0f)) * instances[i].transform;
+        tlas.refit(i, instanceBounds(instances[i]));
+    }
+    CHECK(compare(), "two-level hit differs after instance refit");
+    CHECK(geometry.subMeshes[0].bvh.getBuildStats().nodeCount == blasNodes, "triangle BVH changed on move");
+}
+
+// Overlap and nearest-neighbour queries must match brute force over the primitive bounds
+void testSpatialQueries(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Spatial queries ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(20000, 99u, false);
+    BVH  bvh;
+    bvh.build(boxes, &pool, method);
+
+    std::mt19937 rng(5u);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(5.0f, 120.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.28f);
+
+    auto sorted = [](eastl::vector<uint32_t> v) {
+        eastl::sort(v.begin(), v.end());
+        return v;
+    };
+
+    uint32_t mismatches[5] = {};
+    uint32_t total = 0;
+    for (uint32_t q = 0; q < 50; ++q) {
+        const glm::vec3 center(pos(rng), pos(rng), pos(rng));
+        const float     extent = size(rng);
+
+        const AABB box(center - extent, center + extent);
+        const OBB  obb(AABB(glm::vec3(-extent, -extent * 0.5f, -extent * 0.25f), glm::vec3(extent, extent * 0.5f, extent * 0.25f)),
+                       glm::rotate(glm::translate(glm::mat4(1.0f), center), angle(rng), glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f))));
+        const Frustum frustum = makeFrustum(center, center + glm::vec3(pos(rng), pos(rng), pos(rng)));
+
+        eastl::vector<uint32_t> expected[4], actual[4];
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].overlaps(box)) expected[0].push_back(i);
+            if (boxes[i].distanceSquared(center) <= extent * extent) expected[1].push_back(i);
+            if (obb.intersects(boxes[i])) expected[2].push_back(i);
+            if (frustum.testAABB(boxes[i])) expected[3].push_back(i);
+        }
+        bvh.queryAABB(box, actual[0]);
+        bvh.querySphere(center, extent, actual[1]);
+        bvh.queryOBB(obb, actual[2]);
+        bvh.queryFrustum(frustum, actual[3]);
+        for (uint32_t type = 0; type < 4; ++type) {
+            mismatches[type] += sorted(actual[type]) != expected[type] ? 1 : 0;
+            total += static_cast<uint32_t>(expected[type].size());
+        }
+
+        // k nearest, ordered by (distance, index), limited by distance
+        const uint32_t k           = 1 + q % 16;
+        const float    maxDistance = q % 3 == 0 ? 20.0f : std::numeric_limits<float>::max();
+        eastl::vector<BVHNeighbor> reference;
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            float d = boxes[i].distanceSquared(center);
+            if (d <= maxDistance * maxDistance) {
+                reference.push_back({i, std::sqrt(d)});
+            }
+        }
+        eastl::sort(reference.begin(), reference.end(), [](const BVHNeighbor& a, const BVHNeighbor& b) {
+            return a.distance < b.distance || (a.distance == b.distance && a.primitiveIndex < b.primitiveIndex);
+        });
+        reference.resize(eastl::min<size_t>(reference.size(), k));
+
+        eastl::vector<BVHNeighbor> nearest;
+        bvh.queryNearest(center, k, maxDistance, nearest);
+        bool same = nearest.size() == reference.size();
+        for (uint32_t i = 0; same && i < nearest.size(); ++i) {
+            same = nearest[i].primitiveIndex == reference[i].primitiveIndex && nearest[i].distance == reference[i].distance;
+        }
+        mismatches[4] += same ? 0 : 1;
+    }
+    fmt::print("  50 queries per type, {} overlaps found\n", total);
+    CHECK(mismatches[0] == 0, "AABB query differs from brute force");
+    CHECK(mismatches[1] == 0, "sphere query differs from brute force");
+    CHECK(mismatches[2] == 0, "OBB query differs from brute force");
+    CHECK(mismatches[3] == 0, "frustum query differs from brute force");
+    CHECK(mismatches[4] == 0, "k-nearest differs from brute force");
+
+    // An orthographic light volume as an OBB (how shadow cascades query casters). The NDC cube
+    // is taken as [-1, 1] in z, which covers both depth conventions.
+    const glm::mat4 lightViewProj = glm::ortho(-40.0f, 60.0f, -20.0f, 30.0f, 5.0f, 300.0f) *
+                                    glm::lookAt(glm::vec3(100.0f, 200.0f, 50.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const OBB lightVolume(AABB(glm::vec3(-1.0f), glm::vec3(1.0f)), glm::inverse(lightViewProj));
+    uint32_t volumeMismatches = 0;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        const glm::vec3 p(pos(rng) * 0.3f, pos(rng) * 0.3f, pos(rng) * 0.3f);
+        const glm::vec4 ndc = lightViewProj * glm::vec4(p, 1.0f);
+        const float     xy  = glm::max(glm::abs(ndc.x), glm::abs(ndc.y));
+        const bool      inside  = xy < 0.999f && ndc.z > 0.001f && ndc.z < 0.999f;
+        const bool      outside = xy > 1.001f || glm::abs(ndc.z) > 1.001f;
+        const bool      hit     = lightVolume.intersects(AABB(p, p));
+        volumeMismatches += (inside && !hit) || (outside && hit) ? 1 : 0;
+    }
+    CHECK(volumeMismatches == 0, "OBB of an orthographic volume differs from its clip space");
+
+    // Caller buffers are appended to, and maxResults caps what is appended
+    eastl::vector<uint32_t> capped = {123u};
+    CHECK(bvh.queryAABB(AABB(glm::vec3(-600.0f), glm::vec3(600.0f)), capped, 10) == 10 && capped.size() == 11 &&
+              capped[0] == 123u, "maxResults not honoured");
+    CHECK(bvh.querySphere(glm::vec3(0.0f), 1000.0f, capped, 0) == 0, "maxResults 0 appended results");
+
+    // Timing against the brute-force scan for a point light sized sphere
+    constexpr uint32_t ITERATIONS = 1000;
+    eastl::vector<uint32_t> found;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < ITERATIONS; ++i) {
+        found.clear();
+        bvh.querySphere(glm::vec3(pos(rng), pos(rng), pos(rng)), 25.0f, found);
+    }
+    auto mid = std::chrono::high_resolution_clock::now();
+    uint32_t bruteFound = 0;
+    for (uint32_t i = 0; i < ITERATIONS; ++i) {
+        glm::vec3 c(pos(rng), pos(rng), pos(rng));
+        for (const AABB& b : boxes) {
+            bruteFound += b.distanceSquared(c) <= 625.0f ? 1 : 0;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    fmt::print("  r=25 sphere: {:.4f}ms per query vs {:.4f}ms brute force ({:.1f} hits avg)\n",
+               std::chrono::duration<double, std::milli>(mid - start).count() / ITERATIONS,
+               std::chrono::duration<double, std::milli>(end - mid).count() / ITERATIONS,
+               static_cast<double>(bruteFound) / ITERATIONS);
+}
+
+// Software occlusion: conservative box tests, tiled rasterization independent of the pool,
+// and occlusion-filtered BVH culling that never drops a visible primitive
+void testOcclusion(ThreadPool& pool) {
+    fmt::print("\n=== Occlusion culling ===\n");
+
+    const glm::mat4 viewProj = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 1000.0f) *
+                               glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const AABB wall(glm::vec3(-20.0f, -10.0f, -31.0f), glm::vec3(20.0f, 10.0f, -30.0f));
+
+    OcclusionCuller empty;
+    empty.begin(viewProj);
+    empty.rasterize();
+    CHECK(empty.testAABB(AABB(glm::vec3(-1.0f, -1.0f, -50.0f), glm::vec3(1.0f, 1.0f, -48.0f))), "empty buffer occludes");
+
+    OcclusionCuller culler;
+    culler.begin(viewProj);
+    culler.addOccluderBox(wall);
+    culler.rasterize(&pool);
+
+    CHECK(!culler.testAABB(AABB(glm::vec3(-2.0f, -2.0f, -52.0f), glm::vec3(2.0f, 2.0f, -48.0f))), "box behind the wall visible");
+    CHECK(!culler.testAABB(AABB(glm::vec3(-18.0f, -8.0f, -300.0f), glm::vec3(18.0f, 8.0f, -40.0f))), "large box behind the wall visible");
+    CHECK(culler.testAABB(AABB(glm::vec3(-1.0f, -1.0f, -12.0f), glm::vec3(1.0f, 1.0f, -10.0f))), "box in front of the wall hidden");
+    CHECK(culler.testAABB(AABB(glm::vec3(45.0f, -2.0f, -62.0f), glm::vec3(55.0f, 2.0f, -58.0f))), "box beside the wall hidden");
+    CHECK(culler.testAABB(AABB(glm::vec3(-5.0f, -5.0f, -35.0f), glm::vec3(5.0f, 15.0f, -33.0f))), "box poking out above hidden");
+    CHECK(culler.testAABB(AABB(glm::vec3(-1.0f), glm::vec3(1.0f))), "box around the camera hidden");
+    CHECK(culler.testAABB(AABB(glm::vec3(-1.0f, -1.0f, -30.5f), glm::vec3(1.0f, 1.0f, -29.0f))), "box intersecting the wall hidden");
+
+    OcclusionCuller serial;
+    serial.begin(viewProj);
+    serial.addOccluderBox(wall);
+    serial.rasterize(nullptr);
+    CHECK(serial.getDepth() == culler.getDepth(), "tiled rasterization depends on the pool");
+
+    // A field of objects behind and around a few walls
+    std::mt19937 rng(2024u);
+    std::uniform_real_distribution<float> x(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> z(-400.0f, -5.0f);
+    std::uniform_real_distribution<float> extent(0.2f, 2.0f);
+    eastl::vector<AABB> boxes;
+    for (uint32_t i = 0; i < 50000; ++i) {
+        glm::vec3 c(x(rng), x(rng) * 0.2f, z(rng));
+        glm::vec3 e(extent(rng));
+        boxes.push_back(AABB(c - e, c + e));
+    }
+
+    OcclusionCuller field;
+    field.begin(viewProj);
+    field.addOccluderBox(wall);
+    field.addOccluderBox(AABB(glm::vec3(-80.0f, -20.0f, -62.0f), glm::vec3(-30.0f, 20.0f, -60.0f)));
+    field.addOccluderBox(AABB(glm::vec3(30.0f, -20.0f, -62.0f), glm::vec3(80.0f, 20.0f, -60.0f)));
+    field.rasterize(&pool);
+
+    Frustum frustum;
+    frustum.extract(viewProj);
+
+    uint32_t frustumVisible = 0, occlusionVisible = 0;
+    eastl::vector<uint8_t> expected(boxes.size(), 0);
+    for (uint32_t i = 0; i < boxes.size(); ++i) {
+        if (frustum.testAABB(boxes[i])) {
+            ++frustumVisible;
+            if (field.testAABB(boxes[i])) {
+                expected[i] = 1;
+                ++occlusionVisible;
+            }
+        }
+    }
+
+    for (BVHBuildMethod method : {BVHBuildMethod::LBVH, BVHBuildMethod::SAH}) {
+        BVH bvh;
+        bvh.build(boxes, &pool, method);
+
+        // Leaves are accepted by their node bounds, so compare against unfiltered culling
+        eastl::vector<uint8_t> hints;
+        eastl::vector<uint8_t> unfiltered(boxes.size(), 0);
+        bvh.cullFrustum(frustum, hints, [&](uint32_t i) { unfiltered[i] = 1; });
+
+        eastl::vector<uint8_t> emitted(boxes.size(), 0);
+        uint32_t laneRejects = 0;
+        bvh.cullFrustumFiltered(frustum, hints,
+            [&](const AABB4& lanes, uint32_t mask) {
+                uint32_t kept = field.testAABB4(lanes, mask);
+                laneRejects += std::popcount(mask & ~kept);
+                return kept;
+            },
+            [&](uint32_t i) { emitted[i] = 1; });
+
+        uint32_t missing = 0, outside = 0, count = 0;
+        for (uint32_t i = 0; i < boxes.size(); ++i) {
+            missing += expected[i] && !emitted[i] ? 1 : 0;
+            outside += emitted[i] && !unfiltered[i] ? 1 : 0;
+            count += emitted[i];
+        }
+        fmt::print("  {}: {} in frustum, {} emitted ({} exact), {} subtrees occluded\n",
+                   method == BVHBuildMethod::SAH ? "SAH" : "LBVH", frustumVisible, count, occlusionVisible, laneRejects);
+        CHECK(missing == 0, "occlusion-filtered traversal dropped a visible box");
+        CHECK(outside == 0, "occlusion-filtered traversal emitted a box plain culling rejects");
+        CHECK(count < frustumVisible, "nothing was occluded");
+    }
+
+    // Raster cost for a dense occluder: a 40x40 grid of boxes (19200 triangles)
+    OcclusionCuller dense;
+    dense.begin(viewProj);
+    for (int i = 0; i < 40; ++i) {
+        for (int j = 0; j < 40; ++j) {
+            glm::vec3 c(-60.0f + i * 3.0f, -30.0f + j * 1.5f, -80.0f - (i + j) % 7);
+            dense.addOccluderBox(AABB(c - 1.0f, c + 1.0f));
+        }
+    }
+    dense.rasterize(nullptr);
+    float serialMs = dense.getStats().rasterTimeMs;
+    dense.rasterize(&pool);
+    fmt::print("  {} occluder triangles ({} rejected): raster {:.3f}ms serial, {:.3f}ms on the pool\n",
+               dense.getStats().occluderTriangles, dense.getStats().rejectedTriangles, serialMs,
+               dense.getStats().rasterTimeMs);
+}
+
+// Cached trees must reload identical to the build and reject anything not made for the input
+void testCache(ThreadPool& pool, BVHBuildMethod method) {
+    fmt::print("\n=== Cache round trip ({}) ===\n", method == BVHBuildMethod::SAH ? "SAH" : "LBVH");
+
+    auto boxes = makeBoxes(30000, 777u, false);
+    BVH  built;
+    built.build(boxes, &pool, method);
+
+    const uint64_t key = BVH::computeCacheKey(boxes, method);
+    CHECK(key != BVH::computeCacheKey(boxes, method == BVHBuildMethod::SAH ? BVHBuildMethod::LBVH : BVHBuildMethod::SAH),
+          "key ignores the build method");
+
+    eastl::vector<uint8_t> blob;
+    built.serialize(key, blob);
+
+    // Through a real file and mapping, as the renderer loads it
+    const eastl::string path = "bvh_cache_test.bvh";
+    CHECK(FileSystem::writeBinary(path, blob.data(), blob.size()), "cache write failed");
+    {
+        MappedFile file(path);
+        CHECK(file.isValid() && file.size() == blob.size(), "cache mapping failed");
+
+        BVH loaded;
+        CHECK(loaded.deserialize(file.data(), file.size(), key, boxes, method, &pool), "valid blob rejected");
+        CHECK(loaded.getBuildStats().fromCache, "fromCache not set");
+        CHECK(collectAll(loaded) == collectAll(built), "reloaded traversal order differs");
+        CHECK(loaded.getQualityStats().sahCost == built.getQualityStats().sahCost, "reloaded tree quality differs");
+
+        Frustum frustum = makeFrustum(glm::vec3(0.0f, 0.0f, -700.0f), glm::vec3(100.0f, 50.0f, 0.0f));
+        eastl::vector<uint8_t>  builtHints, loadedHints;
+        eastl::vector<uint32_t> builtVisible, loadedVisible;
+        built.cullFrustum(frustum, builtHints, [&](uint32_t i) { builtVisible.push_back(i); });
+        loaded.cullFrustum(frustum, loadedHints, [&](uint32_t i) { loadedVisible.push_back(i); });
+        CHECK(builtVisible == loadedVisible, "reloaded culling differs");
+
+        fmt::print("  {} bytes, build={:.3f}ms load={:.3f}ms\n", blob.size(), built.getBuildStats().buildTimeMs,
+                   loaded.getBuildStats().buildTimeMs);
+    }
+    std::remove(path.c_str());
+
+    BVH rejected;
+    CHECK(!rejected.deserialize(blob.data(), blob.size(), key + 1, boxes, method), "wrong key accepted");
+    CHECK(!rejected.deserialize(blob.data(), blob.size() - 4, key, boxes, method), "truncated blob accepted");
+    CHECK(rejected.getPrimitiveCount() == 0 && collectAll(rejected).empty(), "rejected load left a tree behind");
+
+    auto fewer = boxes;
+    fewer.pop_back();
+    CHECK(!rejected.deserialize(blob.data(), blob.size(), key, fewer, method), "primitive count mismatch accepted");
+
+    // Corrupt topology: a child pointing back at the root, and a duplicated leaf index
+    auto corrupt = blob;
+    const size_t firstNode = 32;
+    uint32_t zero = 0;
+    for (uint32_t node = 0; node < built.getBuildStats().nodeCount; ++node) {
+        uint32_t count;
+        std::memcpy(&count, &corrupt[firstNode + node * 12 + 4], 4);
+        if (count == 0) {
+            std::memcpy(&corrupt[firstNode + node * 12 + 8], &zero, 4);
+            break;
+        }
+    }
+    CHECK(!rejected.deserialize(corrupt.data(), corrupt.size(), key, boxes, method), "cyclic topology accepted");
+
+    corrupt = blob;
+    std::memcpy(&corrupt[corrupt.size() - 4], &corrupt[corrupt.size() - 8], 4);
+    CHECK(!rejected.deserialize(corrupt.data(), corrupt.size(), key, boxes, method), "duplicate leaf index accepted");
+
+    // Two leaves trading ranges still cover every slot once, but out of tree order
+    corrupt = blob;
+    size_t leaves[2];
+    uint32_t leafCount = 0;
+    for (uint32_t node = 0; node < built.getBuildStats().nodeCount && leafCount < 2; ++node) {
+        uint32_t count;
+        std::memcpy(&count, &corrupt[firstNode + node * 12 + 4], 4);
+        if (count != 0) {
+            leaves[leafCount++] = firstNode + node * 12;
+        }
+    }
+    uint8_t range[8];
+    std::memcpy(range, &corrupt[leaves[0]], 8);
+    std::memcpy(&corrupt[leaves[0]], &corrupt[leaves[1]], 8);
+    std::memcpy(&corrupt[leaves[1]], range, 8);
+    CHECK(!rejected.deserialize(corrupt.data(), corrupt.size(), key, boxes, method), "out-of-order leaf ranges accepted");
+
+    // Moved inputs change the key; forcing the old key still yields bounds that fit the new input
+    auto moved = boxes;
+    moved[0] = AABB(moved[0].min + 1000.0f, moved[0].max + 1000.0f);
+    CHECK(BVH::computeCacheKey(moved, method) != key, "key ignores the bounds");
+    BVH collided;
+    CHECK(collided.deserialize(blob.data(), blob.size(), key, moved, method), "forced key rejected");
+    const AABB& scene = collided.getSceneBounds();
+    const AABB  grown = scene.unionOf(moved[0]);
+    CHECK(grown.min == scene.min && grown.max == scene.max, "bounds not recomputed from the input");
+}
+
+// 63-bit encoding and adaptive code width
+void testMortonCodes(ThreadPool& pool) {
+    fmt::print("\n=== Morton codes ===\n");
+
+    CHECK(BVH::mortonEncode(1, 0, 0) == 1ull, "x lands in bit 0");
+    CHECK(BVH::mortonEncode(0, 1, 0) == 2ull, "y lands in bit 1");
+    CHECK(BVH::mortonEncode(0, 0, 1) == 4ull, "z lands in bit 2");
+    CHECK(BVH::mortonEncode(0x1FFFFF, 0x1FFFFF, 0x1FFFFF) == 0x7FFFFFFFFFFFFFFFull, "full 63-bit code");
+    CHECK(BVH::mortonEncode(0x1FFFFF, 0, 0) == 0x1249249249249249ull, "x mask");
+
+    // Compact scene: 10 bits per axis suffices
+    auto compact = makeBoxes(5000, 3u, false);
+    BVH  bvh;
+    bvh.build(compact, &pool);
+    CHECK(bvh.getBuildStats().mortonBits == 30, "compact scene should use 30-bit codes");
+
+    // Sparse scene: a dense town of small props plus a few objects kilometres away
+    std::mt19937 rng(17u);
+    std::uniform_real_distribution<float> town(-50.0f, 50.0f);
+    eastl::vector<AABB> sparse;
+    for (uint32_t i = 0; i < 20000; ++i) {
+        glm::vec3 c(town(rng), town(rng) * 0.1f, town(rng));
+        sparse.push_back(AABB(c - glm::vec3(0.05f), c + glm::vec3(0.05f)));
+    }
+    for (int i = 0; i < 4; ++i) {
+        glm::vec3 c(200000.0f * (i & 1 ? 1.0f : -1.0f), 0.0f, 200000.0f * (i & 2 ? 1.0f : -1.0f));
+        sparse.push_back(AABB(c - glm::vec3(1.0f), c + glm::vec3(1.0f)));
+    }
+
+    bvh.build(sparse, &pool);
+    const auto& lbvhQuality = bvh.getQualityStats();
+    uint32_t    bits        = bvh.getBuildStats().mortonBits;
+    float       lbvhCost    = lbvhQuality.sahCost;
+    uint32_t    lbvhDepth   = lbvhQuality.maxDepth;
+    CHECK(bits > 30 && bits <= 63, "sparse scene should widen the codes");
+    CHECK(collectAll(bvh).size() == sparse.size(), "sparse LBVH incomplete");
+
+    BVH sah;
+    sah.build(sparse, &pool, BVHBuildMethod::SAH);
+
+    // With too coarse a grid the whole town shares a handful of cells, LBVH splits become
+    // arbitrary and small queries inside the town visit a large part of the tree
+    auto countVisits = [&](const BVH& tree) {
+        uint32_t visits = 0;
+        for (int q = 0; q < 16; ++q) {
+            glm::vec3 c(town(rng), 0.0f, town(rng));
+            AABB region(c - glm::vec3(1.0f), c + glm::vec3(1.0f));
+            tree.traverse([&](const AABB& b) { ++visits; return overlaps(region, b); }, [](uint32_t) {});
+        }
+        return visits;
+    };
+    uint32_t lbvhVisits = countVisits(bvh);
+    uint32_t sahVisits  = countVisits(sah);
+    CHECK(lbvhVisits < sahVisits * 3, "sparse LBVH queries far worse than SAH");
+
+    fmt::print("  sparse: bits={} cost={:.2f} depth={} query visits LBVH={} SAH={}\n", bits, lbvhCost, lbvhDepth,
+               lbvhVisits, sahVisits);
+}
+
+void testEdgeCases() {
+    fmt::print("\n=== Edge cases ===\n");
+
+    BVH bvh;
+    bvh.build({});
+    CHECK(collectAll(bvh).empty(), "empty build should produce no leaves");
+
+    eastl::vector<AABB> single{AABB(glm::vec3(-1.0f), glm::vec3(1.0f))};
+    bvh.build(single);
+    CHECK(collectAll(bvh).size() == 1, "single primitive build");
+
+    // Identical boxes: zero centroid extent on every axis
+    eastl::vector<AABB> same(100, AABB(glm::vec3(0.0f), glm::vec3(1.0f)));
+    bvh.build(same);
+    CHECK(collectAll(bvh).size() == 100, "degenerate build");
+    bvh.build(same, nullptr, BVHBuildMethod::SAH);
+    CHECK(collectAll(bvh).size() == 100, "degenerate SAH build");
+    bvh.build(single, nullptr, BVHBuildMethod::SAH);
+    CHECK(collectAll(bvh).size() == 1, "single primitive SAH build");
+}
+
+int main() {
+    fmt::print("BVH Test\n");
+
+    ThreadPool pool(4);
+
+    testEdgeCases();
+    testCompleteness(pool, 3, false);
+    testCompleteness(pool, 1000, false);
+    testCompleteness(pool, 100000, false);
+    testCompleteness(pool, 20000, true);
+    testDeterminism(pool);
+    testQueries(pool, BVHBuildMethod::LBVH);
+    testQueries(pool, BVHBuildMethod::SAH);
+    testSAHQuality(pool);
+    testRefit(pool, BVHBuildMethod::LBVH);
+    testRefit(pool, BVHBuildMethod::SAH);
+    testLaneKernels();
+    testWideTraversal(pool, BVHBuildMethod::LBVH);
+    testWideTraversal(pool, BVHBuildMethod::SAH);
+    testCoherentCulling(pool, BVHBuildMethod::LBVH);
+    testCoherentCulling(pool, BVHBuildMethod::SAH);
+    testCullKernels();
+    benchmarkCulling(pool);
+    testTraversalApi(pool);
+    testMortonCodes(pool);
+    testRayQueries(pool, BVHBuildMethod::LBVH);
+    testRayQueries(pool, BVHBuildMethod::SAH);
+    testTrianglePicking(pool);
+    testTwoLevel(pool);
+    testSpatialQueries(pool, BVHBuildMethod::LBVH);
+    testSpatialQueries(pool, BVHBuildMethod::SAH);
+    testOcclusion(pool);
+    testScreenSize(pool);
+    testTemporalCulling(pool, BVHBuildMethod::LBVH);
+    testTemporalCulling(pool, BVHBuildMethod::SAH);
+    testMultiViewCulling(pool, BVHBuildMethod::LBVH);
+    testMultiViewCulling(pool, BVHBuildMethod::SAH);
+    testCache(pool, BVHBuildMethod::LBVH);
+    testCache(pool, BVHBuildMethod::SAH);
+
+    if (failures > 0) {
+        fmt::print("\n{} check(s) FAILED\n", failures);
+        return 1;
+    }
+    fmt::print("\nAll BVH tests passed\n");
+    return 0;
+}
@@ -0,0 +1,201 @@
+// Shadow Atlas Test
+// Validates the quadtree shadow atlas packer: no overlaps, stable placement, merging on free, in-place growth and shrinking
+
+#include "renderer/ShadowAtlasPacker.hpp"
+#include <fmt/core.h>
+#include <cstdlib>
+#include <random>
+
+using namespace violet;
+
+// EASTL allocators
+void* operator new[](size_t size, const char*, int, unsigned, const char*, int) {
+    return malloc(size);
+}
+
+void* operator new[](size_t size, size_t alignment, size_t, const char*, int, unsigned, const char*, int) {
+    return aligned_alloc(alignment, size);
+}
+
+static int failures = 0;
+
+#define CHECK(cond, msg)                                   \
+    do {                                                   \
+        if (!(cond)) {                                     \
+            fmt::print("  FAILED: {}\n", msg);             \
+            ++failures;                                    \
+        }                                                  \
+    } while (0)
+
+struct Placed {
+    uint32_t   id;
+    glm::uvec2 offset;
+    uint32_t   size;
+};
+
+static bool overlaps(const Placed& a, const Placed& b) {
+    return a.offset.x < b.offset.x + b.size && b.offset.x < a.offset.x + a.size &&
+           a.offset.y < b.offset.y + b.size && b.offset.y < a.offset.y + a.size;
+}
+
+static bool validLayout(const ShadowAtlasPacker& packer, const eastl::vector<Placed>& placed) {
+    for (size_t i = 0; i < placed.size(); ++i) {
+        const Placed& p = placed[i];
+        if (packer.getOffset(p.id) != p.offset || packer.getSize(p.id) != p.size) {
+            return false;  // Moved
+        }
+        if (p.offset.x + p.size > packer.getAtlasSize() || p.offset.y + p.size > packer.getAtlasSize() ||
+            p.offset.x % p.size != 0 || p.offset.y % p.size != 0) {
+            return false;
+        }
+        for (size_t j = i + 1; j < placed.size(); ++j) {
+            if (overlaps(p, placed[j])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void testBasics() {
+    fmt::print("Basics\n");
+
+    ShadowAtlasPacker packer;
+    packer.init(4096, 256);
+    CHECK(packer.getAtlasSize() == 4096, "atlas size");
+    CHECK(packer.roundSize(300) == 512 && packer.roundSize(10) == 256, "sizes round up to powers of two");
+
+    // 2048 takes a quadrant, 3x1024 + 16x256 exactly fill a second one
+    eastl::vector<Placed> placed;
+    for (uint32_t size : {2048u, 1024u, 1024u, 1024u}) {
+        uint32_t id = packer.allocate(size);
+        CHECK(id != ShadowAtlasPacker::INVALID, "allocation fits");
+        placed.push_back({id, packer.getOffset(id), packer.getSize(id)});
+    }
+    for (uint32_t i = 0; i < 16; ++i) {
+        uint32_t id = packer.allocate(256);
+        CHECK(id != ShadowAtlasPacker::INVALID, "small allocation fits");
+        placed.push_back({id, packer.getOffset(id), packer.getSize(id)});
+    }
+    CHECK(validLayout(packer, placed), "no overlaps");
+
+    ShadowAtlasStats stats = packer.getStats();
+    CHECK(stats.allocations == 20, "allocation count");
+    CHECK(stats.usedTexels == 2048ull * 2048 + 3ull * 1024 * 1024 + 16ull * 256 * 256, "used texels");
+    CHECK(stats.largestFree == 2048, "best fit keeps two quadrants whole");
+    CHECK(stats.fragmentation > 0.49f && stats.fragmentation < 0.51f, "two free quadrants are half fragmented");
+
+    uint32_t id = packer.allocate(2048);
+    CHECK(id != ShadowAtlasPacker::INVALID, "room for another 2048");
+    placed.push_back({id, packer.getOffset(id), packer.getSize(id)});
+    CHECK(validLayout(packer, placed), "no overlaps");
+    CHECK(packer.getLargestFree() == 2048 && packer.getStats().fragmentation == 0.0f, "one free quadrant left");
+    CHECK(packer.allocate(4096) == ShadowAtlasPacker::INVALID, "no room for the whole atlas");
+
+    // Freeing everything merges back to one free root
+    for (const Placed& p : placed) {
+        packer.free(p.id);
+    }
+    stats = packer.getStats();
+    CHECK(stats.allocations == 0 && stats.usedTexels == 0, "all freed");
+    CHECK(stats.largestFree == 4096, "quadrants merge on free");
+    CHECK(packer.allocate(4096) != ShadowAtlasPacker::INVALID, "whole atlas allocatable after merging");
+}
+
+static void testStability() {
+    fmt::print("Stability\n");
+
+    ShadowAtlasPacker packer;
+    packer.init(8192, 256);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint32_t> sizeExp(0, 4);  // 256..4096
+    eastl::vector<Placed> placed;
+    bool valid = true;
+    uint32_t failedAllocations = 0;
+    for (uint32_t step = 0; step < 4000; ++step) {
+        // Churn: free a random allocation about half the time, otherwise allocate
+        if (!placed.empty() && (rng() & 1u)) {
+            const size_t victim = rng() % placed.size();
+            packer.free(placed[victim].id);
+            placed.erase(placed.begin() + victim);
+        } else {
+            const uint32_t id = packer.allocate(256u << sizeExp(rng));
+            if (id == ShadowAtlasPacker::INVALID) {
+                ++failedAllocations;
+                continue;
+            }
+            placed.push_back({id, packer.getOffset(id), packer.getSize(id)});
+        }
+        // Surviving allocations never move and never overlap
+        if (step % 97 == 0) {
+            valid &= validLayout(packer, placed);
+        }
+    }
+    valid &= validLayout(packer, placed);
+    CHECK(valid, "allocations stay put and disjoint under churn");
+
+    const ShadowAtlasStats stats = packer.getStats();
+    uint64_t used = 0;
+    for (const Placed& p : placed) {
+        used += static_cast<uint64_t>(p.size) * p.size;
+    }
+    CHECK(stats.usedTexels == used && stats.allocations == placed.size(), "stats match the live allocations");
+    CHECK(stats.fragmentation >= 0.0f && stats.fragmentation <= 1.0f, "fragmentation in range");
+    fmt::print("  {} live, {} failed, usage {:.0f}%, fragmentation {:.2f}\n", placed.size(), failedAllocations,
+               100.0 * static_cast<double>(stats.usedTexels) / (8192.0 * 8192.0), stats.fragmentation);
+}
+
+static void testResize() {
+    fmt::print("Resize\n");
+
+    ShadowAtlasPacker packer;
+    packer.init(2048, 256);
+    eastl::vector<Placed> placed;
+    for (uint32_t i = 0; i < 4; ++i) {
+        uint32_t id = packer.allocate(1024);
+        placed.push_back({id, packer.getOffset(id), packer.getSize(id)});
+    }
+    CHECK(packer.allocate(1024) == ShadowAtlasPacker::INVALID, "atlas full");
+    CHECK(!packer.canShrink(), "full atlas cannot shrink");
+
+    // Growing keeps every allocation in place and frees three new quadrants
+    packer.grow();
+    CHECK(packer.getAtlasSize() == 4096, "grown");
+    CHECK(validLayout(packer, placed), "growth keeps offsets");
+    CHECK(packer.getLargestFree() == 2048, "new quadrants free");
+    uint32_t id = packer.allocate(2048);
+    CHECK(id != ShadowAtlasPacker::INVALID && packer.getOffset(id) != glm::uvec2(0), "new space outside the old atlas");
+    CHECK(!packer.canShrink(), "occupied outer quadrant blocks shrinking");
+
+    packer.free(id);
+    CHECK(packer.canShrink(), "shrinkable once the outer quadrants are free");
+    CHECK(packer.shrink() && packer.getAtlasSize() == 2048, "shrunk");
+    CHECK(validLayout(packer, placed), "shrinking keeps offsets");
+
+    // Growing an empty atlas merges into a single free root
+    for (const Placed& p : placed) {
+        packer.free(p.id);
+    }
+    packer.grow();
+    CHECK(packer.getLargestFree() == 4096, "empty grown atlas is one free square");
+    CHECK(packer.shrink() && packer.shrink() && packer.getAtlasSize() == 1024, "empty atlas shrinks freely");
+    packer.shrink();
+    packer.shrink();
+    CHECK(packer.getAtlasSize() == 256 && !packer.shrink(), "never below the minimum size");
+}
+
+int main() {
+    fmt::print("Shadow Atlas Test\n");
+
+    testBasics();
+    testStability();
+    testResize();
+
+    if (failures > 0) {
+        fmt::print("{} check(s) failed\n", failures);
+        return 1;
+    }
+    fmt::print("All shadow atlas tests passed\n");
+    return 0;
+}
@@ -0,0 +1,319 @@
+// Transform Hierarchy Test
+// Validates the flat transform hierarchy: the parallel level-by-level and leaf paths against the serial path bit for bit,
+// dirty-subtree updates against a recursive reference, and that a static hierarchy updates nothing
+
+#include "scene/TransformHierarchy.hpp"
+#include "core/ThreadPool.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <fmt/core.h>
+#include <EASTL/sort.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+using namespace violet;
+
+// EASTL allocators
+void* operator new[](size_t size, const char*, int, unsigned, const char*, int) {
+    return malloc(size);
+}
+
+void* operator new[](size_t size, size_t alignment, size_t, const char*, int, unsigned, const char*, int) {
+    return aligned_alloc(alignment, size);
+}
+
+static int failures = 0;
+
+#define CHECK(cond, msg)                                   \
+    do {                                                   \
+        if (!(cond)) {                                     \
+            fmt::print("  FAILED: {}\n", msg);             \
+            ++failures;                                    \
+        }                                                  \
+    } while (0)
+
+struct LocalTransform {
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+};
+
+// Breadth-first parent list: roots first, then each node's children in a row
+static eastl::vector<uint32_t> makeTree(uint32_t count, uint32_t roots, uint32_t maxChildren, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> childCount(0, maxChildren);
+
+    eastl::vector<uint32_t> parents;
+    parents.reserve(count);
+    for (uint32_t i = 0; i < roots && i < count; ++i) {
+        parents.push_back(TransformHierarchy::NO_PARENT);
+    }
+    for (uint32_t parent = 0; parent < parents.size() && parents.size() < count; ++parent) {
+        const uint32_t children = childCount(rng);
+        for (uint32_t c = 0; c < children && parents.size() < count; ++c) {
+            parents.push_back(parent);
+        }
+    }
+    return parents;
+}
+
+static LocalTransform randomLocal(std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+    const float s = scale(rng);
+    return {glm::vec3(pos(rng), pos(rng), pos(rng)), glm::quat(glm::vec3(angle(rng), angle(rng), angle(rng))),
+            glm::vec3(s)};
+}
+
+static void build(TransformHierarchy& hierarchy, const eastl::vector<uint32_t>& parents,
+                  const eastl::vector<LocalTransform>& locals) {
+    hierarchy.clear();
+    hierarchy.reserve(static_cast<uint32_t>(parents.size()));
+    for (uint32_t i = 0; i < parents.size(); ++i) {
+        const uint32_t index = hierarchy.add(parents[i]);
+        hierarchy.setLocal(index, locals[i].position, locals[i].rotation, locals[i].scale);
+    }
+}
+
+static bool identical(const TransformHierarchy& a, const TransformHierarchy& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a.size(); ++i) {
+        if (std::memcmp(&a.getWorldMatrix(i), &b.getWorldMatrix(i), sizeof(glm::mat4)) != 0 ||
+            std::memcmp(&a.getWorldRotation(i), &b.getWorldRotation(i), sizeof(glm::quat)) != 0 ||
+            std::memcmp(&a.getWorldScale(i), &b.getWorldScale(i), sizeof(glm::vec3)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static eastl::vector<uint32_t> sortedUpdates(const TransformHierarchy& hierarchy) {
+    eastl::vector<uint32_t> nodes = hierarchy.getUpdatedNodes();
+    eastl::sort(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+// Straightforward T * R * S down the parent chain
+static bool matchesReference(const TransformHierarchy& hierarchy, const eastl::vector<uint32_t>& parents,
+                             const eastl::vector<LocalTransform>& locals) {
+    eastl::vector<glm::mat4> world(parents.size());
+    for (uint32_t i = 0; i < parents.size(); ++i) {
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), locals[i].position) * glm::mat4_cast(locals[i].rotation) *
+                          glm::scale(glm::mat4(1.0f), locals[i].scale);
+        world[i] = parents[i] == TransformHierarchy::NO_PARENT ? local : world[parents[i]] * local;
+    }
+    for (uint32_t i = 0; i < parents.size(); ++i) {
+        const glm::mat4& m = hierarchy.getWorldMatrix(i);
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                const float tolerance = 1e-3f * (1.0f + std::abs(world[i][c][r]));
+                if (std::abs(m[c][r] - world[i][c][r]) > tolerance) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static void testFullUpdate(ThreadPool& pool) {
+    fmt::print("Full update\n");
+
+    const auto parents = makeTree(200000, 64, 4, 1);
+    std::mt19937 rng(2);
+    eastl::vector<LocalTransform> locals;
+    for (uint32_t i = 0; i < parents.size(); ++i) {
+        locals.push_back(randomLocal(rng));
+    }
+
+    TransformHierarchy serial, parallel;
+    build(serial, parents, locals);
+    build(parallel, parents, locals);
+    serial.update();
+    parallel.update(&pool);
+
+    CHECK(parallel.getLevelCount() > 2, "tree has several levels");
+    CHECK(identical(serial, parallel), "parallel levels match the serial path bit for bit");
+    CHECK(serial.getUpdatedNodes().size() == parents.size(), "every new node updates");
+    CHECK(sortedUpdates(serial) == sortedUpdates(parallel), "same nodes updated");
+    CHECK(matchesReference(serial, parents, locals), "world matrices match the recursive reference");
+
+    // Nothing dirty: nothing to do
+    serial.update();
+    parallel.update(&pool);
+    CHECK(serial.getUpdatedNodes().empty() && parallel.getUpdatedNodes().empty(), "static hierarchy updates nothing");
+}
+
+static void testDirtySubtrees(ThreadPool& pool) {
+    fmt::print("Dirty subtrees\n");
+
+    const auto parents = makeTree(100000, 16, 3, 3);
+    std::mt19937 rng(4);
+    eastl::vector<LocalTransform> locals;
+    for (uint32_t i = 0; i < parents.size(); ++i) {
+        locals.push_back(randomLocal(rng));
+    }
+
+    TransformHierarchy serial, parallel;
+    build(serial, parents, locals);
+    build(parallel, parents, locals);
+    serial.update();
+    parallel.update(&pool);
+
+    // Few dirty nodes stay on the serial subtree walk, many go parallel; both must agree
+    for (uint32_t dirtyCount : {5u, 40u, 5000u}) {
+        std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(parents.size()) - 1);
+        eastl::vector<uint8_t> expected(parents.size(), 0);
+        for (uint32_t d = 0; d < dirtyCount; ++d) {
+            const uint32_t node = pick(rng);
+            locals[node] = randomLocal(rng);
+            serial.setLocal(node, locals[node].position, locals[node].rotation, locals[node].scale);
+            parallel.setLocal(node, locals[node].position, locals[node].rotation, locals[node].scale);
+            expected[node] = 1;
+        }
+        // The dirty nodes and everything below them
+        for (uint32_t i = 0; i < parents.size(); ++i) {
+            if (parents[i] != TransformHierarchy::NO_PARENT && expected[parents[i]]) {
+                expected[i] = 1;
+            }
+        }
+        eastl::vector<uint32_t> expectedNodes;
+        for (uint32_t i = 0; i < parents.size(); ++i) {
+            if (expected[i]) {
+                expectedNodes.push_back(i);
+            }
+        }
+
+        serial.update();
+        parallel.update(&pool);
+        CHECK(sortedUpdates(serial) == expectedNodes, "serial updates exactly the dirty subtrees");
+        CHECK(sortedUpdates(parallel) == expectedNodes, "parallel updates exactly the dirty subtrees");
+        CHECK(serial.getUpdatedNodes().size() == expectedNodes.size(), "each node updated once");
+        CHECK(identical(serial, parallel), "incremental results match bit for bit");
+        CHECK(matchesReference(serial, parents, locals), "incremental results match the reference");
+    }
+}
+
+static void testWideShallow(ThreadPool& pool) {
+    fmt::print("Wide shallow\n");
+
+    // One root over 100k leaves, like foliage instances under a group
+    eastl::vector<uint32_t> parents(100001, 0);
+    parents[0] = TransformHierarchy::NO_PARENT;
+    std::mt19937 rng(5);
+    eastl::vector<LocalTransform> locals;
+    for (uint32_t i = 0; i < parents.size(); ++i) {
+        locals.push_back(randomLocal(rng));
+    }
+
+    TransformHierarchy serial, parallel;
+    build(serial, parents, locals);
+    build(parallel, parents, locals);
+    serial.update();
+    parallel.update(&pool);
+    CHECK(identical(serial, parallel), "full update matches");
+
+    // Every other leaf moves: the leaf fast path
+    for (uint32_t i = 1; i < parents.size(); i += 2) {
+        locals[i] = randomLocal(rng);
+        serial.setLocal(i, locals[i].position, locals[i].rotation, locals[i].scale);
+        parallel.setLocal(i, locals[i].position, locals[i].rotation, locals[i].scale);
+    }
+    serial.update();
+    parallel.update(&pool);
+    CHECK(identical(serial, parallel), "leaf fast path matches the serial path bit for bit");
+    CHECK(sortedUpdates(serial) == sortedUpdates(parallel), "same leaves updated");
+    CHECK(parallel.getUpdatedNodes().size() == parents.size() / 2, "only the moved leaves update");
+
+    // Moving the root moves everything
+    locals[0] = randomLocal(rng);
+    serial.setLocal(0, locals[0].position, locals[0].rotation, locals[0].scale);
+    parallel.setLocal(0, locals[0].position, locals[0].rotation, locals[0].scale);
+    serial.update();
+    parallel.update(&pool);
+    CHECK(identical(serial, parallel), "root move matches");
+    CHECK(parallel.getUpdatedNodes().size() == parents.size(), "root move updates every node");
+    CHECK(matchesReference(parallel, parents, locals), "wide results match the reference");
+}
+
+static void testDeepChain(ThreadPool& pool) {
+    fmt::print("Deep chain\n");
+
+    // 64 chains of 500 nodes: many narrow levels
+    eastl::vector<uint32_t> parents;
+    const uint32_t chains = 64, length = 500;
+    for (uint32_t c = 0; c < chains; ++c) {
+        parents.push_back(TransformHierarchy::NO_PARENT);
+    }
+    for (uint32_t level = 1; level < length; ++level) {
+        for (uint32_t c = 0; c < chains; ++c) {
+            parents.push_back((level - 1) * chains + c);
+        }
+    }
+    std::mt19937 rng(6);
+    eastl::vector<LocalTransform> locals;
+    for (uint32_t i = 0; i < parents.size(); ++i) {
+        LocalTransform local = randomLocal(rng);
+        local.scale = glm::vec3(1.0f);  // Keep 500 levels of products finite
+        local.position *= 0.01f;
+        locals.push_back(local);
+    }
+
+    TransformHierarchy serial, parallel;
+    build(serial, parents, locals);
+    build(parallel, parents, locals);
+    serial.update();
+    parallel.update(&pool);
+    CHECK(parallel.getLevelCount() == length, "one level per chain link");
+    CHECK(identical(serial, parallel), "deep chains match bit for bit");
+}
+
+static void benchmark(ThreadPool& pool) {
+    fmt::print("Benchmark\n");
+
+    const auto parents = makeTree(1000000, 1000, 4, 7);
+    std::mt19937 rng(8);
+    eastl::vector<LocalTransform> locals;
+    for (uint32_t i = 0; i < parents.size(); ++i) {
+        locals.push_back(randomLocal(rng));
+    }
+
+    TransformHierarchy serial, parallel;
+    build(serial, parents, locals);
+    build(parallel, parents, locals);
+
+    auto time = [](auto&& func) {
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    };
+    const double serialMs   = time([&] { serial.update(); });
+    const double parallelMs = time([&] { parallel.update(&pool); });
+    CHECK(identical(serial, parallel), "1M node update matches");
+    fmt::print("  1M nodes, {} levels: serial {:.2f}ms, parallel {:.2f}ms ({} threads)\n", parallel.getLevelCount(),
+               serialMs, parallelMs, pool.getThreadCount());
+}
+
+int main() {
+    fmt::print("Transform Hierarchy Test\n");
+
+    ThreadPool pool(4);
+
+    testFullUpdate(pool);
+    testDirtySubtrees(pool);
+    testWideShallow(pool);
+    testDeepChain(pool);
+    benchmark(pool);
+
+    if (failures > 0) {
+        fmt::print("{} check(s) failed\n", failures);
+        return 1;
+    }
+    fmt::print("All transform hierarchy tests passed\n");
+    return 0;
+}